@@ -84,13 +84,15 @@ void
 DeleteHandle::processSingleDeleteCommand(const Interest& interest, const RepoCommandParameter& parameter,
                                          const ndn::mgmt::CommandContinuation& done) const
 {
-  int64_t nDeletedData = storageHandle.deleteData(parameter.getName());
-  if (nDeletedData == -1) {
-    NDN_LOG_DEBUG("Deletion Failed");
-    done(negativeReply(interest, 405, "Deletion Failed"));
-  }
-  else
-  done(positiveReply(interest, parameter, 200, nDeletedData));
+  storageHandle.deleteData(parameter.getName(),
+    [this, interest, parameter, done] (ssize_t nDeletedData) {
+      if (nDeletedData == -1) {
+        NDN_LOG_DEBUG("Deletion Failed");
+        done(negativeReply(interest, 405, "Deletion Failed"));
+        return;
+      }
+      done(positiveReply(interest, parameter, 200, nDeletedData));
+    });
 }
 
 void
@@ -100,18 +102,22 @@ DeleteHandle::processSegmentDeleteCommand(const Interest& interest, const RepoCo
   SegmentNo startBlockId = parameter.hasStartBlockId() ? parameter.getStartBlockId() : 0;
   SegmentNo endBlockId = parameter.getEndBlockId();
 
+  // Segment numbers are encoded in increasing order, so all data under the requested
+  // segments of the prefix form a single range of names
   Name prefix = parameter.getName();
-  uint64_t nDeletedData = 0;
-  for (SegmentNo i = startBlockId; i <= endBlockId; i++) {
-    Name name = prefix;
-    name.appendSegment(i);
-    if (storageHandle.deleteData(name)) {
-      nDeletedData++;
-    }
-  }
-
-  // All the data deleted, return 200
-  done(positiveReply(interest, parameter, 200, nDeletedData));
+  Name begin = Name(prefix).appendSegment(startBlockId);
+  Name end = Name(prefix).appendSegment(endBlockId).getSuccessor();
+  storageHandle.deleteRange(begin, end,
+    [this, interest, parameter, done] (ssize_t nDeletedData) {
+      if (nDeletedData == -1) {
+        NDN_LOG_DEBUG("Deletion Failed");
+        done(negativeReply(interest, 405, "Deletion Failed"));
+        return;
+      }
+
+      // All the data deleted, return 200
+      done(positiveReply(interest, parameter, 200, nDeletedData));
+    });
 }
 
 } // namespace repo
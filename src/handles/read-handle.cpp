@@ -43,10 +43,18 @@ ReadHandle::connectAutoListen()
       [this] (const Name& prefix) {
         onDataInserted(prefix);
       });
+    afterDataBatchInsertionConnection = m_storageHandle.afterDataBatchInsertion.connect(
+      [this] (const std::vector<Name>& names) {
+        onDataBatchInserted(names);
+      });
     afterDataDeletionConnection = m_storageHandle.afterDataDeletion.connect(
       [this] (const Name& prefix) {
         onDataDeleted(prefix);
       });
+    afterPrefixCountChangeConnection = m_storageHandle.afterPrefixCountChange.connect(
+      [this] (const Name& prefix, int64_t delta) {
+        onPrefixCountChanged(prefix, delta);
+      });
   }
 }
 
@@ -54,14 +62,16 @@ void
 ReadHandle::onInterest(const Name& prefix, const Interest& interest)
 {
   NDN_LOG_DEBUG("Received Interest " << interest.getName());
-  std::shared_ptr<ndn::Data> data = m_storageHandle.readData(interest);
-  if (data != nullptr) {
-    NDN_LOG_DEBUG("Put Data: " << *data);
-    m_face.put(*data);
-  }
-  else {
-    NDN_LOG_DEBUG("No data for " << interest.getName());
-  }
+  // the result may arrive later, if the lookup is done on a storage worker thread
+  m_storageHandle.readData(interest, [this, name = interest.getName()] (std::shared_ptr<Data> data) {
+    if (data != nullptr) {
+      NDN_LOG_DEBUG("Put Data: " << *data);
+      m_face.put(*data);
+    }
+    else {
+      NDN_LOG_DEBUG("No data for " << name);
+    }
+  });
 }
 
 void
@@ -87,9 +97,9 @@ ReadHandle::onDataDeleted(const Name& name)
   // which is what we get from the underlying storage when deleting.
   Name prefix = name.getPrefix(-(m_prefixSubsetLength + 1));
   auto check = m_insertedDataPrefixes.find(prefix);
-  if (check != m_insertedDataPrefixes.end()) {
-    if (--(check->second.useCount) <= 0) {
-      check->second.hdl.unregister();
+  if (check != nullptr) {
+    if (--(check->useCount) <= 0) {
+      check->hdl.unregister();
       m_insertedDataPrefixes.erase(prefix);
     }
   }
@@ -101,31 +111,68 @@ ReadHandle::onDataInserted(const Name& name)
   // Note: We want to save the prefix that we register exactly, not the
   // name that provoked the registration
   Name prefixToRegister = name.getPrefix(-m_prefixSubsetLength);
-  ndn::InterestFilter filter(prefixToRegister);
   auto check = m_insertedDataPrefixes.find(prefixToRegister);
-  if (check == m_insertedDataPrefixes.end()) {
-    // Because of stack lifetime problems, we assume here that the
-    // prefix registration will be successful, and we add the registered
-    // prefix to our list. This is because, if we fail, we shut
-    // everything down, anyway. If registration failures are ever
-    // considered to be recoverable, we would need to make this
-    // atomic.
-    auto hdl = m_face.setInterestFilter(filter,
-      [this] (const ndn::InterestFilter& filter, const Interest& interest) {
-        // Implicit conversion to Name of filter
-        onInterest(filter, interest);
-      },
-      [] (const Name&) {},
-      [this] (const Name& prefix, const std::string& reason) {
-        onRegisterFailed(prefix, reason);
-      });
-    RegisteredDataPrefix registeredPrefix{hdl, 1};
+  if (check == nullptr) {
+    RegisteredDataPrefix registeredPrefix{registerDataPrefix(prefixToRegister), 1};
     // Newly registered prefix
-    m_insertedDataPrefixes.emplace(std::make_pair(prefixToRegister, registeredPrefix));
+    m_insertedDataPrefixes.insert(prefixToRegister, registeredPrefix);
   }
   else {
-    check->second.useCount++;
+    check->useCount++;
+  }
+}
+
+void
+ReadHandle::onDataBatchInserted(const std::vector<Name>& names)
+{
+  // data of a batch mostly share registration prefixes, each is looked up once
+  std::map<Name, int64_t> counts;
+  for (const auto& name : names) {
+    ++counts[name.getPrefix(-m_prefixSubsetLength)];
+  }
+  for (const auto& [prefix, count] : counts) {
+    onPrefixCountChanged(prefix, count);
   }
 }
 
+void
+ReadHandle::onPrefixCountChanged(const Name& prefix, int64_t delta)
+{
+  auto check = m_insertedDataPrefixes.find(prefix);
+  if (check == nullptr) {
+    if (delta > 0) {
+      RegisteredDataPrefix registeredPrefix{registerDataPrefix(prefix), static_cast<int>(delta)};
+      m_insertedDataPrefixes.insert(prefix, registeredPrefix);
+    }
+    return;
+  }
+
+  check->useCount += delta;
+  if (check->useCount <= 0) {
+    check->hdl.unregister();
+    m_insertedDataPrefixes.erase(prefix);
+  }
+}
+
+ndn::RegisteredPrefixHandle
+ReadHandle::registerDataPrefix(const Name& prefix)
+{
+  // Because of stack lifetime problems, we assume here that the
+  // prefix registration will be successful, and we add the registered
+  // prefix to our list. This is because, if we fail, we shut
+  // everything down, anyway. If registration failures are ever
+  // considered to be recoverable, we would need to make this
+  // atomic.
+  ndn::InterestFilter filter(prefix);
+  return m_face.setInterestFilter(filter,
+    [this] (const ndn::InterestFilter& filter, const Interest& interest) {
+      // Implicit conversion to Name of filter
+      onInterest(filter, interest);
+    },
+    [] (const Name&) {},
+    [this] (const Name& prefix, const std::string& reason) {
+      onRegisterFailed(prefix, reason);
+    });
+}
+
 } // namespace repo
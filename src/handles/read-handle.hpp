@@ -21,6 +21,7 @@
 #define REPO_HANDLES_READ_HANDLE_HPP
 
 #include "common.hpp"
+#include "storage/name-trie.hpp"
 #include "storage/repo-storage.hpp"
 
 namespace repo {
@@ -43,7 +44,7 @@ public:
   listen(const Name& prefix);
 
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
-  const std::map<ndn::Name, RegisteredDataPrefix>&
+  const NameTrie<RegisteredDataPrefix>&
   getRegisteredPrefixes()
   {
     return m_insertedDataPrefixes;
@@ -58,6 +59,21 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   void
   onDataInserted(const Name& name);
 
+  /**
+   * @param names Names of the Data inserted by one batch, without implicit digest
+   */
+  void
+  onDataBatchInserted(const std::vector<Name>& names);
+
+  /**
+   * @brief Adjust the use count of registration prefix @p prefix by @p delta
+   *
+   * Registers the prefix when its use count becomes positive, and unregisters it
+   * when the count drops to zero.
+   */
+  void
+  onPrefixCountChanged(const Name& prefix, int64_t delta);
+
   void
   connectAutoListen();
 
@@ -71,11 +87,21 @@ private:
   void
   onRegisterFailed(const Name& prefix, const std::string& reason);
 
+  ndn::RegisteredPrefixHandle
+  registerDataPrefix(const Name& prefix);
+
 private:
   size_t m_prefixSubsetLength;
-  std::map<ndn::Name, RegisteredDataPrefix> m_insertedDataPrefixes;
+  /**
+   * Registered prefixes, with the number of stored Data under each. Unlike the name index of
+   * the storage, which maps every stored name to its row and may be disabled, it holds one
+   * entry per registration prefix, whatever the storage backend.
+   */
+  NameTrie<RegisteredDataPrefix> m_insertedDataPrefixes;
   ndn::signal::ScopedConnection afterDataDeletionConnection;
   ndn::signal::ScopedConnection afterDataInsertionConnection;
+  ndn::signal::ScopedConnection afterDataBatchInsertionConnection;
+  ndn::signal::ScopedConnection afterPrefixCountChangeConnection;
   Face& m_face;
   RepoStorage& m_storageHandle;
 };
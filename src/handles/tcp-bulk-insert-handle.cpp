@@ -137,6 +137,8 @@ TcpBulkInsertClient::handleReceive(const boost::system::error_code& error,
   auto bufferView = ndn::make_span(m_inputBuffer, m_inputBufferSize);
   std::size_t offset = 0;
   bool isOk = true;
+  // all Data received at once are inserted as one batch
+  std::vector<Data> batch;
   while (offset < bufferView.size()) {
     Block element;
     std::tie(isOk, element) = Block::fromBuffer(bufferView.subspan(offset));
@@ -148,12 +150,7 @@ TcpBulkInsertClient::handleReceive(const boost::system::error_code& error,
 
     if (element.type() == ndn::tlv::Data) {
       try {
-        Data data(element);
-        bool isInserted = m_writer.getStorageHandle().insertData(data);
-        if (isInserted)
-          NDN_LOG_DEBUG("Successfully injected " << data.getName());
-        else
-          NDN_LOG_DEBUG("FAILED to inject " << data.getName());
+        batch.emplace_back(element);
       }
       catch (const std::runtime_error& e) {
         /// \todo Catch specific error after determining what wireDecode() can throw
@@ -162,6 +159,15 @@ TcpBulkInsertClient::handleReceive(const boost::system::error_code& error,
     }
   }
 
+  if (!batch.empty()) {
+    m_writer.getStorageHandle().insertData(batch, [nData = batch.size()] (bool isInserted) {
+      if (isInserted)
+        NDN_LOG_DEBUG("Successfully injected " << nData << " Data");
+      else
+        NDN_LOG_DEBUG("FAILED to inject " << nData << " Data");
+    });
+  }
+
   if (!isOk && m_inputBufferSize == ndn::MAX_NDN_PACKET_SIZE && offset == 0) {
     boost::system::error_code ec;
     m_socket.shutdown(ip::tcp::socket::shutdown_both, ec);
@@ -29,6 +29,8 @@ NDN_LOG_INIT(repo.WriteHandle);
 const int DEFAULT_CREDIT = 12;
 const time::milliseconds NOEND_TIMEOUT = 10_s;
 const time::milliseconds PROCESS_DELETE_TIME = 10_s;
+const size_t SEGMENT_BATCH_SIZE = 64;
+const time::milliseconds SEGMENT_BATCH_DELAY = 100_ms;
 
 WriteHandle::WriteHandle(Face& face, RepoStorage& storageHandle, ndn::mgmt::Dispatcher& dispatcher,
                          Scheduler& scheduler, ndn::security::Validator& validator)
@@ -86,11 +88,24 @@ WriteHandle::onDataValidated(const Interest&, const Data& data, ProcessId proces
   }
 
   ProcessInfo& process = m_processes[processId];
-  RepoCommandResponse& response = process.response;
 
-  if (response.getInsertNum() == 0) {
-    storageHandle.insertData(data);
-    response.setInsertNum(1);
+  // InsertNum is set once the data is stored
+  if (process.nFetched == 0) {
+    process.nFetched = 1;
+    storageHandle.insertData(data, [this, processId] (bool isStored) {
+      auto it = m_processes.find(processId);
+      if (it == m_processes.end()) {
+        return;
+      }
+      RepoCommandResponse& response = it->second.response;
+      if (isStored) {
+        response.setInsertNum(1);
+      }
+      else {
+        // StatusCode 500 means the storage failed to insert the data
+        response.setCode(500);
+      }
+    });
   }
 
   deferredDeleteProcess(processId);
@@ -172,14 +187,29 @@ WriteHandle::onSegmentData(ndn::SegmentFetcher& fetcher, const Data& data, Proce
     return;
   }
 
-  RepoCommandResponse& response = it->second.response;
+  ProcessInfo& process = it->second;
+  RepoCommandResponse& response = process.response;
+  if (response.getCode() == 500) {
+    // a batch failed to be stored, so the process has failed
+    fetcher.stop();
+    return;
+  }
 
-  //insert data
-  if (storageHandle.insertData(data)) {
-    response.setInsertNum(response.getInsertNum() + 1);
+  //insert data in batches; InsertNum is increased when a batch is stored
+  ++process.nFetched;
+  process.pendingSegments.push_back(data);
+  if (process.pendingSegments.size() >= SEGMENT_BATCH_SIZE) {
+    insertSegments(process);
+  }
+  else if (process.pendingSegments.size() == 1) {
+    process.segmentInsertEvent = scheduler.schedule(SEGMENT_BATCH_DELAY, [this, processId] {
+      auto it = m_processes.find(processId);
+      if (it != m_processes.end()) {
+        insertSegments(it->second);
+      }
+    });
   }
 
-  ProcessInfo& process = m_processes[processId];
   //read whether notime timeout
   if (!response.hasEndBlockId()) {
     auto noEndTime = process.noEndTime;
@@ -189,6 +219,7 @@ WriteHandle::onSegmentData(ndn::SegmentFetcher& fetcher, const Data& data, Proce
       NDN_LOG_DEBUG("noEndtimeout: " << processId);
       //StatusCode should be refreshed as 405
       response.setCode(405);
+      insertSegments(process);
       //schedule a delete event
       deferredDeleteProcess(processId);
       fetcher.stop();
@@ -199,16 +230,59 @@ WriteHandle::onSegmentData(ndn::SegmentFetcher& fetcher, const Data& data, Proce
   //read whether this process has total ends, if ends, remove control info from the maps
   if (response.hasEndBlockId()) {
     uint64_t nSegments = response.getEndBlockId() - response.getStartBlockId() + 1;
-    if (response.getInsertNum() >= nSegments) {
-      //All the data has been inserted, StatusCode is refreshed as 200
-      response.setCode(200);
-      deferredDeleteProcess(processId);
+    if (process.nFetched >= nSegments) {
+      //All the data has been fetched; StatusCode is refreshed as 200 once it is stored
+      insertSegments(process);
       fetcher.stop();
       return;
     }
   }
 }
 
+void
+WriteHandle::insertSegments(ProcessInfo& process)
+{
+  process.segmentInsertEvent.cancel();
+  if (process.pendingSegments.empty()) {
+    return;
+  }
+  // the batch is copied if it is stored later, so it can be cleared right away
+  storageHandle.insertData(process.pendingSegments,
+    [this, processId = process.response.getProcessId(),
+     nSegments = process.pendingSegments.size()] (bool isStored) {
+      onSegmentsInserted(processId, nSegments, isStored);
+    });
+  process.pendingSegments.clear();
+}
+
+void
+WriteHandle::onSegmentsInserted(ProcessId processId, size_t nSegments, bool isStored)
+{
+  auto it = m_processes.find(processId);
+  if (it == m_processes.end()) {
+    return;
+  }
+
+  RepoCommandResponse& response = it->second.response;
+  if (!isStored) {
+    NDN_LOG_ERROR("Storing " << nSegments << " segments of process " << processId << " failed");
+    if (response.getCode() < 400) {
+      // StatusCode 500 means the storage failed to insert the data
+      response.setCode(500);
+      deferredDeleteProcess(processId);
+    }
+    return;
+  }
+
+  response.setInsertNum(response.getInsertNum() + nSegments);
+  if (response.getCode() == 300 && response.hasEndBlockId() &&
+      response.getInsertNum() >= response.getEndBlockId() - response.getStartBlockId() + 1) {
+    //All the data has been inserted, StatusCode is refreshed as 200
+    response.setCode(200);
+    deferredDeleteProcess(processId);
+  }
+}
+
 void
 WriteHandle::onSegmentTimeout(ndn::SegmentFetcher& fetcher, ProcessId processId)
 {
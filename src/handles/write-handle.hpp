@@ -75,6 +75,9 @@ private:
     SegmentNo nextSegment;  ///< last segment put into the nextSegmentQueue
     std::map<SegmentNo, int> retryCounts;  ///< to store retrying times of timeout segment
     int credit;  ///< congestion control credits of process
+    uint64_t nFetched = 0;  ///< number of fetched data, stored or not; InsertNum counts the stored ones
+    std::vector<Data> pendingSegments;  ///< fetched segments waiting to be inserted as a batch
+    ndn::scheduler::ScopedEventId segmentInsertEvent;  ///< inserts pendingSegments when due
 
     /**
      * @brief the latest time point at which EndBlockId must be determined
@@ -126,6 +129,19 @@ private:  // segmented data fetching
   void
   onSegmentData(ndn::SegmentFetcher& fetcher, const Data& data, ProcessId processId);
 
+  /**
+   * @brief insert the pending segments of @p process as one batch
+   */
+  void
+  insertSegments(ProcessInfo& process);
+
+  /**
+   * @brief count the @p nSegments segments of a batch in InsertNum once they are stored, or
+   *        fail the process if they could not be
+   */
+  void
+  onSegmentsInserted(ProcessId processId, size_t nSegments, bool isStored);
+
   /**
    * @brief handle when fetching segmented data timeout
    */
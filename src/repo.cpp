@@ -18,6 +18,11 @@
  */
 
 #include "repo.hpp"
+#include "storage/executor-storage.hpp"
+#include "storage/log-storage.hpp"
+#include "storage/memory-storage.hpp"
+#include "storage/sharded-storage.hpp"
+#include "storage/tiered-storage.hpp"
 #include "storage/sqlite-storage.hpp"
 
 #include <ndn-cxx/util/logger.hpp>
@@ -26,6 +31,38 @@ namespace repo {
 
 NDN_LOG_INIT(repo.Repo);
 
+static std::shared_ptr<Storage>
+createBackend(const RepoConfig& config)
+{
+  if (config.storageMethod == "log") {
+    LogStorageOptions options;
+    options.useMemoryMap = config.useMemoryMap;
+    return std::make_shared<LogStorage>(config.dbPath, options);
+  }
+  if (config.storageMethod == "memory") {
+    return std::make_shared<MemoryStorage>(config.isSnapshotEnabled ?
+                                           config.dbPath + "/ndn_repo.snapshot" : "");
+  }
+  if (config.nShards > 1) {
+    return std::make_shared<ShardedStorage>(config.dbPath, config.nShards,
+                                            config.shardPrefixLength);
+  }
+  return std::make_shared<SqliteStorage>(config.dbPath);
+}
+
+static std::shared_ptr<Storage>
+createStorage(const RepoConfig& config, boost::asio::io_context& io)
+{
+  auto storage = createBackend(config);
+  if (config.hotTierBytes > 0) {
+    storage = std::make_shared<TieredStorage>(std::move(storage), config.hotTierBytes);
+  }
+  if (config.useDedicatedThread) {
+    storage = std::make_shared<ExecutorStorage>(std::move(storage), io);
+  }
+  return storage;
+}
+
 RepoConfig
 parseConfig(const std::string& configPath)
 {
@@ -57,6 +94,13 @@ parseConfig(const std::string& configPath)
       repoConfig.dataPrefixes.push_back(Name(section.second.get_value<std::string>()));
     else if (section.first == "registration-subset")
       repoConfig.registrationSubset = section.second.get_value<int>();
+    else if (section.first == "prefix-match") {
+      auto prefixMatch = section.second.get_value<std::string>();
+      if (prefixMatch != "leftmost" && prefixMatch != "rightmost")
+        NDN_THROW(Repo::Error("Unrecognized prefix-match '" + prefixMatch + "' "
+                              "(only 'leftmost' and 'rightmost' are supported)"));
+      repoConfig.isRightmostPrefixMatch = prefixMatch == "rightmost";
+    }
     else
       NDN_THROW(Repo::Error("Unrecognized '" + section.first + "' option in 'data' section in "
                             "configuration file '"+ configPath +"'"));
@@ -93,15 +137,73 @@ parseConfig(const std::string& configPath)
     repoConfig.tcpBulkInsertEndpoints.push_back(std::make_pair(host, port));
   }
 
-  if (repoConf.get<std::string>("storage.method") != "sqlite") {
-    NDN_THROW(Repo::Error("Only 'sqlite' storage method is supported"));
+  repoConfig.storageMethod = repoConf.get<std::string>("storage.method");
+  if (repoConfig.storageMethod != "sqlite" && repoConfig.storageMethod != "log" &&
+      repoConfig.storageMethod != "memory") {
+    NDN_THROW(Repo::Error("Unrecognized storage method '" + repoConfig.storageMethod + "' "
+                          "(only 'sqlite', 'log' and 'memory' are supported)"));
   }
 
   repoConfig.dbPath = repoConf.get<std::string>("storage.path");
+  repoConfig.useMemoryMap = repoConf.get<bool>("storage.mmap", false);
+  repoConfig.isSnapshotEnabled = repoConf.get<bool>("storage.snapshot", false);
+  repoConfig.nShards = repoConf.get<size_t>("storage.shards", 1);
+  repoConfig.shardPrefixLength = repoConf.get<size_t>("storage.shard-prefix-length", 1);
+  if (repoConfig.nShards == 0 || repoConfig.shardPrefixLength == 0) {
+    NDN_THROW(Repo::Error("'storage.shards' and 'storage.shard-prefix-length' must be positive numbers"));
+  }
+  repoConfig.nReadThreads = repoConf.get<size_t>("storage.read-threads", 0);
+  repoConfig.useDedicatedThread = repoConf.get<bool>("storage.dedicated-thread", false);
+  repoConfig.hotTierBytes = repoConf.get<uint64_t>("storage.hot-tier-bytes", 0);
+  repoConfig.nameIndexMaxBytes = repoConf.get<uint64_t>("storage.name-index-max-bytes", 0);
+  repoConfig.lookupFilterCapacity = repoConf.get<uint64_t>("storage.lookup-filter-capacity", 0);
+  repoConfig.lookupFilterPrefixLength = repoConf.get<size_t>("storage.lookup-filter-prefix-length",
+                                                             repoConfig.lookupFilterPrefixLength);
+  if (repoConfig.lookupFilterPrefixLength == 0) {
+    NDN_THROW(Repo::Error("'storage.lookup-filter-prefix-length' must be a positive number"));
+  }
 
   repoConfig.validatorNode = repoConf.get_child("validator");
 
   repoConfig.nMaxPackets = repoConf.get<uint64_t>("storage.max-packets");
+  repoConfig.nMaxBytes = repoConf.get<uint64_t>("storage.max-bytes", 0);
+
+  auto evictionConf = repoConf.get_child_optional("storage.eviction");
+  if (evictionConf) {
+    for (const auto& section : *evictionConf) {
+      if (section.first == "policy") {
+        repoConfig.evictionPolicy = section.second.get_value<std::string>();
+        if (EvictionPolicy::create(repoConfig.evictionPolicy) == nullptr) {
+          NDN_THROW(Repo::Error("Unknown eviction policy '" + repoConfig.evictionPolicy + "' in "
+                                "configuration file '" + configPath + "'"));
+        }
+      }
+      else if (section.first == "priority-prefix") {
+        repoConfig.evictionPriorities.emplace_back(Name(section.second.get<std::string>("prefix")),
+                                                   section.second.get<int>("priority"));
+      }
+      else
+        NDN_THROW(Repo::Error("Unrecognized '" + section.first + "' option in 'storage.eviction' section "
+                              "in configuration file '" + configPath + "'"));
+    }
+  }
+
+  repoConfig.commitBatchSize = repoConf.get<size_t>("storage.commit-batch-size",
+                                                    repoConfig.commitBatchSize);
+  repoConfig.commitInterval = time::milliseconds(repoConf.get<uint64_t>("storage.commit-interval",
+                                                                        repoConfig.commitInterval.count()));
+  if (repoConfig.commitBatchSize == 0) {
+    NDN_THROW(Repo::Error("'storage.commit-batch-size' must be a positive number"));
+  }
+
+  auto startupScan = repoConf.get<std::string>("storage.startup-scan", "blocking");
+  if (startupScan == "incremental") {
+    repoConfig.isIncrementalStartup = true;
+  }
+  else if (startupScan != "blocking") {
+    NDN_THROW(Repo::Error("Unknown startup scan mode '" + startupScan + "' in "
+                          "configuration file '" + configPath + "'"));
+  }
 
   return repoConfig;
 }
@@ -111,7 +213,7 @@ Repo::Repo(boost::asio::io_context& io, const RepoConfig& config)
   , m_scheduler(io)
   , m_face(io)
   , m_dispatcher(m_face, m_keyChain)
-  , m_store(std::make_shared<SqliteStorage>(config.dbPath))
+  , m_store(createStorage(config, io))
   , m_storageHandle(*m_store)
   , m_validator(m_face)
   , m_readHandle(m_face, m_storageHandle, m_config.registrationSubset)
@@ -120,7 +222,78 @@ Repo::Repo(boost::asio::io_context& io, const RepoConfig& config)
   , m_tcpBulkInsertHandle(io, m_storageHandle)
 {
   this->enableValidation();
-  m_storageHandle.notifyAboutExistingData();
+  if (m_config.nReadThreads > 0 && !m_store->enableConcurrentReads(io, m_config.nReadThreads)) {
+    NDN_LOG_WARN("Storage method '" << m_config.storageMethod << "' does not support "
+                 "'read-threads', Data are read on the main thread");
+  }
+  if (m_config.nameIndexMaxBytes > 0 && !m_store->enableNameIndex(m_config.nameIndexMaxBytes)) {
+    NDN_LOG_WARN("Storage method '" << m_config.storageMethod << "' does not support "
+                 "'name-index-max-bytes', or the index exceeds it; Data are looked up without it");
+  }
+  m_storageHandle.enableRightmostPrefixMatch(m_config.isRightmostPrefixMatch);
+  if (m_config.commitBatchSize > 1) {
+    m_storageHandle.enableGroupCommit(m_scheduler, m_config.commitBatchSize, m_config.commitInterval);
+  }
+  if (m_config.registrationSubset != RepoConfig::DISABLED_SUBSET_LENGTH) {
+    // restore registered prefixes from the persisted summary instead of scanning all data,
+    // and verify the summary in the background
+    m_storageHandle.enablePrefixSummary(m_config.registrationSubset);
+  }
+  if (m_config.isIncrementalStartup) {
+    // enumerate after the io_context starts running, while Interests are already served
+    m_storageHandle.notifyAboutExistingDataIncrementally(m_scheduler);
+  }
+  else {
+    m_storageHandle.notifyAboutExistingData();
+  }
+  m_storageHandle.startPrefixSummaryCheck(m_scheduler);
+  m_storageHandle.startMigration(m_scheduler);
+  if (m_config.lookupFilterCapacity > 0) {
+    m_storageHandle.enableLookupFilter(m_scheduler, m_config.lookupFilterCapacity,
+                                       m_config.lookupFilterPrefixLength);
+  }
+
+  m_dispatcher.addStatusDataset(ndn::PartialName("status"),
+    ndn::mgmt::makeAcceptAllAuthorization(),
+    std::bind(&Repo::handleStatusDataset, this, _1, _2, _3));
+  if (m_config.nMaxPackets > 0 || m_config.nMaxBytes > 0) {
+    m_storageHandle.enableCapacityLimits(m_scheduler, m_config.nMaxPackets, m_config.nMaxBytes,
+                                         EvictionPolicy::create(m_config.evictionPolicy,
+                                                                m_config.evictionPriorities));
+  }
+}
+
+void
+Repo::handleStatusDataset(const Name&, const Interest&, ndn::mgmt::StatusDatasetContext& context)
+{
+  RepoCommandResponse response;
+  std::string text;
+  if (m_storageHandle.isEnumeratingExistingData()) {
+    response.setCode(300);
+    text = "Enumerating existing data";
+  }
+  else if (auto progress = m_storageHandle.getMigrationProgress(); progress.version != 0) {
+    response.setCode(300);
+    text = "Migrating to schema version " + std::to_string(progress.version) + ": " +
+           std::to_string(progress.nMigrated) + " of " + std::to_string(progress.nEntries) +
+           " data migrated";
+  }
+  else {
+    response.setCode(200);
+    text = "Ready";
+  }
+  if (m_storageHandle.isLookupFilterReady()) {
+    const auto& counters = m_storageHandle.getLookupFilterCounters();
+    text += "; lookup filter: " + std::to_string(counters.nChecked) + " checked, " +
+            std::to_string(counters.nSkipped) + " skipped, " +
+            std::to_string(counters.nHits) + " hits, " +
+            std::to_string(counters.nFalsePositives) + " false positives";
+  }
+  response.setText(text);
+  response.setInsertNum(m_storageHandle.getNEnumeratedExistingData());
+
+  context.append(response.wireEncode());
+  context.end();
 }
 
 void
@@ -44,12 +44,30 @@ struct RepoConfig
   static constexpr size_t DISABLED_SUBSET_LENGTH = -1;
 
   std::string repoConfigPath;
+  std::string storageMethod = "sqlite";
   std::string dbPath;
+  bool useMemoryMap = false;
+  bool isSnapshotEnabled = false;
+  size_t nShards = 1;
+  size_t shardPrefixLength = 1;
+  size_t nReadThreads = 0;
+  bool useDedicatedThread = false;
+  uint64_t hotTierBytes = 0;
+  uint64_t nameIndexMaxBytes = 0;
+  uint64_t lookupFilterCapacity = 0;
+  size_t lookupFilterPrefixLength = 1;
   std::vector<ndn::Name> dataPrefixes;
   size_t registrationSubset = DISABLED_SUBSET_LENGTH;
+  bool isRightmostPrefixMatch = false;
   std::vector<ndn::Name> repoPrefixes;
   std::vector<std::pair<std::string, std::string>> tcpBulkInsertEndpoints;
   uint64_t nMaxPackets;
+  uint64_t nMaxBytes = 0;
+  std::string evictionPolicy = "fifo";
+  std::vector<std::pair<ndn::Name, int>> evictionPriorities;
+  size_t commitBatchSize = 1;
+  time::milliseconds commitInterval = 100_ms;
+  bool isIncrementalStartup = false;
   boost::property_tree::ptree validatorNode;
 };
 
@@ -78,6 +96,17 @@ public:
   void
   enableValidation();
 
+private:
+  /**
+   * @brief Reply to a status dataset request with the startup progress
+   *
+   * The dataset is a RepoCommandResponse, with code 300 while existing data are still being
+   * enumerated and 200 afterwards, and InsertNum set to the number of enumerated data.
+   */
+  void
+  handleStatusDataset(const Name& prefix, const Interest& interest,
+                      ndn::mgmt::StatusDatasetContext& context);
+
 private:
   RepoConfig m_config;
   Scheduler m_scheduler;
@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cursor.hpp"
+#include "name-order.hpp"
+
+#include <algorithm>
+
+namespace repo {
+
+Cursor::Cursor(Storage& storage, Options options)
+  : m_storage(storage)
+  , m_options(std::move(options))
+  , m_nextPageRange(m_options.range)
+{
+  m_options.pageSize = std::max<size_t>(m_options.pageSize, 1);
+}
+
+Cursor::Cursor(Storage& storage, Options options, const Name& resumeToken)
+  : Cursor(storage, std::move(options))
+{
+  // a token below the range does not move its beginning back
+  if (!isEncodedLess(resumeToken, m_nextPageRange.begin)) {
+    m_nextPageRange.begin = resumeToken;
+    m_nextPageRange.isBeginIncluded = false;
+  }
+  m_fullName = resumeToken;
+}
+
+Storage::Range
+Cursor::makePrefixRange(const Name& prefix)
+{
+  if (prefix.empty()) {
+    // the successor of the empty name is not above all names
+    return {};
+  }
+  return {prefix, true, prefix.getSuccessor()};
+}
+
+bool
+Cursor::next()
+{
+  if (m_options.limit > 0 && m_nEnumerated >= m_options.limit) {
+    return false;
+  }
+
+  if (m_page.empty()) {
+    if (m_isExhausted) {
+      return false;
+    }
+    readPage();
+    if (m_page.empty()) {
+      return false;
+    }
+  }
+
+  m_fullName = std::move(m_page.front().first);
+  m_data = std::move(m_page.front().second);
+  m_page.pop_front();
+  ++m_nEnumerated;
+  return true;
+}
+
+void
+Cursor::asyncReadAhead(const std::function<void()>& onReady, const Storage::ErrorCallback& onFailure)
+{
+  size_t pageSize = getPageSize();
+  if (!m_page.empty() || m_isExhausted || pageSize == 0) {
+    onReady();
+    return;
+  }
+
+  auto page = std::make_shared<Page>();
+  m_storage.asyncRun(
+    [page, range = m_nextPageRange, pageSize, withData = m_options.withData] (Storage& storage) {
+      storage.scan(range, pageSize, withData,
+        [&page] (const Name& fullName, std::shared_ptr<Data> data) {
+          page->emplace_back(fullName, std::move(data));
+        });
+    },
+    [this, page, pageSize, onReady] {
+      setPage(std::move(*page), pageSize);
+      onReady();
+    },
+    onFailure);
+}
+
+size_t
+Cursor::getPageSize() const
+{
+  if (m_options.limit > 0) {
+    return std::min(m_options.pageSize, m_options.limit - m_nEnumerated);
+  }
+  return m_options.pageSize;
+}
+
+void
+Cursor::readPage()
+{
+  size_t pageSize = getPageSize();
+  Page page;
+  m_storage.scan(m_nextPageRange, pageSize, m_options.withData,
+                 [&page] (const Name& fullName, std::shared_ptr<Data> data) {
+                   page.emplace_back(fullName, std::move(data));
+                 });
+  setPage(std::move(page), pageSize);
+}
+
+void
+Cursor::setPage(Page page, size_t pageSize)
+{
+  m_page = std::move(page);
+  m_isExhausted = m_page.size() < pageSize;
+  if (!m_page.empty()) {
+    m_nextPageRange.begin = m_page.back().first;
+    m_nextPageRange.isBeginIncluded = false;
+  }
+}
+
+} // namespace repo
@@ -0,0 +1,172 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_STORAGE_CURSOR_HPP
+#define REPO_STORAGE_CURSOR_HPP
+
+#include "storage.hpp"
+
+#include <deque>
+
+namespace repo {
+
+/**
+ * @brief Enumerates stored data in a range of full names, in the order of their TLV encoding
+ *
+ * Entries are read lazily, one page at a time, with Storage::scan(). Each page starts right
+ * after the last entry read, so no statement or lock is held between calls to next(), and
+ * the cursor can be kept across events. Modifications made meanwhile are seen by the pages
+ * read after them.
+ *
+ * An enumeration can also be resumed by another cursor, e.g., after a restart, from the
+ * token returned by getResumeToken().
+ *
+ * @code
+ * Cursor cursor(storage, {Cursor::makePrefixRange(prefix)});
+ * while (cursor.next()) {
+ *   process(cursor.getFullName());
+ * }
+ * @endcode
+ */
+class Cursor
+{
+public:
+  struct Options
+  {
+    Storage::Range range;   ///< full names to enumerate; all by default
+    size_t limit = 0;       ///< maximum number of entries to enumerate, 0 for no limit
+    bool withData = false;  ///< whether getData() returns the Data of each entry
+    size_t pageSize = 1000; ///< number of entries read from the storage at a time
+  };
+
+  Cursor(Storage& storage, Options options);
+
+  /**
+   * @brief Continue an enumeration after the entry named @p resumeToken
+   *
+   * @p options should be those of the cursor that returned the token. The limit applies to
+   * the entries enumerated by this cursor.
+   */
+  Cursor(Storage& storage, Options options, const Name& resumeToken);
+
+  /**
+   * @brief Range of the full names of all data whose names start with @p prefix
+   */
+  static Storage::Range
+  makePrefixRange(const Name& prefix);
+
+  /**
+   * @brief Advance to the next entry
+   * @return false if there are no more entries, or the limit is reached
+   * @throw Storage::Error a page cannot be read
+   */
+  bool
+  next();
+
+  /**
+   * @brief Read the next page without waiting for the storage, unless entries remain from
+   *        the page read before
+   * @param onReady called when next() can return the entries of the page, or false at the
+   *        end, without reading from the storage
+   * @param onFailure called with the reason if the page cannot be read
+   * @sa Storage::asyncRun
+   *
+   * next() must not be called before one of the callbacks is called.
+   */
+  void
+  asyncReadAhead(const std::function<void()>& onReady, const Storage::ErrorCallback& onFailure);
+
+  /**
+   * @brief Full name of the current entry
+   * @pre next() returned true
+   */
+  const Name&
+  getFullName() const
+  {
+    return m_fullName;
+  }
+
+  /**
+   * @brief Data of the current entry, or nullptr if Options::withData is false
+   * @pre next() returned true
+   */
+  const std::shared_ptr<Data>&
+  getData() const
+  {
+    return m_data;
+  }
+
+  /**
+   * @brief Token to resume the enumeration after the current entry
+   *
+   * This is the full name of the last enumerated entry; before the first entry, it is the
+   * resume token the cursor was created with, if any.
+   */
+  const Name&
+  getResumeToken() const
+  {
+    return m_fullName;
+  }
+
+  /**
+   * @brief Number of entries enumerated so far
+   */
+  size_t
+  getNEnumerated() const
+  {
+    return m_nEnumerated;
+  }
+
+private:
+  using Page = std::deque<std::pair<Name, std::shared_ptr<Data>>>;
+
+  /**
+   * @brief Number of entries to read in the next page
+   */
+  size_t
+  getPageSize() const;
+
+  /**
+   * @brief Read the next page into m_page
+   */
+  void
+  readPage();
+
+  /**
+   * @brief Use @p page, a page of @p pageSize entries or fewer at the end, as the next page
+   */
+  void
+  setPage(Page page, size_t pageSize);
+
+private:
+  Storage& m_storage;
+  Options m_options;
+  /// range of the next page, which starts after the last entry read
+  Storage::Range m_nextPageRange;
+  bool m_isExhausted = false;
+  Page m_page;
+
+  Name m_fullName;
+  std::shared_ptr<Data> m_data;
+  size_t m_nEnumerated = 0;
+};
+
+} // namespace repo
+
+#endif // REPO_STORAGE_CURSOR_HPP
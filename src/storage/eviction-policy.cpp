@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "eviction-policy.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+namespace repo {
+
+NDN_LOG_INIT(repo.EvictionPolicy);
+
+std::unique_ptr<EvictionPolicy>
+EvictionPolicy::create(const std::string& policyName,
+                       const std::vector<std::pair<Name, int>>& prefixPriorities)
+{
+  if (policyName == "fifo")
+    return std::make_unique<FifoEvictionPolicy>();
+  if (policyName == "lru")
+    return std::make_unique<LruEvictionPolicy>();
+  if (policyName == "priority")
+    return std::make_unique<PriorityEvictionPolicy>(prefixPriorities);
+  return nullptr;
+}
+
+std::vector<Name>
+EvictionPolicy::selectVictims(const std::vector<Name>& fullNames, Storage::InsertionOrderPosition next,
+                              bool isEnd, size_t nVictims)
+{
+  BOOST_ASSERT(fullNames.size() <= nVictims);
+  m_position = std::move(next);
+  auto victims = doSelectVictims(fullNames, isEnd, nVictims);
+  NDN_LOG_TRACE("Selected " << victims.size() << " victims out of " << nVictims << " requested, after examining "
+                << fullNames.size() << " Data");
+  return victims;
+}
+
+std::vector<Name>
+FifoEvictionPolicy::doSelectVictims(const std::vector<Name>& fullNames, bool isEnd, size_t)
+{
+  // data that could not be evicted are selected again in the next pass
+  if (isEnd) {
+    restart();
+  }
+  return fullNames;
+}
+
+LruEvictionPolicy::LruEvictionPolicy(size_t trackingLimit)
+  : m_trackingLimit(std::max<size_t>(trackingLimit, 1))
+{
+}
+
+void
+LruEvictionPolicy::afterRead(const Name& name)
+{
+  auto it = m_index.find(name);
+  if (it != m_index.end()) {
+    m_queue.splice(m_queue.end(), m_queue, it->second);
+    return;
+  }
+
+  if (m_queue.size() >= m_trackingLimit) {
+    m_index.erase(m_queue.front());
+    m_untracked.push_back(std::move(m_queue.front()));
+    m_queue.pop_front();
+  }
+  m_index.emplace(name, m_queue.insert(m_queue.end(), name));
+}
+
+void
+LruEvictionPolicy::afterErase(const Name& fullName)
+{
+  forget(fullName.getPrefix(-1));
+}
+
+void
+LruEvictionPolicy::forget(const Name& name)
+{
+  auto it = m_index.find(name);
+  if (it != m_index.end()) {
+    m_queue.erase(it->second);
+    m_index.erase(it);
+  }
+  // untracked names whose full name is forgotten are skipped
+  m_examinedFullNames.erase(name);
+}
+
+std::vector<Name>
+LruEvictionPolicy::doSelectVictims(const std::vector<Name>& fullNames, bool isEnd, size_t nVictims)
+{
+  // data never read since startup go first, in insertion order
+  std::vector<Name> victims;
+  for (const auto& fullName : fullNames) {
+    Name name = fullName.getPrefix(-1);
+    if (m_index.count(name) > 0) {
+      m_examinedFullNames.insert_or_assign(std::move(name), fullName);
+    }
+    else {
+      victims.push_back(fullName);
+    }
+  }
+  if (!isEnd || victims.size() >= nVictims) {
+    return victims;
+  }
+
+  // All stored data have been examined, and those not selected had been read; then the least
+  // recently read data go, starting with those no longer tracked. A selected name is forgotten
+  // right away, so that it is not selected again if its data cannot be erased.
+  while (victims.size() < nVictims && !m_untracked.empty()) {
+    Name name = std::move(m_untracked.front());
+    m_untracked.pop_front();
+    auto it = m_examinedFullNames.find(name);
+    if (it != m_examinedFullNames.end() && m_index.count(name) == 0) {
+      victims.push_back(it->second);
+      m_examinedFullNames.erase(it);
+    }
+  }
+  for (auto it = m_queue.begin(); it != m_queue.end() && victims.size() < nVictims;) {
+    // data read before they were examined are skipped until they are
+    Name name = *it++;
+    auto entry = m_examinedFullNames.find(name);
+    if (entry != m_examinedFullNames.end()) {
+      victims.push_back(entry->second);
+      forget(name);
+    }
+  }
+
+  if (victims.size() < nVictims) {
+    // examine all data again, e.g., those whose eviction failed
+    restart();
+  }
+  return victims;
+}
+
+PriorityEvictionPolicy::PriorityEvictionPolicy(const std::vector<std::pair<Name, int>>& prefixPriorities)
+{
+  for (const auto& [prefix, priority] : prefixPriorities) {
+    m_priorities[prefix] = priority;
+    m_lowestPriority = std::min(m_lowestPriority, priority);
+  }
+  m_maxVictimPriority = m_lowestPriority;
+}
+
+int
+PriorityEvictionPolicy::getPriority(const Name& name) const
+{
+  for (ssize_t length = name.size(); length >= 0; --length) {
+    auto it = m_priorities.find(name.getPrefix(length));
+    if (it != m_priorities.end()) {
+      return it->second;
+    }
+  }
+  return 0;
+}
+
+std::vector<Name>
+PriorityEvictionPolicy::doSelectVictims(const std::vector<Name>& fullNames, bool isEnd, size_t)
+{
+  std::vector<Name> victims;
+  for (const auto& fullName : fullNames) {
+    int priority = getPriority(fullName);
+    if (priority <= m_maxVictimPriority) {
+      victims.push_back(fullName);
+    }
+    else if (!m_lowestRemaining || priority < *m_lowestRemaining) {
+      m_lowestRemaining = priority;
+    }
+  }
+
+  if (isEnd) {
+    // No data of the selected priorities are left, as data inserted meanwhile come last in
+    // the insertion order. The next pass selects the lowest priority left.
+    m_maxVictimPriority = m_lowestRemaining.value_or(m_lowestPriority);
+    m_lowestRemaining.reset();
+    restart();
+  }
+  return victims;
+}
+
+} // namespace repo
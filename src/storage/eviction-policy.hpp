@@ -0,0 +1,196 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_STORAGE_EVICTION_POLICY_HPP
+#define REPO_STORAGE_EVICTION_POLICY_HPP
+
+#include "storage.hpp"
+
+#include <deque>
+#include <optional>
+#include <unordered_map>
+
+namespace repo {
+
+/**
+ * @brief Selects stored data to evict when RepoStorage exceeds its capacity limits
+ *
+ * A policy examines the stored data in insertion order, a bounded number at a time, and
+ * keeps its position between calls, so that the selection is spread over several events
+ * however many stored data it has to examine.
+ */
+class EvictionPolicy : noncopyable
+{
+public:
+  virtual
+  ~EvictionPolicy() = default;
+
+  /**
+   * @brief Create the policy named @p policyName
+   * @param prefixPriorities per-prefix priorities, used by the "priority" policy
+   * @return the policy, or nullptr if @p policyName is unknown
+   */
+  static std::unique_ptr<EvictionPolicy>
+  create(const std::string& policyName,
+         const std::vector<std::pair<Name, int>>& prefixPriorities = {});
+
+  /**
+   * @brief Called after data named @p name (without implicit digest) has been read
+   */
+  virtual void
+  afterRead(const Name& name)
+  {
+  }
+
+  /**
+   * @brief Called after data with full name @p fullName has been removed from storage
+   */
+  virtual void
+  afterErase(const Name& fullName)
+  {
+  }
+
+  /**
+   * @brief Position in the insertion order of the stored data to examine next
+   */
+  const Storage::InsertionOrderPosition&
+  getPosition() const
+  {
+    return m_position;
+  }
+
+  /**
+   * @brief Select up to @p nVictims stored data to evict
+   * @param fullNames the stored data that follow getPosition() in insertion order, at most
+   *        @p nVictims of them
+   * @param next the position after @p fullNames, at which the next call continues
+   * @param isEnd whether @p fullNames reach the end of the stored data
+   * @return full names of the selected data, among @p fullNames or the data examined before;
+   *         empty if none of them is to be evicted yet
+   */
+  std::vector<Name>
+  selectVictims(const std::vector<Name>& fullNames, Storage::InsertionOrderPosition next,
+                bool isEnd, size_t nVictims);
+
+protected:
+  /**
+   * @brief Examine the stored data again from the oldest, starting with the next call
+   */
+  void
+  restart()
+  {
+    m_position = {};
+  }
+
+private:
+  virtual std::vector<Name>
+  doSelectVictims(const std::vector<Name>& fullNames, bool isEnd, size_t nVictims) = 0;
+
+private:
+  Storage::InsertionOrderPosition m_position;
+};
+
+/**
+ * @brief Evicts the oldest inserted data first
+ */
+class FifoEvictionPolicy : public EvictionPolicy
+{
+private:
+  std::vector<Name>
+  doSelectVictims(const std::vector<Name>& fullNames, bool isEnd, size_t nVictims) override;
+};
+
+/**
+ * @brief Evicts the least recently read data first
+ *
+ * Data that has never been read since startup is considered least recently used and is
+ * evicted first, in insertion order. Read times are tracked in memory for at most
+ * @c trackingLimit names; the least recently read names beyond that are forgotten, and
+ * evicted before the tracked ones.
+ *
+ * The full names of read data are learned as the data are examined, so that the least
+ * recently read data can be evicted once all stored data have been examined.
+ */
+class LruEvictionPolicy : public EvictionPolicy
+{
+public:
+  explicit
+  LruEvictionPolicy(size_t trackingLimit = 1000000);
+
+  void
+  afterRead(const Name& name) override;
+
+  void
+  afterErase(const Name& fullName) override;
+
+private:
+  std::vector<Name>
+  doSelectVictims(const std::vector<Name>& fullNames, bool isEnd, size_t nVictims) override;
+
+  /**
+   * @brief Stop tracking the read data named @p name
+   */
+  void
+  forget(const Name& name);
+
+private:
+  size_t m_trackingLimit;
+  std::list<Name> m_queue; ///< read names, least recently read first
+  std::unordered_map<Name, std::list<Name>::iterator> m_index;
+  std::deque<Name> m_untracked; ///< read names beyond the tracking limit, least recently read first
+  /// full names of the examined data that had been read, by name
+  std::unordered_map<Name, Name> m_examinedFullNames;
+};
+
+/**
+ * @brief Evicts data with the lowest priority first, oldest first within a priority
+ *
+ * The priority of data is the priority of the longest configured prefix of its name,
+ * or 0 if none of the configured prefixes match.
+ *
+ * The stored data are examined in passes over the insertion order. In each pass, data of
+ * the lowest priority found by the previous pass, or lower, are selected as they are
+ * examined.
+ */
+class PriorityEvictionPolicy : public EvictionPolicy
+{
+public:
+  explicit
+  PriorityEvictionPolicy(const std::vector<std::pair<Name, int>>& prefixPriorities);
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  int
+  getPriority(const Name& name) const;
+
+private:
+  std::vector<Name>
+  doSelectVictims(const std::vector<Name>& fullNames, bool isEnd, size_t nVictims) override;
+
+private:
+  std::map<Name, int> m_priorities;
+  int m_lowestPriority = 0;
+  /// data with this priority or lower are selected in the current pass
+  int m_maxVictimPriority = 0;
+  /// lowest priority of the data examined in the current pass and not selected
+  std::optional<int> m_lowestRemaining;
+};
+
+} // namespace repo
+
+#endif // REPO_STORAGE_EVICTION_POLICY_HPP
@@ -0,0 +1,438 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "executor-storage.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+#include <boost/asio/post.hpp>
+
+#include <future>
+#include <type_traits>
+
+namespace repo {
+
+NDN_LOG_INIT(repo.ExecutorStorage);
+
+ExecutorStorage::ExecutorStorage(std::shared_ptr<Storage> storage, boost::asio::io_context& ioCtx)
+  : m_ioCtx(ioCtx)
+  , m_workGuard(boost::asio::make_work_guard(m_storageCtx))
+  , m_storage(std::move(storage))
+  , m_thread([this] { m_storageCtx.run(); })
+{
+  NDN_LOG_DEBUG("Running storage operations on a dedicated thread");
+}
+
+ExecutorStorage::~ExecutorStorage()
+{
+  m_workGuard.reset();
+  m_thread.join();
+}
+
+template<typename Function>
+auto
+ExecutorStorage::runAndWait(Function&& f)
+{
+  std::packaged_task<std::invoke_result_t<Function>()> task(std::forward<Function>(f));
+  auto result = task.get_future();
+  boost::asio::post(m_storageCtx, std::move(task));
+  result.wait();
+  deliverCompletions();
+  return result.get();
+}
+
+void
+ExecutorStorage::deliver(std::function<void()> completion)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_completions.push_back(std::move(completion));
+  if (!m_isDeliveryPosted) {
+    m_isDeliveryPosted = true;
+    boost::asio::post(m_ioCtx, [this, isAlive = std::weak_ptr<int>(m_aliveToken)] {
+      if (!isAlive.expired()) {
+        deliverCompletions();
+      }
+    });
+  }
+}
+
+void
+ExecutorStorage::deliverCompletions()
+{
+  // Callbacks are taken one at a time: one that calls a synchronous operation delivers
+  // the following ones itself, and the order is kept.
+  while (true) {
+    std::function<void()> completion;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_completions.empty()) {
+        m_isDeliveryPosted = false;
+        return;
+      }
+      completion = std::move(m_completions.front());
+      m_completions.pop_front();
+    }
+    completion();
+  }
+}
+
+int64_t
+ExecutorStorage::insert(const Data& data)
+{
+  return runAndWait([&] { return m_storage->insert(data); });
+}
+
+bool
+ExecutorStorage::insertIfAbsent(const Data& data)
+{
+  return runAndWait([&] { return m_storage->insertIfAbsent(data); });
+}
+
+std::vector<bool>
+ExecutorStorage::insertBatch(ndn::span<const Data> batch)
+{
+  return runAndWait([&] { return m_storage->insertBatch(batch); });
+}
+
+bool
+ExecutorStorage::erase(const Name& name)
+{
+  return runAndWait([&] { return m_storage->erase(name); });
+}
+
+uint64_t
+ExecutorStorage::eraseRange(const Name& begin, const Name& end,
+                            const std::function<void(const std::vector<Name>&)>& onChunk)
+{
+  // Chunks are erased on the storage thread, but reported after runAndWait() delivers the
+  // results of earlier operations, which could otherwise still report the erased entries.
+  std::vector<std::vector<Name>> chunks;
+  auto collectChunk = [&chunks] (const std::vector<Name>& names) { chunks.push_back(names); };
+  uint64_t nErased = 0;
+  try {
+    nErased = runAndWait([&] { return m_storage->eraseRange(begin, end, collectChunk); });
+  }
+  catch (const std::exception&) {
+    // the chunks erased before the failure stay erased
+    for (const auto& names : chunks) {
+      onChunk(names);
+    }
+    throw;
+  }
+  for (const auto& names : chunks) {
+    onChunk(names);
+  }
+  return nErased;
+}
+
+std::shared_ptr<Data>
+ExecutorStorage::read(const Name& name)
+{
+  return runAndWait([&] { return m_storage->read(name); });
+}
+
+bool
+ExecutorStorage::has(const Name& name)
+{
+  return runAndWait([&] { return m_storage->has(name); });
+}
+
+std::shared_ptr<Data>
+ExecutorStorage::find(const Name& name, bool exactMatch)
+{
+  return runAndWait([&] { return m_storage->find(name, exactMatch); });
+}
+
+void
+ExecutorStorage::asyncFind(const Name& name, bool exactMatch, const FindCallback& onResult)
+{
+  boost::asio::post(m_storageCtx, [this, name, exactMatch, onResult] {
+    auto deliverResult = [this, onResult] (std::shared_ptr<Data> data) {
+      deliver([onResult, data = std::move(data)] { onResult(data); });
+    };
+    try {
+      m_storage->asyncFind(name, exactMatch, deliverResult);
+    }
+    catch (const std::exception& e) {
+      NDN_LOG_ERROR("Lookup of " << name << " failed: " << e.what());
+      deliverResult(nullptr);
+    }
+  });
+}
+
+std::shared_ptr<Data>
+ExecutorStorage::findLast(const Name& prefix)
+{
+  return runAndWait([&] { return m_storage->findLast(prefix); });
+}
+
+void
+ExecutorStorage::asyncFindLast(const Name& prefix, const FindCallback& onResult)
+{
+  boost::asio::post(m_storageCtx, [this, prefix, onResult] {
+    auto deliverResult = [this, onResult] (std::shared_ptr<Data> data) {
+      deliver([onResult, data = std::move(data)] { onResult(data); });
+    };
+    try {
+      m_storage->asyncFindLast(prefix, deliverResult);
+    }
+    catch (const std::exception& e) {
+      NDN_LOG_ERROR("Lookup of " << prefix << " failed: " << e.what());
+      deliverResult(nullptr);
+    }
+  });
+}
+
+std::shared_ptr<Data>
+ExecutorStorage::findMatch(const Interest& interest, bool isRightmost)
+{
+  return runAndWait([&] { return m_storage->findMatch(interest, isRightmost); });
+}
+
+void
+ExecutorStorage::asyncFindMatch(const Interest& interest, bool isRightmost, const FindCallback& onResult)
+{
+  boost::asio::post(m_storageCtx, [this, interest, isRightmost, onResult] {
+    auto deliverResult = [this, onResult] (std::shared_ptr<Data> data) {
+      deliver([onResult, data = std::move(data)] { onResult(data); });
+    };
+    try {
+      m_storage->asyncFindMatch(interest, isRightmost, deliverResult);
+    }
+    catch (const std::exception& e) {
+      NDN_LOG_ERROR("Lookup of " << interest.getName() << " failed: " << e.what());
+      deliverResult(nullptr);
+    }
+  });
+}
+
+void
+ExecutorStorage::asyncInsert(const Data& data, const InsertCallback& onInserted,
+                             const ErrorCallback& onFailure)
+{
+  boost::asio::post(m_storageCtx, [this, data, onInserted, onFailure] {
+    auto deliverFailure = [this, onFailure] (const std::string& reason) {
+      deliver([onFailure, reason] { onFailure(reason); });
+    };
+    try {
+      m_storage->asyncInsert(data,
+        [this, onInserted] (bool isInserted) {
+          deliver([onInserted, isInserted] { onInserted(isInserted); });
+        },
+        deliverFailure);
+    }
+    catch (const std::exception& e) {
+      deliverFailure(e.what());
+    }
+  });
+}
+
+void
+ExecutorStorage::asyncInsertBatch(ndn::span<const Data> batch, const InsertBatchCallback& onInserted,
+                                  const ErrorCallback& onFailure)
+{
+  std::vector<Data> copy(batch.begin(), batch.end());
+  boost::asio::post(m_storageCtx, [this, batch = std::move(copy), onInserted, onFailure] {
+    auto deliverFailure = [this, onFailure] (const std::string& reason) {
+      deliver([onFailure, reason] { onFailure(reason); });
+    };
+    try {
+      m_storage->asyncInsertBatch(batch,
+        [this, onInserted] (const std::vector<bool>& isInserted) {
+          deliver([onInserted, isInserted] { onInserted(isInserted); });
+        },
+        deliverFailure);
+    }
+    catch (const std::exception& e) {
+      deliverFailure(e.what());
+    }
+  });
+}
+
+void
+ExecutorStorage::asyncEraseRange(const Name& begin, const Name& end,
+                                 const std::function<void(const std::vector<Name>&)>& onChunk,
+                                 const EraseRangeCallback& onErased, const ErrorCallback& onFailure)
+{
+  boost::asio::post(m_storageCtx, [this, begin, end, onChunk, onErased, onFailure] {
+    auto deliverFailure = [this, onFailure] (const std::string& reason) {
+      deliver([onFailure, reason] { onFailure(reason); });
+    };
+    try {
+      m_storage->asyncEraseRange(begin, end,
+        [this, onChunk] (const std::vector<Name>& names) {
+          deliver([onChunk, names] { onChunk(names); });
+        },
+        [this, onErased] (uint64_t nErased) {
+          deliver([onErased, nErased] { onErased(nErased); });
+        },
+        deliverFailure);
+    }
+    catch (const std::exception& e) {
+      deliverFailure(e.what());
+    }
+  });
+}
+
+void
+ExecutorStorage::asyncRun(const Operation& operation, const std::function<void()>& onDone,
+                          const ErrorCallback& onFailure)
+{
+  boost::asio::post(m_storageCtx, [this, operation, onDone, onFailure] {
+    auto deliverFailure = [this, onFailure] (const std::string& reason) {
+      deliver([onFailure, reason] { onFailure(reason); });
+    };
+    try {
+      m_storage->asyncRun(operation, [this, onDone] { deliver(onDone); }, deliverFailure);
+    }
+    catch (const std::exception& e) {
+      deliverFailure(e.what());
+    }
+  });
+}
+
+bool
+ExecutorStorage::enableConcurrentReads(boost::asio::io_context&, size_t nThreads)
+{
+  // the readers deliver their results to the storage thread, which forwards them in turn
+  return runAndWait([&] { return m_storage->enableConcurrentReads(m_storageCtx, nThreads); });
+}
+
+bool
+ExecutorStorage::enableNameIndex(size_t maxBytes)
+{
+  return runAndWait([&] { return m_storage->enableNameIndex(maxBytes); });
+}
+
+void
+ExecutorStorage::forEachInInsertionOrder(const std::function<bool(const Name&)>& f)
+{
+  runAndWait([&] { m_storage->forEachInInsertionOrder(f); });
+}
+
+std::vector<Name>
+ExecutorStorage::nextInInsertionOrder(InsertionOrderPosition& position, size_t limit)
+{
+  return runAndWait([&] { return m_storage->nextInInsertionOrder(position, limit); });
+}
+
+size_t
+ExecutorStorage::scan(const Range& range, size_t limit, bool withData, const ScanCallback& f)
+{
+  return runAndWait([&] { return m_storage->scan(range, limit, withData, f); });
+}
+
+uint64_t
+ExecutorStorage::size()
+{
+  return runAndWait([&] { return m_storage->size(); });
+}
+
+uint64_t
+ExecutorStorage::bytes()
+{
+  return runAndWait([&] { return m_storage->bytes(); });
+}
+
+void
+ExecutorStorage::asyncUsage(const UsageCallback& onResult, const ErrorCallback& onFailure)
+{
+  boost::asio::post(m_storageCtx, [this, onResult, onFailure] {
+    auto deliverFailure = [this, onFailure] (const std::string& reason) {
+      deliver([onFailure, reason] { onFailure(reason); });
+    };
+    try {
+      m_storage->asyncUsage(
+        [this, onResult] (uint64_t nPackets, uint64_t nBytes) {
+          deliver([onResult, nPackets, nBytes] { onResult(nPackets, nBytes); });
+        },
+        deliverFailure);
+    }
+    catch (const std::exception& e) {
+      deliverFailure(e.what());
+    }
+  });
+}
+
+bool
+ExecutorStorage::enablePrefixSummary(size_t nSuffixComponents)
+{
+  return runAndWait([&] { return m_storage->enablePrefixSummary(nSuffixComponents); });
+}
+
+void
+ExecutorStorage::forEachPrefixCount(const std::function<void(const Name& prefix, uint64_t count)>& f)
+{
+  runAndWait([&] { m_storage->forEachPrefixCount(f); });
+}
+
+bool
+ExecutorStorage::checkPrefixSummary(size_t nEntries,
+                                    const std::function<void(const Name&, int64_t)>& onCorrection)
+{
+  return runAndWait([&] { return m_storage->checkPrefixSummary(nEntries, onCorrection); });
+}
+
+bool
+ExecutorStorage::migrate(size_t nEntries)
+{
+  return runAndWait([&] { return m_storage->migrate(nEntries); });
+}
+
+Storage::MigrationProgress
+ExecutorStorage::getMigrationProgress()
+{
+  return runAndWait([&] { return m_storage->getMigrationProgress(); });
+}
+
+void
+ExecutorStorage::beginTransaction()
+{
+  runAndWait([&] { m_storage->beginTransaction(); });
+}
+
+void
+ExecutorStorage::asyncBeginTransaction(const ErrorCallback& onFailure)
+{
+  boost::asio::post(m_storageCtx, [this, onFailure] {
+    auto deliverFailure = [this, onFailure] (const std::string& reason) {
+      deliver([onFailure, reason] { onFailure(reason); });
+    };
+    try {
+      m_storage->asyncBeginTransaction(deliverFailure);
+    }
+    catch (const std::exception& e) {
+      deliverFailure(e.what());
+    }
+  });
+}
+
+void
+ExecutorStorage::commitTransaction()
+{
+  runAndWait([&] { m_storage->commitTransaction(); });
+}
+
+void
+ExecutorStorage::rollbackTransaction()
+{
+  runAndWait([&] { m_storage->rollbackTransaction(); });
+}
+
+} // namespace repo
@@ -0,0 +1,219 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_STORAGE_EXECUTOR_STORAGE_HPP
+#define REPO_STORAGE_EXECUTOR_STORAGE_HPP
+
+#include "storage.hpp"
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace repo {
+
+/**
+ * @brief Storage that runs all operations of another Storage on a dedicated thread
+ *
+ * Operations run one at a time, in the order they are called. The asynchronous operations
+ * return right away, and their callbacks are called later on the io_context of the caller.
+ * The synchronous operations wait for their result, after all operations called before
+ * them; callbacks passed to them, e.g., to scan(), run on the storage thread while the
+ * caller waits.
+ *
+ * Before a synchronous operation returns, the callbacks of all asynchronous operations
+ * called before it are called, so that the caller observes the results in call order.
+ * The only exception are lookups served by a pool of readers of the wrapped storage, see
+ * enableConcurrentReads(), whose results can arrive in any order.
+ */
+class ExecutorStorage : public Storage
+{
+public:
+  /**
+   * @param storage the storage to run operations on; it must not be used by anyone else
+   * @param ioCtx the io_context on which the callbacks of asynchronous operations are called
+   */
+  ExecutorStorage(std::shared_ptr<Storage> storage, boost::asio::io_context& ioCtx);
+
+  /**
+   * @brief Complete the pending operations, without calling their callbacks, and stop the thread
+   */
+  ~ExecutorStorage() override;
+
+  int64_t
+  insert(const Data& data) override;
+
+  bool
+  insertIfAbsent(const Data& data) override;
+
+  std::vector<bool>
+  insertBatch(ndn::span<const Data> batch) override;
+
+  bool
+  erase(const Name& name) override;
+
+  /**
+   * @brief Erase entries as the wrapped storage does, and call @p onChunk with the erased
+   *        chunks after the callbacks of the operations called before
+   */
+  uint64_t
+  eraseRange(const Name& begin, const Name& end,
+             const std::function<void(const std::vector<Name>&)>& onChunk) override;
+
+  std::shared_ptr<Data>
+  read(const Name& name) override;
+
+  bool
+  has(const Name& name) override;
+
+  std::shared_ptr<Data>
+  find(const Name& name, bool exactMatch = false) override;
+
+  void
+  asyncFind(const Name& name, bool exactMatch, const FindCallback& onResult) override;
+
+  std::shared_ptr<Data>
+  findLast(const Name& prefix) override;
+
+  void
+  asyncFindLast(const Name& prefix, const FindCallback& onResult) override;
+
+  std::shared_ptr<Data>
+  findMatch(const Interest& interest, bool isRightmost = false) override;
+
+  void
+  asyncFindMatch(const Interest& interest, bool isRightmost, const FindCallback& onResult) override;
+
+  void
+  asyncInsert(const Data& data, const InsertCallback& onInserted,
+              const ErrorCallback& onFailure) override;
+
+  void
+  asyncInsertBatch(ndn::span<const Data> batch, const InsertBatchCallback& onInserted,
+                   const ErrorCallback& onFailure) override;
+
+  void
+  asyncEraseRange(const Name& begin, const Name& end,
+                  const std::function<void(const std::vector<Name>&)>& onChunk,
+                  const EraseRangeCallback& onErased, const ErrorCallback& onFailure) override;
+
+  void
+  asyncRun(const Operation& operation, const std::function<void()>& onDone,
+           const ErrorCallback& onFailure) override;
+
+  bool
+  enableNameIndex(size_t maxBytes) override;
+
+  /**
+   * @brief Enable concurrent reads of the wrapped storage, with results delivered through
+   *        the storage thread
+   *
+   * @p ioCtx is not used: results are delivered on the io_context given to the constructor.
+   */
+  bool
+  enableConcurrentReads(boost::asio::io_context& ioCtx, size_t nThreads) override;
+
+  void
+  forEachInInsertionOrder(const std::function<bool(const Name&)>& f) override;
+
+  std::vector<Name>
+  nextInInsertionOrder(InsertionOrderPosition& position, size_t limit) override;
+
+  size_t
+  scan(const Range& range, size_t limit, bool withData, const ScanCallback& f) override;
+
+  uint64_t
+  size() override;
+
+  uint64_t
+  bytes() override;
+
+  void
+  asyncUsage(const UsageCallback& onResult, const ErrorCallback& onFailure) override;
+
+  bool
+  enablePrefixSummary(size_t nSuffixComponents) override;
+
+  void
+  forEachPrefixCount(const std::function<void(const Name& prefix, uint64_t count)>& f) override;
+
+  bool
+  checkPrefixSummary(size_t nEntries,
+                     const std::function<void(const Name&, int64_t)>& onCorrection) override;
+
+  bool
+  migrate(size_t nEntries) override;
+
+  MigrationProgress
+  getMigrationProgress() override;
+
+  void
+  beginTransaction() override;
+
+  void
+  asyncBeginTransaction(const ErrorCallback& onFailure) override;
+
+  void
+  commitTransaction() override;
+
+  void
+  rollbackTransaction() override;
+
+private:
+  /**
+   * @brief Run @p f on the storage thread, after the operations called before, and return
+   *        its result or rethrow its exception
+   */
+  template<typename Function>
+  auto
+  runAndWait(Function&& f);
+
+  /**
+   * @brief Queue a callback to be called on the io_context; may be called from any thread
+   */
+  void
+  deliver(std::function<void()> completion);
+
+  /**
+   * @brief Call the queued callbacks, on the io_context thread
+   */
+  void
+  deliverCompletions();
+
+private:
+  boost::asio::io_context& m_ioCtx;
+  std::mutex m_mutex;
+  std::deque<std::function<void()>> m_completions;
+  bool m_isDeliveryPosted = false;
+  /// whether callbacks posted to the io_context may still be called
+  std::shared_ptr<int> m_aliveToken = std::make_shared<int>();
+
+  // the thread's io_context must outlive the storage, whose reader threads may post to it
+  boost::asio::io_context m_storageCtx;
+  boost::asio::executor_work_guard<boost::asio::io_context::executor_type> m_workGuard;
+  std::shared_ptr<Storage> m_storage;
+  std::thread m_thread;
+};
+
+} // namespace repo
+
+#endif // REPO_STORAGE_EXECUTOR_STORAGE_HPP
@@ -0,0 +1,1185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "log-storage.hpp"
+#include "name-order.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/util/logger.hpp>
+
+#include <boost/crc.hpp>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace repo {
+
+NDN_LOG_INIT(repo.LogStorage);
+
+namespace {
+
+const uint32_t RECORD_MAGIC = 0x4E444E52;
+const size_t RECORD_HEADER_SIZE = 32;
+const size_t RECORD_CHECKSUM_OFFSET = 28;
+
+const uint8_t RECORD_PUT = 1;
+const uint8_t RECORD_DELETE = 2;
+
+const uint64_t CHECKPOINT_MAGIC = 0x544E494F504B4843; // "CHKPOINT"
+const uint32_t CHECKPOINT_VERSION = 1;
+const char CHECKPOINT_FILE[] = "index.checkpoint";
+
+const size_t WRITE_BUFFER_FLUSH_SIZE = 1024 * 1024;
+const size_t ITERATION_CHUNK_SIZE = 1000;
+
+template<typename T>
+void
+putValue(uint8_t* buffer, size_t offset, T value)
+{
+  std::memcpy(buffer + offset, &value, sizeof(value));
+}
+
+template<typename T>
+T
+getValue(const uint8_t* buffer, size_t offset)
+{
+  T value;
+  std::memcpy(&value, buffer + offset, sizeof(value));
+  return value;
+}
+
+[[noreturn]] void
+throwSystemError(const std::string& what)
+{
+  NDN_THROW(Storage::Error(what + ": " + std::strerror(errno)));
+}
+
+/**
+ * @brief Read exactly @p size bytes at @p offset
+ * @return false if the file ends before
+ */
+bool
+readFully(int fd, uint8_t* buffer, size_t size, uint64_t offset)
+{
+  while (size > 0) {
+    ssize_t n = ::pread(fd, buffer, size, static_cast<off_t>(offset));
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      throwSystemError("Cannot read segment file");
+    }
+    if (n == 0) {
+      return false;
+    }
+    buffer += n;
+    size -= static_cast<size_t>(n);
+    offset += static_cast<uint64_t>(n);
+  }
+  return true;
+}
+
+void
+writeFully(int fd, const uint8_t* buffer, size_t size, uint64_t offset)
+{
+  while (size > 0) {
+    ssize_t n = ::pwrite(fd, buffer, size, static_cast<off_t>(offset));
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      throwSystemError("Cannot write segment file");
+    }
+    buffer += n;
+    size -= static_cast<size_t>(n);
+    offset += static_cast<uint64_t>(n);
+  }
+}
+
+Name
+decodeName(ndn::span<const uint8_t> value)
+{
+  return Name(ndn::encoding::makeBinaryBlock(ndn::tlv::Name, value));
+}
+
+/**
+ * @brief Writes the checkpoint file and computes its checksum on the way
+ */
+class CheckpointWriter : noncopyable
+{
+public:
+  explicit
+  CheckpointWriter(const std::string& path)
+    : m_fd(::open(path.data(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644))
+  {
+    if (m_fd < 0) {
+      throwSystemError("Cannot create checkpoint file " + path);
+    }
+  }
+
+  ~CheckpointWriter()
+  {
+    if (m_fd >= 0) {
+      ::close(m_fd);
+    }
+  }
+
+  template<typename T>
+  void
+  put(T value)
+  {
+    write(reinterpret_cast<const uint8_t*>(&value), sizeof(value));
+  }
+
+  void
+  write(const uint8_t* buffer, size_t size)
+  {
+    m_crc.process_bytes(buffer, size);
+    m_buffer.insert(m_buffer.end(), buffer, buffer + size);
+    if (m_buffer.size() >= WRITE_BUFFER_FLUSH_SIZE) {
+      flush();
+    }
+  }
+
+  /**
+   * @brief Append the checksum, then write and sync the file
+   */
+  void
+  finish()
+  {
+    uint32_t checksum = m_crc.checksum();
+    m_buffer.insert(m_buffer.end(), reinterpret_cast<const uint8_t*>(&checksum),
+                    reinterpret_cast<const uint8_t*>(&checksum) + sizeof(checksum));
+    flush();
+    if (::fsync(m_fd) != 0) {
+      throwSystemError("Cannot sync checkpoint file");
+    }
+  }
+
+private:
+  void
+  flush()
+  {
+    writeFully(m_fd, m_buffer.data(), m_buffer.size(), m_offset);
+    m_offset += m_buffer.size();
+    m_buffer.clear();
+  }
+
+private:
+  int m_fd;
+  uint64_t m_offset = 0;
+  std::vector<uint8_t> m_buffer;
+  boost::crc_32_type m_crc;
+};
+
+/**
+ * @brief Reads the checkpoint file and computes its checksum on the way
+ */
+class CheckpointReader : noncopyable
+{
+public:
+  explicit
+  CheckpointReader(const std::string& path)
+    : m_is(path, std::ios::binary)
+  {
+  }
+
+  bool
+  isOpen() const
+  {
+    return m_is.is_open();
+  }
+
+  template<typename T>
+  bool
+  get(T& value)
+  {
+    return read(reinterpret_cast<uint8_t*>(&value), sizeof(value));
+  }
+
+  bool
+  read(uint8_t* buffer, size_t size)
+  {
+    if (!m_is.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(size))) {
+      return false;
+    }
+    m_crc.process_bytes(buffer, size);
+    return true;
+  }
+
+  /**
+   * @brief Read the checksum at the end of the file and compare it with the computed one
+   */
+  bool
+  verify()
+  {
+    uint32_t computed = m_crc.checksum();
+    uint32_t stored = 0;
+    return get(stored) && stored == computed;
+  }
+
+private:
+  std::ifstream m_is;
+  boost::crc_32_type m_crc;
+};
+
+} // namespace
+
+struct LogStorage::Record
+{
+  ndn::span<const uint8_t>
+  getName() const
+  {
+    return ndn::span<const uint8_t>(payload).first(nameSize);
+  }
+
+  ndn::span<const uint8_t>
+  getData() const
+  {
+    return ndn::span<const uint8_t>(payload).subspan(nameSize);
+  }
+
+  uint8_t type = 0;
+  uint64_t sequence = 0;
+  uint32_t target = 0;
+  uint32_t nameSize = 0;
+  std::vector<uint8_t> payload; ///< name followed by data
+  uint64_t size = 0; ///< size of the record in the file
+};
+
+/**
+ * @brief Read-only memory mapping of a sealed segment file
+ *
+ * Readers copy out of the mapping after releasing the lock, each holding a reference to it,
+ * so that the mapping of a segment removed by compaction stays valid until they are done.
+ */
+struct LogStorage::Mapping
+{
+  Mapping(const uint8_t* data, size_t size)
+    : data(data)
+    , size(size)
+  {
+  }
+
+  ~Mapping()
+  {
+    ::munmap(const_cast<uint8_t*>(data), size);
+  }
+
+  const uint8_t* const data;
+  const size_t size;
+};
+
+LogStorage::LogStorage(const std::string& dirPath)
+  : LogStorage(dirPath, LogStorageOptions{})
+{
+}
+
+LogStorage::LogStorage(const std::string& dirPath, const LogStorageOptions& options)
+  : m_dirPath(dirPath.empty() ? "ndn_repo_log" : dirPath)
+  , m_options(options)
+{
+  std::error_code ec;
+  std::filesystem::create_directories(m_dirPath, ec);
+  if (!std::filesystem::is_directory(m_dirPath)) {
+    NDN_THROW(Error("Directory '" + m_dirPath + "' does not exists and cannot be created"));
+  }
+
+  NDN_LOG_DEBUG("Using log directory " << m_dirPath);
+  open();
+
+  if (m_options.enableBackgroundCompaction) {
+    m_needsCompaction = selectCompactionVictim().has_value();
+    m_compactionThread = std::thread([this] { runBackgroundCompaction(); });
+  }
+}
+
+LogStorage::~LogStorage()
+{
+  if (m_compactionThread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_isStopping = true;
+    }
+    m_compactionCv.notify_all();
+    m_compactionThread.join();
+  }
+
+  try {
+    if (m_isInTransaction) {
+      NDN_LOG_WARN("Rolling back the transaction left open");
+      rollbackTransaction();
+    }
+    writeCheckpoint();
+  }
+  catch (const std::exception& e) {
+    // the log is replayed from the previous checkpoint on the next start
+    NDN_LOG_ERROR("Cannot write checkpoint: " << e.what());
+  }
+
+  for (const auto& [id, segment] : m_segments) {
+    ::close(segment.fd);
+  }
+}
+
+std::string
+LogStorage::getSegmentPath(uint32_t id) const
+{
+  char fileName[20];
+  std::snprintf(fileName, sizeof(fileName), "%010u.log", id);
+  return m_dirPath + "/" + fileName;
+}
+
+uint64_t
+LogStorage::getRecordSize(const Location& location)
+{
+  return RECORD_HEADER_SIZE + location.nameSize + location.dataSize;
+}
+
+void
+LogStorage::open()
+{
+  for (const auto& entry : std::filesystem::directory_iterator(m_dirPath)) {
+    const auto& path = entry.path();
+    if (path.extension() != ".log") {
+      continue;
+    }
+    try {
+      openSegment(static_cast<uint32_t>(std::stoul(path.stem().string())), false);
+    }
+    catch (const std::logic_error&) {
+      NDN_LOG_WARN("Ignoring unexpected file " << path);
+    }
+  }
+
+  uint32_t fromSegment = 0;
+  uint64_t fromOffset = 0;
+  if (!loadCheckpoint(fromSegment, fromOffset)) {
+    m_index.clear();
+    m_nextSequence = 1;
+    fromSegment = 0;
+    fromOffset = 0;
+  }
+  replay(fromSegment, fromOffset);
+
+  // recompute the state derived from the index
+  m_insertionOrder.clear();
+  m_bytes = 0;
+  for (auto& [id, segment] : m_segments) {
+    segment.liveBytes = 0;
+  }
+  for (const auto& [key, location] : m_index) {
+    m_insertionOrder.emplace(location.sequence, &key);
+    m_bytes += location.dataSize;
+    m_segments.at(location.segment).liveBytes += getRecordSize(location);
+  }
+
+  if (m_segments.empty()) {
+    openSegment(1, true);
+  }
+  m_activeSegment = m_segments.rbegin()->first;
+  m_flushedSize = m_segments.rbegin()->second.size;
+  for (auto& [id, segment] : m_segments) {
+    if (id != m_activeSegment) {
+      mapSegment(id, segment);
+    }
+  }
+
+  NDN_LOG_INFO("Opened " << m_index.size() << " entries in " << m_segments.size() << " segments");
+}
+
+void
+LogStorage::openSegment(uint32_t id, bool isNew)
+{
+  std::string path = getSegmentPath(id);
+  int flags = O_RDWR | O_CLOEXEC | (isNew ? O_CREAT | O_EXCL : 0);
+  int fd = ::open(path.data(), flags, 0644);
+  if (fd < 0) {
+    throwSystemError("Cannot open segment file " + path);
+  }
+
+  off_t size = ::lseek(fd, 0, SEEK_END);
+  if (size < 0) {
+    ::close(fd);
+    throwSystemError("Cannot seek segment file " + path);
+  }
+
+  auto& segment = m_segments[id];
+  segment.fd = fd;
+  segment.size = static_cast<uint64_t>(size);
+}
+
+void
+LogStorage::mapSegment(uint32_t id, Segment& segment)
+{
+  if (!m_options.useMemoryMap || segment.size == 0) {
+    return;
+  }
+
+  void* addr = ::mmap(nullptr, segment.size, PROT_READ, MAP_SHARED, segment.fd, 0);
+  if (addr == MAP_FAILED) {
+    // reads from this segment fall back to pread
+    NDN_LOG_WARN("Cannot map segment " << id << ": " << std::strerror(errno));
+    return;
+  }
+  segment.mapping = std::make_shared<Mapping>(static_cast<const uint8_t*>(addr), segment.size);
+}
+
+bool
+LogStorage::loadCheckpoint(uint32_t& segment, uint64_t& offset)
+{
+  CheckpointReader reader(m_dirPath + "/" + CHECKPOINT_FILE);
+  if (!reader.isOpen()) {
+    return false;
+  }
+
+  uint64_t magic = 0;
+  uint32_t version = 0;
+  uint64_t nEntries = 0;
+  if (!reader.get(magic) || magic != CHECKPOINT_MAGIC ||
+      !reader.get(version) || version != CHECKPOINT_VERSION ||
+      !reader.get(segment) || !reader.get(offset) ||
+      !reader.get(m_nextSequence) || !reader.get(nEntries)) {
+    NDN_LOG_WARN("Ignoring invalid checkpoint, replaying the whole log");
+    return false;
+  }
+
+  Key key;
+  for (uint64_t i = 0; i < nEntries; ++i) {
+    uint32_t keySize = 0;
+    Location location;
+    if (!reader.get(keySize)) {
+      break;
+    }
+    key.resize(keySize);
+    if (!reader.read(key.data(), key.size()) ||
+        !reader.get(location.segment) || !reader.get(location.offset) ||
+        !reader.get(location.nameSize) || !reader.get(location.dataSize) ||
+        !reader.get(location.sequence)) {
+      break;
+    }
+    // Entries in a segment compacted after the checkpoint are dropped: their copies were
+    // appended after the checkpoint position and are restored by the replay.
+    auto it = m_segments.find(location.segment);
+    if (it != m_segments.end() && location.offset + getRecordSize(location) <= it->second.size) {
+      m_index.emplace_hint(m_index.end(), key, location);
+    }
+  }
+
+  if (!reader.verify()) {
+    NDN_LOG_WARN("Ignoring corrupted checkpoint, replaying the whole log");
+    return false;
+  }
+  NDN_LOG_DEBUG("Loaded checkpoint with " << nEntries << " entries at segment " << segment
+                << " offset " << offset);
+  return true;
+}
+
+void
+LogStorage::replay(uint32_t fromSegment, uint64_t fromOffset)
+{
+  uint64_t nRecords = 0;
+  Record record;
+  for (auto it = m_segments.lower_bound(fromSegment); it != m_segments.end(); ++it) {
+    auto& [id, segment] = *it;
+    uint64_t offset = id == fromSegment ? fromOffset : 0;
+    while (offset < segment.size) {
+      if (!readRecord(segment, offset, record)) {
+        NDN_LOG_WARN("Truncating segment " << id << " at incomplete or corrupted record at offset "
+                     << offset);
+        if (::ftruncate(segment.fd, static_cast<off_t>(offset)) != 0) {
+          throwSystemError("Cannot truncate segment file");
+        }
+        segment.size = offset;
+        break;
+      }
+
+      auto key = record.getName();
+      if (record.type == RECORD_PUT) {
+        Location location{id, offset, record.nameSize,
+                          static_cast<uint32_t>(record.getData().size()), record.sequence};
+        auto entry = m_index.find(key);
+        if (entry == m_index.end()) {
+          m_index.emplace(Key(key.begin(), key.end()), location);
+        }
+        else {
+          entry->second = location;
+        }
+        m_nextSequence = std::max(m_nextSequence, record.sequence + 1);
+      }
+      else {
+        // a tombstone only deletes the insertion it was written for
+        auto entry = m_index.find(key);
+        if (entry != m_index.end() && entry->second.sequence == record.sequence) {
+          m_index.erase(entry);
+        }
+      }
+      offset += record.size;
+      ++nRecords;
+    }
+  }
+  NDN_LOG_DEBUG("Replayed " << nRecords << " records");
+}
+
+bool
+LogStorage::readRecord(const Segment& segment, uint64_t offset, Record& record) const
+{
+  uint8_t header[RECORD_HEADER_SIZE];
+  if (offset + RECORD_HEADER_SIZE > segment.size ||
+      !readFully(segment.fd, header, sizeof(header), offset)) {
+    return false;
+  }
+
+  record.type = getValue<uint8_t>(header, 4);
+  record.sequence = getValue<uint64_t>(header, 8);
+  record.nameSize = getValue<uint32_t>(header, 16);
+  auto dataSize = getValue<uint32_t>(header, 20);
+  record.target = getValue<uint32_t>(header, 24);
+  record.size = RECORD_HEADER_SIZE + record.nameSize + dataSize;
+  if (getValue<uint32_t>(header, 0) != RECORD_MAGIC ||
+      (record.type != RECORD_PUT && record.type != RECORD_DELETE) ||
+      offset + record.size > segment.size) {
+    return false;
+  }
+
+  record.payload.resize(record.nameSize + dataSize);
+  if (!readFully(segment.fd, record.payload.data(), record.payload.size(),
+                 offset + RECORD_HEADER_SIZE)) {
+    return false;
+  }
+
+  boost::crc_32_type crc;
+  crc.process_bytes(header, RECORD_CHECKSUM_OFFSET);
+  crc.process_bytes(record.payload.data(), record.payload.size());
+  return crc.checksum() == getValue<uint32_t>(header, RECORD_CHECKSUM_OFFSET);
+}
+
+LogStorage::Location
+LogStorage::appendRecord(uint8_t type, ndn::span<const uint8_t> key, ndn::span<const uint8_t> data,
+                         uint64_t sequence, uint32_t target)
+{
+  uint64_t recordSize = RECORD_HEADER_SIZE + key.size() + data.size();
+  auto* segment = &m_segments.at(m_activeSegment);
+  // A transaction is kept in the active segment, so that rolling it back only truncates the
+  // segment; the segment may exceed its maximum size by the records of one transaction.
+  if (!m_isInTransaction && segment->size > 0 &&
+      segment->size + recordSize > m_options.maxSegmentSize) {
+    // the sealed segment is synced, so that records copied into it by compaction are durable
+    // before the compacted segment is removed
+    syncActiveSegment();
+    mapSegment(m_activeSegment, *segment);
+    openSegment(m_activeSegment + 1, true);
+    ++m_activeSegment;
+    m_flushedSize = 0;
+    segment = &m_segments.at(m_activeSegment);
+    NDN_LOG_DEBUG("Started segment " << m_activeSegment);
+  }
+
+  uint8_t header[RECORD_HEADER_SIZE] = {};
+  putValue(header, 0, RECORD_MAGIC);
+  putValue(header, 4, type);
+  putValue(header, 8, sequence);
+  putValue(header, 16, static_cast<uint32_t>(key.size()));
+  putValue(header, 20, static_cast<uint32_t>(data.size()));
+  putValue(header, 24, target);
+  boost::crc_32_type crc;
+  crc.process_bytes(header, RECORD_CHECKSUM_OFFSET);
+  crc.process_bytes(key.data(), key.size());
+  crc.process_bytes(data.data(), data.size());
+  putValue(header, RECORD_CHECKSUM_OFFSET, static_cast<uint32_t>(crc.checksum()));
+
+  m_writeBuffer.insert(m_writeBuffer.end(), std::begin(header), std::end(header));
+  m_writeBuffer.insert(m_writeBuffer.end(), key.begin(), key.end());
+  m_writeBuffer.insert(m_writeBuffer.end(), data.begin(), data.end());
+
+  Location location{m_activeSegment, segment->size, static_cast<uint32_t>(key.size()),
+                    static_cast<uint32_t>(data.size()), sequence};
+  segment->size += recordSize;
+  m_appendedSinceCheckpoint += recordSize;
+
+  if (!m_isInTransaction || m_writeBuffer.size() >= WRITE_BUFFER_FLUSH_SIZE) {
+    flushWriteBuffer();
+  }
+  return location;
+}
+
+void
+LogStorage::flushWriteBuffer()
+{
+  if (m_writeBuffer.empty()) {
+    return;
+  }
+  writeFully(m_segments.at(m_activeSegment).fd, m_writeBuffer.data(), m_writeBuffer.size(),
+             m_flushedSize);
+  m_flushedSize += m_writeBuffer.size();
+  m_writeBuffer.clear();
+}
+
+void
+LogStorage::syncActiveSegment()
+{
+  flushWriteBuffer();
+  if (::fsync(m_segments.at(m_activeSegment).fd) != 0) {
+    throwSystemError("Cannot sync segment file");
+  }
+}
+
+void
+LogStorage::checkpointIfNeeded()
+{
+  if (!m_isInTransaction && m_appendedSinceCheckpoint >= m_options.checkpointInterval) {
+    saveCheckpoint();
+  }
+}
+
+void
+LogStorage::writeCheckpoint()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_isInTransaction) {
+    NDN_THROW(Error("A checkpoint cannot be written within a transaction"));
+  }
+  saveCheckpoint();
+}
+
+void
+LogStorage::saveCheckpoint()
+{
+  // the checkpoint position must not be ahead of what is durable in the log
+  syncActiveSegment();
+
+  std::string path = m_dirPath + "/" + CHECKPOINT_FILE;
+  std::string tmpPath = path + ".tmp";
+  {
+    CheckpointWriter writer(tmpPath);
+    writer.put(CHECKPOINT_MAGIC);
+    writer.put(CHECKPOINT_VERSION);
+    writer.put(m_activeSegment);
+    writer.put(m_flushedSize);
+    writer.put(m_nextSequence);
+    writer.put(static_cast<uint64_t>(m_index.size()));
+    for (const auto& [key, location] : m_index) {
+      writer.put(static_cast<uint32_t>(key.size()));
+      writer.write(key.data(), key.size());
+      writer.put(location.segment);
+      writer.put(location.offset);
+      writer.put(location.nameSize);
+      writer.put(location.dataSize);
+      writer.put(location.sequence);
+    }
+    writer.finish();
+  }
+  if (std::rename(tmpPath.data(), path.data()) != 0) {
+    throwSystemError("Cannot rename checkpoint file");
+  }
+
+  m_appendedSinceCheckpoint = 0;
+  NDN_LOG_DEBUG("Wrote checkpoint with " << m_index.size() << " entries");
+}
+
+int64_t
+LogStorage::insert(const Data& data)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  doInsert(data, true);
+  checkpointIfNeeded();
+  return static_cast<int64_t>(m_nextSequence - 1);
+}
+
+bool
+LogStorage::insertIfAbsent(const Data& data)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  bool isInserted = doInsert(data, false);
+  checkpointIfNeeded();
+  return isInserted;
+}
+
+bool
+LogStorage::doInsert(const Data& data, bool throwIfExists)
+{
+  const Name& fullName = data.getFullName();
+  auto key = fullName.wireEncode().value_bytes();
+  if (m_index.find(key) != m_index.end()) {
+    if (throwIfExists) {
+      NDN_LOG_DEBUG("Insert failed");
+      NDN_THROW(Error("Insert failed"));
+    }
+    return false;
+  }
+
+  uint64_t sequence = m_nextSequence++;
+  const auto& wire = data.wireEncode();
+  auto location = appendRecord(RECORD_PUT, key, ndn::make_span(wire.data(), wire.size()),
+                               sequence, 0);
+  auto it = m_index.emplace(Key(key.begin(), key.end()), location).first;
+  m_insertionOrder.emplace(sequence, &it->first);
+  m_bytes += location.dataSize;
+  m_segments.at(location.segment).liveBytes += getRecordSize(location);
+  if (m_isInTransaction) {
+    m_transactionJournal.emplace_back(it->first, std::nullopt);
+  }
+  return true;
+}
+
+bool
+LogStorage::erase(const Name& name)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_index.find(name.wireEncode().value_bytes());
+  if (it == m_index.end()) {
+    return false;
+  }
+  doErase(it);
+  checkpointIfNeeded();
+  return true;
+}
+
+void
+LogStorage::doErase(Index::iterator it)
+{
+  Location location = it->second;
+  appendRecord(RECORD_DELETE, it->first, {}, location.sequence, location.segment);
+  if (m_isInTransaction) {
+    m_transactionJournal.emplace_back(it->first, location);
+  }
+
+  m_bytes -= location.dataSize;
+  m_insertionOrder.erase(location.sequence);
+  m_index.erase(it);
+
+  auto& segment = m_segments.at(location.segment);
+  segment.liveBytes -= getRecordSize(location);
+  if (location.segment != m_activeSegment &&
+      segment.liveBytes < m_options.compactionThreshold * segment.size && !m_needsCompaction) {
+    m_needsCompaction = true;
+    m_compactionCv.notify_one();
+  }
+}
+
+uint64_t
+LogStorage::eraseRange(const Name& begin, const Name& end,
+                       const std::function<void(const std::vector<Name>&)>& onChunk)
+{
+  NDN_LOG_DEBUG("Erasing range [" << begin << ", " << end << ")");
+  auto beginValue = begin.wireEncode().value_bytes();
+  auto endValue = end.wireEncode().value_bytes();
+
+  uint64_t nErased = 0;
+  while (true) {
+    std::vector<Name> names;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto it = m_index.lower_bound(beginValue);
+      while (it != m_index.end() && names.size() < ITERATION_CHUNK_SIZE &&
+             isEncodedLess(it->first, endValue)) {
+        names.push_back(decodeName(it->first));
+        doErase(it++);
+      }
+      checkpointIfNeeded();
+    }
+
+    if (names.empty()) {
+      break;
+    }
+    nErased += names.size();
+    onChunk(names);
+    if (names.size() < ITERATION_CHUNK_SIZE) {
+      break;
+    }
+  }
+
+  NDN_LOG_DEBUG("Erased " << nErased << " entries");
+  return nErased;
+}
+
+std::shared_ptr<Data>
+LogStorage::read(const Name& name)
+{
+  return find(name);
+}
+
+bool
+LogStorage::has(const Name& name)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_index.find(name.wireEncode().value_bytes()) != m_index.end();
+}
+
+std::shared_ptr<Data>
+LogStorage::find(const Name& name, bool exactMatch)
+{
+  NDN_LOG_DEBUG("Trying to find: " << name);
+  auto key = name.wireEncode().value_bytes();
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auto it = exactMatch ? m_index.find(key) : m_index.lower_bound(key);
+  if (it == m_index.end() || !isEncodedPrefixOf(key, it->first)) {
+    return nullptr;
+  }
+  return readData(lock, it->second);
+}
+
+std::shared_ptr<Data>
+LogStorage::findLast(const Name& prefix)
+{
+  NDN_LOG_DEBUG("Trying to find the last under: " << prefix);
+  auto key = prefix.wireEncode().value_bytes();
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auto it = findLastWithPrefix(m_index, key);
+  if (it == m_index.end()) {
+    return nullptr;
+  }
+  return readData(lock, it->second);
+}
+
+std::shared_ptr<Data>
+LogStorage::readData(std::unique_lock<std::mutex>& lock, const Location& location)
+{
+  auto buffer = std::make_shared<ndn::Buffer>(location.dataSize);
+  uint64_t dataOffset = location.offset + RECORD_HEADER_SIZE + location.nameSize;
+  const auto& segment = m_segments.at(location.segment);
+
+  if (segment.mapping != nullptr) {
+    // the reference keeps the mapping valid even if compaction removes the segment meanwhile
+    auto mapping = segment.mapping;
+    lock.unlock();
+    std::memcpy(buffer->data(), mapping->data + dataOffset, buffer->size());
+  }
+  else {
+    // a record still in the write buffer is written out first
+    if (location.segment == m_activeSegment &&
+        location.offset + getRecordSize(location) > m_flushedSize) {
+      flushWriteBuffer();
+    }
+    if (!readFully(segment.fd, buffer->data(), buffer->size(), dataOffset)) {
+      NDN_THROW(Error("Segment file is shorter than indexed"));
+    }
+    lock.unlock();
+  }
+
+  auto data = std::make_shared<Data>();
+  try {
+    data->wireDecode(ndn::Block(ndn::ConstBufferPtr(buffer)));
+  }
+  catch (const ndn::tlv::Error& error) {
+    NDN_LOG_DEBUG(error.what());
+    return nullptr;
+  }
+  NDN_LOG_DEBUG("Found: " << data->getName());
+  return data;
+}
+
+void
+LogStorage::forEachInInsertionOrder(const std::function<bool(const Name&)>& f)
+{
+  uint64_t cursor = 0;
+  while (true) {
+    std::vector<Name> names;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto it = m_insertionOrder.upper_bound(cursor);
+      for (; it != m_insertionOrder.end() && names.size() < ITERATION_CHUNK_SIZE; ++it) {
+        names.push_back(decodeName(*it->second));
+        cursor = it->first;
+      }
+    }
+
+    for (const auto& name : names) {
+      if (!f(name)) {
+        return;
+      }
+    }
+    if (names.size() < ITERATION_CHUNK_SIZE) {
+      break;
+    }
+  }
+}
+
+std::vector<Name>
+LogStorage::nextInInsertionOrder(InsertionOrderPosition& position, size_t limit)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = position.sequences.empty() ? m_insertionOrder.begin() :
+                                         m_insertionOrder.upper_bound(position.sequences.front());
+  std::vector<Name> names;
+  for (; it != m_insertionOrder.end() && names.size() < limit; ++it) {
+    names.push_back(decodeName(*it->second));
+    position.sequences = {it->first};
+  }
+  return names;
+}
+
+size_t
+LogStorage::scan(const Range& range, size_t limit, bool withData, const ScanCallback& f)
+{
+  auto begin = range.begin.wireEncode().value_bytes();
+  auto end = range.end.wireEncode().value_bytes();
+
+  std::vector<Name> names;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = range.isBeginIncluded ? m_index.lower_bound(begin) : m_index.upper_bound(begin);
+    for (; it != m_index.end() && names.size() < limit &&
+           (range.end.empty() || isEncodedLess(it->first, end)); ++it) {
+      names.push_back(decodeName(it->first));
+    }
+  }
+
+  for (const auto& name : names) {
+    if (!withData) {
+      f(name, nullptr);
+      continue;
+    }
+    // the Data are read one at a time, so that the lock is not held while f runs
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_index.find(name.wireEncode().value_bytes());
+    if (it == m_index.end()) {
+      // erased meanwhile by another thread
+      continue;
+    }
+    auto data = readData(lock, it->second);
+    if (lock.owns_lock()) {
+      lock.unlock();
+    }
+    f(name, std::move(data));
+  }
+  return names.size();
+}
+
+uint64_t
+LogStorage::size()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_index.size();
+}
+
+uint64_t
+LogStorage::bytes()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_bytes;
+}
+
+void
+LogStorage::beginTransaction()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  flushWriteBuffer();
+  m_isInTransaction = true;
+  m_transactionOffset = m_segments.at(m_activeSegment).size;
+  m_transactionSequence = m_nextSequence;
+}
+
+void
+LogStorage::commitTransaction()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  flushWriteBuffer();
+  endTransaction();
+  checkpointIfNeeded();
+}
+
+void
+LogStorage::rollbackTransaction()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_isInTransaction) {
+    return;
+  }
+
+  while (!m_transactionJournal.empty()) {
+    auto& [key, erasedLocation] = m_transactionJournal.back();
+    if (erasedLocation) {
+      auto it = m_index.emplace(key, *erasedLocation).first;
+      m_insertionOrder.emplace(erasedLocation->sequence, &it->first);
+      m_bytes += erasedLocation->dataSize;
+      m_segments.at(erasedLocation->segment).liveBytes += getRecordSize(*erasedLocation);
+    }
+    else {
+      auto it = m_index.find(key);
+      m_insertionOrder.erase(it->second.sequence);
+      m_bytes -= it->second.dataSize;
+      m_segments.at(it->second.segment).liveBytes -= getRecordSize(it->second);
+      m_index.erase(it);
+    }
+    m_transactionJournal.pop_back();
+  }
+
+  // the records of the transaction are at the end of the active segment, some maybe written
+  auto& segment = m_segments.at(m_activeSegment);
+  m_writeBuffer.clear();
+  if (m_flushedSize > m_transactionOffset &&
+      ::ftruncate(segment.fd, static_cast<off_t>(m_transactionOffset)) != 0) {
+    throwSystemError("Cannot truncate segment file");
+  }
+  m_appendedSinceCheckpoint -= std::min(m_appendedSinceCheckpoint, segment.size - m_transactionOffset);
+  segment.size = m_transactionOffset;
+  m_flushedSize = m_transactionOffset;
+  m_nextSequence = m_transactionSequence;
+  endTransaction();
+  NDN_LOG_DEBUG("Rolled back the transaction");
+}
+
+void
+LogStorage::endTransaction()
+{
+  m_isInTransaction = false;
+  m_transactionJournal.clear();
+  // compaction deferred during the transaction resumes
+  if (m_options.enableBackgroundCompaction && !m_needsCompaction &&
+      selectCompactionVictim().has_value()) {
+    m_needsCompaction = true;
+    m_compactionCv.notify_one();
+  }
+}
+
+size_t
+LogStorage::getNSegments() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_segments.size();
+}
+
+std::optional<uint32_t>
+LogStorage::selectCompactionVictim() const
+{
+  std::optional<uint32_t> victim;
+  double lowestRatio = m_options.compactionThreshold;
+  for (const auto& [id, segment] : m_segments) {
+    if (id == m_activeSegment) {
+      continue;
+    }
+    double ratio = segment.size == 0 ? 0.0 : static_cast<double>(segment.liveBytes) / segment.size;
+    if (ratio < lowestRatio) {
+      lowestRatio = ratio;
+      victim = id;
+    }
+  }
+  return victim;
+}
+
+void
+LogStorage::compact()
+{
+  std::lock_guard<std::mutex> compactionLock(m_compactionMutex);
+  while (true) {
+    std::optional<uint32_t> victim;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      victim = selectCompactionVictim();
+    }
+    if (!victim || !compactSegment(*victim)) {
+      break;
+    }
+  }
+}
+
+bool
+LogStorage::compactSegment(uint32_t id)
+{
+  // A sealed segment is never modified, and only compaction removes segments, so the file
+  // can be read without holding the lock. The index is checked again under the lock before
+  // each copy, since the entry may have been erased in the meantime.
+  const Segment* segment = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    segment = &m_segments.at(id);
+  }
+
+  uint64_t nCopied = 0;
+  uint64_t offset = 0;
+  Record record;
+  while (offset < segment->size && readRecord(*segment, offset, record)) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_isInTransaction) {
+        // the copies would be truncated with the transaction if it were rolled back;
+        // the records copied so far are no longer live here, so the segment is selected again
+        NDN_LOG_DEBUG("Compaction of segment " << id << " deferred by a transaction");
+        return false;
+      }
+      if (record.type == RECORD_PUT) {
+        auto it = m_index.find(record.getName());
+        if (it != m_index.end() && it->second.segment == id && it->second.offset == offset) {
+          auto location = appendRecord(RECORD_PUT, record.getName(), record.getData(),
+                                       record.sequence, 0);
+          m_segments.at(id).liveBytes -= getRecordSize(it->second);
+          m_segments.at(location.segment).liveBytes += getRecordSize(location);
+          it->second = location;
+          ++nCopied;
+        }
+      }
+      else if (record.target != id && m_segments.count(record.target) > 0) {
+        // the deleted record is still on disk, so the tombstone is still needed for replay
+        appendRecord(RECORD_DELETE, record.getName(), {}, record.sequence, record.target);
+      }
+    }
+    offset += record.size;
+  }
+  if (offset < segment->size) {
+    // the segment is kept, since the records after the damaged one cannot be copied
+    NDN_THROW(Error("Cannot compact segment " + std::to_string(id) +
+                    ": unreadable record at offset " + std::to_string(offset)));
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_isInTransaction) {
+    // a rollback could restore records of this segment erased by the transaction
+    NDN_LOG_DEBUG("Compaction of segment " << id << " deferred by a transaction");
+    return false;
+  }
+  // the copies must be durable before the original records are removed
+  syncActiveSegment();
+  ::close(segment->fd);
+  ::unlink(getSegmentPath(id).data());
+  m_segments.erase(id);
+  NDN_LOG_DEBUG("Compacted segment " << id << ", copied " << nCopied << " records");
+  return true;
+}
+
+void
+LogStorage::runBackgroundCompaction()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_compactionCv.wait(lock, [this] { return m_isStopping || m_needsCompaction; });
+    if (m_isStopping) {
+      break;
+    }
+    m_needsCompaction = false;
+
+    lock.unlock();
+    try {
+      compact();
+    }
+    catch (const std::exception& e) {
+      NDN_LOG_ERROR("Compaction failed: " << e.what());
+    }
+    lock.lock();
+  }
+}
+
+} // namespace repo
@@ -0,0 +1,300 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_STORAGE_LOG_STORAGE_HPP
+#define REPO_STORAGE_LOG_STORAGE_HPP
+
+#include "name-order.hpp"
+#include "storage.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace repo {
+
+struct LogStorageOptions
+{
+  /// a new segment file is started when the current one reaches this size
+  uint64_t maxSegmentSize = 64 * 1024 * 1024;
+  /// a checkpoint of the index is written after this many bytes are appended
+  uint64_t checkpointInterval = 1024 * 1024 * 1024;
+  /// segments whose live records take less than this fraction of the file are compacted
+  double compactionThreshold = 0.5;
+  /// whether compaction runs on a background thread
+  bool enableBackgroundCompaction = true;
+  /// whether Data in sealed segments are read from memory-mapped files
+  bool useMemoryMap = false;
+};
+
+/**
+ * @brief Storage that appends Data to segment files and indexes them in memory
+ *
+ * Each insertion appends a record with the full name and the wire encoding of the Data to
+ * the current segment file; each deletion appends a tombstone record. The in-memory index
+ * maps full names to record locations, ordered by their TLV encoding as in SqliteStorage.
+ *
+ * On startup, the index is loaded from the last checkpoint, and the records appended after
+ * it are replayed; a torn record at the end of the log is truncated. Segments that mostly
+ * contain deleted records are compacted by copying their live records to the end of the log.
+ *
+ * With LogStorageOptions::useMemoryMap, sealed segments are mapped into memory, and a read
+ * copies the Data out of the mapping without a system call and without holding the lock.
+ *
+ * Records are written in host byte order: the files are not portable across architectures.
+ */
+class LogStorage : public Storage
+{
+public:
+  explicit
+  LogStorage(const std::string& dirPath);
+
+  LogStorage(const std::string& dirPath, const LogStorageOptions& options);
+
+  /**
+   * @brief Stops background compaction and writes a checkpoint
+   */
+  ~LogStorage() override;
+
+  int64_t
+  insert(const Data& data) override;
+
+  bool
+  insertIfAbsent(const Data& data) override;
+
+  bool
+  erase(const Name& name) override;
+
+  uint64_t
+  eraseRange(const Name& begin, const Name& end,
+             const std::function<void(const std::vector<Name>&)>& onChunk) override;
+
+  std::shared_ptr<Data>
+  read(const Name& name) override;
+
+  bool
+  has(const Name& name) override;
+
+  std::shared_ptr<Data>
+  find(const Name& name, bool exactMatch = false) override;
+
+  std::shared_ptr<Data>
+  findLast(const Name& prefix) override;
+
+  void
+  forEachInInsertionOrder(const std::function<bool(const Name&)>& f) override;
+
+  std::vector<Name>
+  nextInInsertionOrder(InsertionOrderPosition& position, size_t limit) override;
+
+  /**
+   *  @brief  enumerate names from the index, then read the requested Data without the lock
+   */
+  size_t
+  scan(const Range& range, size_t limit, bool withData, const ScanCallback& f) override;
+
+  uint64_t
+  size() override;
+
+  uint64_t
+  bytes() override;
+
+  /**
+   * @brief Buffer appended records until commitTransaction()
+   *
+   * The records of a transaction are all appended to the active segment, and compaction is
+   * deferred until the transaction ends.
+   */
+  void
+  beginTransaction() override;
+
+  /**
+   * @brief Write buffered records to the segment file
+   */
+  void
+  commitTransaction() override;
+
+  /**
+   * @brief Undo the index changes since beginTransaction(), and truncate their records
+   *        from the active segment
+   */
+  void
+  rollbackTransaction() override;
+
+  /**
+   * @brief Compact all segments whose live fraction is below the threshold
+   *
+   * Called by the background thread, if enabled. Stops early while a transaction is open.
+   */
+  void
+  compact();
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /**
+   * @brief Write the index to the checkpoint file
+   * @throw Error a transaction is open
+   */
+  void
+  writeCheckpoint();
+
+  size_t
+  getNSegments() const;
+
+private:
+  /// TLV-VALUE of a full name
+  using Key = std::vector<uint8_t>;
+
+  struct Location
+  {
+    uint32_t segment;
+    uint64_t offset; ///< offset of the record in the segment file
+    uint32_t nameSize;
+    uint32_t dataSize;
+    uint64_t sequence; ///< insertion sequence number
+  };
+
+  struct Mapping;
+
+  struct Segment
+  {
+    int fd = -1;
+    uint64_t size = 0;
+    uint64_t liveBytes = 0; ///< total size of records referenced by the index
+    std::shared_ptr<const Mapping> mapping; ///< set for sealed segments if memory mapping is enabled
+  };
+
+  struct Record;
+
+  using Index = std::map<Key, Location, EncodedNameLess>;
+
+private:
+  void
+  open();
+
+  bool
+  loadCheckpoint(uint32_t& segment, uint64_t& offset);
+
+  void
+  replay(uint32_t fromSegment, uint64_t fromOffset);
+
+  /**
+   * @brief Read the record at @p offset of @p segment
+   * @return whether a complete and intact record was read
+   */
+  bool
+  readRecord(const Segment& segment, uint64_t offset, Record& record) const;
+
+  void
+  openSegment(uint32_t id, bool isNew);
+
+  /**
+   * @brief Map a sealed segment into memory, if enabled
+   */
+  void
+  mapSegment(uint32_t id, Segment& segment);
+
+  Location
+  appendRecord(uint8_t type, ndn::span<const uint8_t> key, ndn::span<const uint8_t> data,
+               uint64_t sequence, uint32_t target);
+
+  void
+  flushWriteBuffer();
+
+  /**
+   * @brief Write a checkpoint if enough records were appended since the last one
+   */
+  void
+  checkpointIfNeeded();
+
+  void
+  saveCheckpoint();
+
+  void
+  syncActiveSegment();
+
+  /**
+   * @brief Clear the transaction state, and resume compaction deferred by the transaction
+   */
+  void
+  endTransaction();
+
+  bool
+  doInsert(const Data& data, bool throwIfExists);
+
+  void
+  doErase(Index::iterator it);
+
+  /**
+   * @brief Read the Data at @p location
+   * @param lock the held lock on m_mutex, released as soon as possible
+   */
+  std::shared_ptr<Data>
+  readData(std::unique_lock<std::mutex>& lock, const Location& location);
+
+  std::optional<uint32_t>
+  selectCompactionVictim() const;
+
+  /**
+   * @return false if the compaction was deferred by a transaction
+   */
+  bool
+  compactSegment(uint32_t id);
+
+  void
+  runBackgroundCompaction();
+
+  std::string
+  getSegmentPath(uint32_t id) const;
+
+  static uint64_t
+  getRecordSize(const Location& location);
+
+private:
+  std::string m_dirPath;
+  LogStorageOptions m_options;
+
+  mutable std::mutex m_mutex;
+  Index m_index;
+  std::map<uint64_t, const Key*> m_insertionOrder;
+  std::map<uint32_t, Segment> m_segments;
+  uint32_t m_activeSegment = 0;
+  uint64_t m_nextSequence = 1;
+  uint64_t m_bytes = 0;
+  uint64_t m_appendedSinceCheckpoint = 0;
+
+  std::vector<uint8_t> m_writeBuffer;
+  uint64_t m_flushedSize = 0; ///< size of the active segment already written to the file
+  bool m_isInTransaction = false;
+  uint64_t m_transactionOffset = 0; ///< size of the active segment when the transaction began
+  uint64_t m_transactionSequence = 0; ///< next sequence number when the transaction began
+  /// index changes in the open transaction, with the location of erased entries,
+  /// so that they can be reverted if the transaction is rolled back
+  std::vector<std::pair<Key, std::optional<Location>>> m_transactionJournal;
+
+  std::mutex m_compactionMutex; ///< serializes compaction passes
+  std::thread m_compactionThread;
+  std::condition_variable m_compactionCv;
+  bool m_needsCompaction = false;
+  bool m_isStopping = false;
+};
+
+} // namespace repo
+
+#endif // REPO_STORAGE_LOG_STORAGE_HPP
@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "lookup-filter.hpp"
+
+#include <cmath>
+
+namespace repo {
+
+const double FALSE_POSITIVE_RATE = 0.01;
+const uint64_t ENTRIES_PER_DATA = 2;
+const uint8_t MAX_COUNT = 255;
+
+namespace {
+
+/**
+ * @brief Final step of SplitMix64, which spreads the bits of an FNV-1a state
+ */
+uint64_t
+mix(uint64_t z)
+{
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+} // namespace
+
+LookupFilter::LookupFilter(uint64_t capacity, size_t minPrefixLength)
+  : m_minPrefixLength(std::max<size_t>(minPrefixLength, 1))
+{
+  // optimal size and number of hash functions of a Bloom filter with n entries
+  double nEntries = static_cast<double>(std::max<uint64_t>(capacity * ENTRIES_PER_DATA, 1));
+  double nCounters = std::ceil(-nEntries * std::log(FALSE_POSITIVE_RATE) / (std::log(2) * std::log(2)));
+  m_nHashes = std::max<size_t>(std::lround(nCounters / nEntries * std::log(2)), 1);
+  m_counters.resize(static_cast<size_t>(nCounters));
+}
+
+template<class F>
+void
+LookupFilter::forEachPrefixHash(const Name& name, size_t minLength, const F& f) const
+{
+  // the TLV-VALUE of a prefix is a prefix of the TLV-VALUE of the name, so the hashes of
+  // all prefixes are obtained in one pass
+  auto value = name.wireEncode().value_bytes();
+  uint64_t state = 0xcbf29ce484222325;
+  size_t offset = 0;
+  for (size_t i = 0; i < name.size(); ++i) {
+    size_t end = offset + name[i].size();
+    for (; offset < end; ++offset) {
+      state ^= value[offset];
+      state *= 0x100000001b3;
+    }
+    if (i + 1 >= minLength) {
+      f(mix(state));
+    }
+  }
+}
+
+void
+LookupFilter::add(const Name& fullName)
+{
+  forEachPrefixHash(fullName, m_minPrefixLength, [this] (uint64_t hash) {
+    update(hash, true);
+  });
+}
+
+void
+LookupFilter::remove(const Name& fullName)
+{
+  forEachPrefixHash(fullName, m_minPrefixLength, [this] (uint64_t hash) {
+    update(hash, false);
+  });
+}
+
+bool
+LookupFilter::mayMatch(const Name& name) const
+{
+  BOOST_ASSERT(canCheck(name));
+
+  bool isPresent = true;
+  forEachPrefixHash(name, name.size(), [&] (uint64_t hash) {
+    for (size_t i = 0; i < m_nHashes && isPresent; ++i) {
+      isPresent = m_counters[getCounterIndex(hash, i)] > 0;
+    }
+  });
+  return isPresent;
+}
+
+size_t
+LookupFilter::getCounterIndex(uint64_t hash, size_t i) const
+{
+  // double hashing, with an odd step derived from the swapped halves of the hash
+  uint64_t step = ((hash >> 32) | (hash << 32)) | 1;
+  return (hash + i * step) % m_counters.size();
+}
+
+void
+LookupFilter::update(uint64_t hash, bool isIncrement)
+{
+  for (size_t i = 0; i < m_nHashes; ++i) {
+    uint8_t& counter = m_counters[getCounterIndex(hash, i)];
+    if (counter == MAX_COUNT) {
+      continue;
+    }
+    if (isIncrement) {
+      ++counter;
+    }
+    else if (counter > 0) {
+      --counter;
+    }
+  }
+}
+
+} // namespace repo
@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_STORAGE_LOOKUP_FILTER_HPP
+#define REPO_STORAGE_LOOKUP_FILTER_HPP
+
+#include "../common.hpp"
+
+namespace repo {
+
+/**
+ * @brief Counting Bloom filter over the names under which stored data can be found
+ *
+ * The filter holds every prefix of at least @c minPrefixLength components of the full name
+ * of each stored data, so that mayMatch() can tell that no stored data matches a name
+ * without accessing the storage. Removing data decrements the counters set by adding it.
+ *
+ * Counters saturate instead of overflowing, and a saturated counter is never decremented.
+ * This only causes false positives, e.g., for a prefix shared by many data after they are
+ * all removed.
+ */
+class LookupFilter : noncopyable
+{
+public:
+  /**
+   * @param capacity expected number of stored data; the filter is sized for two distinct
+   *        entries per data, its name and full name, at a false positive rate of 1%
+   * @param minPrefixLength length of the shortest prefixes in the filter, at least 1
+   */
+  LookupFilter(uint64_t capacity, size_t minPrefixLength);
+
+  /**
+   * @brief Add the prefixes of @p fullName
+   */
+  void
+  add(const Name& fullName);
+
+  /**
+   * @brief Remove the prefixes of @p fullName, which must have been added
+   */
+  void
+  remove(const Name& fullName);
+
+  /**
+   * @brief Whether @p name can be checked, i.e., it is not shorter than the shortest prefixes
+   */
+  bool
+  canCheck(const Name& name) const
+  {
+    return name.size() >= m_minPrefixLength;
+  }
+
+  /**
+   * @brief Whether the full name of some added data may start with @p name
+   * @retval false no added data matches @p name
+   * @pre canCheck(@p name)
+   */
+  bool
+  mayMatch(const Name& name) const;
+
+  size_t
+  getNCounters() const
+  {
+    return m_counters.size();
+  }
+
+  size_t
+  getNHashes() const
+  {
+    return m_nHashes;
+  }
+
+private:
+  /**
+   * @brief Call @p f with the hash of each prefix of @p name in the filter
+   */
+  template<class F>
+  void
+  forEachPrefixHash(const Name& name, size_t minLength, const F& f) const;
+
+  /**
+   * @brief Index of the @p i-th counter of the entry with @p hash
+   */
+  size_t
+  getCounterIndex(uint64_t hash, size_t i) const;
+
+  void
+  update(uint64_t hash, bool isIncrement);
+
+private:
+  size_t m_minPrefixLength;
+  size_t m_nHashes;
+  std::vector<uint8_t> m_counters;
+};
+
+} // namespace repo
+
+#endif // REPO_STORAGE_LOOKUP_FILTER_HPP
@@ -0,0 +1,297 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "memory-storage.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace repo {
+
+NDN_LOG_INIT(repo.MemoryStorage);
+
+namespace {
+
+const size_t ERASE_RANGE_CHUNK_SIZE = 1000;
+
+} // namespace
+
+MemoryStorage::MemoryStorage(const std::string& snapshotPath)
+  : m_snapshotPath(snapshotPath)
+{
+  if (m_snapshotPath.empty()) {
+    return;
+  }
+
+  auto dirPath = std::filesystem::path(m_snapshotPath).parent_path();
+  if (!dirPath.empty()) {
+    std::error_code ec;
+    std::filesystem::create_directories(dirPath, ec);
+  }
+  loadSnapshot();
+}
+
+MemoryStorage::~MemoryStorage()
+{
+  if (m_snapshotPath.empty()) {
+    return;
+  }
+
+  try {
+    saveSnapshot();
+  }
+  catch (const std::exception& e) {
+    NDN_LOG_ERROR("Cannot write snapshot: " << e.what());
+  }
+}
+
+void
+MemoryStorage::loadSnapshot()
+{
+  std::ifstream is(m_snapshotPath, std::ios::binary);
+  if (!is.is_open()) {
+    NDN_LOG_DEBUG("No snapshot at " << m_snapshotPath);
+    return;
+  }
+
+  std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(is)),
+                             std::istreambuf_iterator<char>());
+  ndn::span<const uint8_t> remaining(buffer);
+  while (!remaining.empty()) {
+    auto [isOk, block] = ndn::Block::fromBuffer(remaining);
+    if (!isOk) {
+      NDN_LOG_WARN("Ignoring truncated snapshot tail of " << remaining.size() << " bytes");
+      break;
+    }
+    remaining = remaining.subspan(block.size());
+
+    try {
+      doInsert(Data(block), false);
+    }
+    catch (const ndn::tlv::Error& error) {
+      NDN_LOG_WARN("Ignoring undecodable Data in snapshot: " << error.what());
+    }
+  }
+  NDN_LOG_INFO("Loaded " << m_index.size() << " entries from " << m_snapshotPath);
+}
+
+void
+MemoryStorage::saveSnapshot()
+{
+  // written to a temporary file first, so that a failure leaves the previous snapshot intact
+  std::string tmpPath = m_snapshotPath + ".tmp";
+  {
+    std::ofstream os(tmpPath, std::ios::binary | std::ios::trunc);
+    for (const auto& [sequence, it] : m_insertionOrder) {
+      const auto& wire = it->second.data.wireEncode();
+      os.write(reinterpret_cast<const char*>(wire.data()),
+               static_cast<std::streamsize>(wire.size()));
+    }
+    os.flush();
+    if (!os) {
+      NDN_THROW(Error("Cannot write snapshot file " + tmpPath));
+    }
+  }
+  if (std::rename(tmpPath.data(), m_snapshotPath.data()) != 0) {
+    NDN_THROW(Error("Cannot rename snapshot file " + tmpPath));
+  }
+  NDN_LOG_INFO("Saved " << m_index.size() << " entries to " << m_snapshotPath);
+}
+
+int64_t
+MemoryStorage::insert(const Data& data)
+{
+  doInsert(data, true);
+  return static_cast<int64_t>(m_nextSequence - 1);
+}
+
+bool
+MemoryStorage::insertIfAbsent(const Data& data)
+{
+  return doInsert(data, false);
+}
+
+bool
+MemoryStorage::doInsert(const Data& data, bool throwIfExists)
+{
+  const Name& fullName = data.getFullName();
+  auto key = fullName.wireEncode().value_bytes();
+  auto it = m_index.lower_bound(key); // also the insertion hint
+  if (it != m_index.end() && !isEncodedLess(key, it->first)) {
+    if (throwIfExists) {
+      NDN_LOG_DEBUG("Insert failed");
+      NDN_THROW(Error("Insert failed"));
+    }
+    return false;
+  }
+
+  uint64_t sequence = m_nextSequence++;
+  it = m_index.emplace_hint(it, Key(key.begin(), key.end()), Entry{data, sequence});
+  m_insertionOrder.emplace(sequence, it);
+  m_bytes += data.wireEncode().size();
+  return true;
+}
+
+bool
+MemoryStorage::erase(const Name& name)
+{
+  auto it = m_index.find(name.wireEncode().value_bytes());
+  if (it == m_index.end()) {
+    return false;
+  }
+  doErase(it);
+  return true;
+}
+
+void
+MemoryStorage::doErase(Index::iterator it)
+{
+  m_bytes -= it->second.data.wireEncode().size();
+  m_insertionOrder.erase(it->second.sequence);
+  m_index.erase(it);
+}
+
+uint64_t
+MemoryStorage::eraseRange(const Name& begin, const Name& end,
+                          const std::function<void(const std::vector<Name>&)>& onChunk)
+{
+  NDN_LOG_DEBUG("Erasing range [" << begin << ", " << end << ")");
+  auto beginValue = begin.wireEncode().value_bytes();
+  auto endValue = end.wireEncode().value_bytes();
+
+  uint64_t nErased = 0;
+  while (true) {
+    std::vector<Name> names;
+    auto it = m_index.lower_bound(beginValue);
+    while (it != m_index.end() && names.size() < ERASE_RANGE_CHUNK_SIZE &&
+           isEncodedLess(it->first, endValue)) {
+      names.push_back(it->second.data.getFullName());
+      doErase(it++);
+    }
+
+    if (names.empty()) {
+      break;
+    }
+    nErased += names.size();
+    onChunk(names);
+    if (names.size() < ERASE_RANGE_CHUNK_SIZE) {
+      break;
+    }
+  }
+
+  NDN_LOG_DEBUG("Erased " << nErased << " entries");
+  return nErased;
+}
+
+std::shared_ptr<Data>
+MemoryStorage::read(const Name& name)
+{
+  return find(name);
+}
+
+bool
+MemoryStorage::has(const Name& name)
+{
+  return m_index.find(name.wireEncode().value_bytes()) != m_index.end();
+}
+
+std::shared_ptr<Data>
+MemoryStorage::find(const Name& name, bool exactMatch)
+{
+  NDN_LOG_DEBUG("Trying to find: " << name);
+  auto key = name.wireEncode().value_bytes();
+  auto it = exactMatch ? m_index.find(key) : m_index.lower_bound(key);
+  if (it == m_index.end() || !isEncodedPrefixOf(key, it->first)) {
+    return nullptr;
+  }
+
+  // the copy shares the wire encoding of the stored Data
+  NDN_LOG_DEBUG("Found: " << it->second.data.getName());
+  return std::make_shared<Data>(it->second.data);
+}
+
+std::shared_ptr<Data>
+MemoryStorage::findLast(const Name& prefix)
+{
+  NDN_LOG_DEBUG("Trying to find the last under: " << prefix);
+  auto it = findLastWithPrefix(m_index, prefix.wireEncode().value_bytes());
+  if (it == m_index.end()) {
+    return nullptr;
+  }
+
+  NDN_LOG_DEBUG("Found: " << it->second.data.getName());
+  return std::make_shared<Data>(it->second.data);
+}
+
+void
+MemoryStorage::forEachInInsertionOrder(const std::function<bool(const Name&)>& f)
+{
+  for (const auto& [sequence, it] : m_insertionOrder) {
+    if (!f(it->second.data.getFullName())) {
+      break;
+    }
+  }
+}
+
+std::vector<Name>
+MemoryStorage::nextInInsertionOrder(InsertionOrderPosition& position, size_t limit)
+{
+  auto it = position.sequences.empty() ? m_insertionOrder.begin() :
+                                         m_insertionOrder.upper_bound(position.sequences.front());
+  std::vector<Name> names;
+  for (; it != m_insertionOrder.end() && names.size() < limit; ++it) {
+    names.push_back(it->second->second.data.getFullName());
+    position.sequences = {it->first};
+  }
+  return names;
+}
+
+size_t
+MemoryStorage::scan(const Range& range, size_t limit, bool withData, const ScanCallback& f)
+{
+  auto begin = range.begin.wireEncode().value_bytes();
+  auto end = range.end.wireEncode().value_bytes();
+  auto it = range.isBeginIncluded ? m_index.lower_bound(begin) : m_index.upper_bound(begin);
+
+  size_t nEnumerated = 0;
+  for (; it != m_index.end() && nEnumerated < limit &&
+         (range.end.empty() || isEncodedLess(it->first, end)); ++it, ++nEnumerated) {
+    // the copy shares the wire encoding of the stored Data
+    f(it->second.data.getFullName(), withData ? std::make_shared<Data>(it->second.data) : nullptr);
+  }
+  return nEnumerated;
+}
+
+uint64_t
+MemoryStorage::size()
+{
+  return m_index.size();
+}
+
+uint64_t
+MemoryStorage::bytes()
+{
+  return m_bytes;
+}
+
+} // namespace repo
@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_STORAGE_MEMORY_STORAGE_HPP
+#define REPO_STORAGE_MEMORY_STORAGE_HPP
+
+#include "name-order.hpp"
+#include "storage.hpp"
+
+namespace repo {
+
+/**
+ * @brief Storage that keeps Data in memory only
+ *
+ * Data are indexed by the TLV encoding of their full names, in the same order as
+ * SqliteStorage, so that prefix lookups and range deletions behave the same.
+ *
+ * If a snapshot path is given, the stored Data are written to that file on destruction,
+ * and loaded from it on construction. Data inserted since the last snapshot are lost
+ * if the process does not exit cleanly.
+ */
+class MemoryStorage : public Storage
+{
+public:
+  /**
+   * @param snapshotPath file to load the Data from and save them to; empty to disable
+   */
+  explicit
+  MemoryStorage(const std::string& snapshotPath = "");
+
+  /**
+   * @brief Writes the snapshot, if enabled
+   */
+  ~MemoryStorage() override;
+
+  int64_t
+  insert(const Data& data) override;
+
+  bool
+  insertIfAbsent(const Data& data) override;
+
+  bool
+  erase(const Name& name) override;
+
+  uint64_t
+  eraseRange(const Name& begin, const Name& end,
+             const std::function<void(const std::vector<Name>&)>& onChunk) override;
+
+  std::shared_ptr<Data>
+  read(const Name& name) override;
+
+  bool
+  has(const Name& name) override;
+
+  std::shared_ptr<Data>
+  find(const Name& name, bool exactMatch = false) override;
+
+  std::shared_ptr<Data>
+  findLast(const Name& prefix) override;
+
+  void
+  forEachInInsertionOrder(const std::function<bool(const Name&)>& f) override;
+
+  std::vector<Name>
+  nextInInsertionOrder(InsertionOrderPosition& position, size_t limit) override;
+
+  size_t
+  scan(const Range& range, size_t limit, bool withData, const ScanCallback& f) override;
+
+  uint64_t
+  size() override;
+
+  uint64_t
+  bytes() override;
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /**
+   * @brief Write all stored Data to the snapshot file, in insertion order
+   */
+  void
+  saveSnapshot();
+
+private:
+  /// TLV-VALUE of a full name
+  using Key = std::vector<uint8_t>;
+
+  struct Entry
+  {
+    Data data;
+    uint64_t sequence; ///< insertion sequence number
+  };
+
+  using Index = std::map<Key, Entry, EncodedNameLess>;
+
+private:
+  void
+  loadSnapshot();
+
+  bool
+  doInsert(const Data& data, bool throwIfExists);
+
+  void
+  doErase(Index::iterator it);
+
+private:
+  std::string m_snapshotPath;
+  Index m_index;
+  std::map<uint64_t, Index::iterator> m_insertionOrder;
+  uint64_t m_nextSequence = 1;
+  uint64_t m_bytes = 0;
+};
+
+} // namespace repo
+
+#endif // REPO_STORAGE_MEMORY_STORAGE_HPP
@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_STORAGE_NAME_ORDER_HPP
+#define REPO_STORAGE_NAME_ORDER_HPP
+
+#include "../common.hpp"
+
+/**
+ * @file
+ *
+ * The storage backends order names by the TLV-VALUE of their Name element, compared
+ * byte-wise, which is the order of the `name` column of SqliteStorage. The helpers below
+ * are shared by the backends that keep or merge names in this order.
+ */
+
+namespace repo {
+
+/**
+ * @brief Check whether TLV-VALUE @p prefix of a Name is a prefix of TLV-VALUE @p name of another
+ *
+ * Name components are self-delimiting TLV elements, so a byte-wise prefix of the encoded
+ * components is also a component-wise prefix of the name.
+ */
+inline bool
+isEncodedPrefixOf(ndn::span<const uint8_t> prefix, ndn::span<const uint8_t> name)
+{
+  return prefix.size() <= name.size() && std::equal(prefix.begin(), prefix.end(), name.begin());
+}
+
+/**
+ * @brief Compare the TLV-VALUEs of two names
+ */
+inline bool
+isEncodedLess(ndn::span<const uint8_t> a, ndn::span<const uint8_t> b)
+{
+  return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+/**
+ * @brief Compare names in the order of their TLV encoding
+ */
+inline bool
+isEncodedLess(const Name& a, const Name& b)
+{
+  return isEncodedLess(a.wireEncode().value_bytes(), b.wireEncode().value_bytes());
+}
+
+/**
+ * @brief Ordering of keys holding the TLV-VALUE of a name, which also accepts spans for lookups
+ */
+struct EncodedNameLess
+{
+  using is_transparent = void;
+
+  bool
+  operator()(ndn::span<const uint8_t> a, ndn::span<const uint8_t> b) const
+  {
+    return isEncodedLess(a, b);
+  }
+};
+
+/**
+ * @brief Entry of @p index with the last key starting with @p prefix, or end() if none
+ * @tparam Index an ordered map whose keys hold the TLV-VALUE of names, see EncodedNameLess
+ */
+template<class Index>
+typename Index::iterator
+findLastWithPrefix(Index& index, ndn::span<const uint8_t> prefix)
+{
+  // the keys starting with the prefix are the keys from the prefix up to, excluding, the
+  // prefix without its trailing 0xFF bytes and with its last byte incremented
+  std::vector<uint8_t> end(prefix.begin(), prefix.end());
+  while (!end.empty() && end.back() == 0xFF) {
+    end.pop_back();
+  }
+  auto it = index.end();
+  if (!end.empty()) {
+    ++end.back();
+    it = index.lower_bound(end);
+  }
+  if (it == index.begin()) {
+    return index.end();
+  }
+  --it;
+  return isEncodedPrefixOf(prefix, it->first) ? it : index.end();
+}
+
+} // namespace repo
+
+#endif // REPO_STORAGE_NAME_ORDER_HPP
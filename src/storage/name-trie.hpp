@@ -0,0 +1,264 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_STORAGE_NAME_TRIE_HPP
+#define REPO_STORAGE_NAME_TRIE_HPP
+
+#include "../common.hpp"
+
+#include <optional>
+#include <string_view>
+
+namespace repo {
+
+/**
+ * @brief Map from names to values of type @p T, stored as a trie of name components
+ *
+ * Each node holds the TLV encoding of one component, so the names under a prefix share its
+ * nodes, and the node of a name does not keep the wire encoding of the name alive. Children
+ * are ordered by the TLV encoding of their component, which is the order of the TLV encoding
+ * of whole names used by the storage backends, e.g., findFirst() returns the entry that a
+ * range query starting at the prefix would return first.
+ */
+template<class T>
+class NameTrie : noncopyable
+{
+public:
+  /**
+   * @brief Add @p name with @p value
+   * @return false if @p name is already present; its value is then left unchanged
+   */
+  bool
+  insert(const Name& name, T value)
+  {
+    Node* node = &m_root;
+    forEachComponent(name, [&] (std::string_view component) {
+      auto it = node->children.find(component);
+      if (it == node->children.end()) {
+        it = node->children.emplace(std::string(component), std::make_unique<Node>()).first;
+        m_nodeBytes += getNodeSize(it->first);
+      }
+      node = it->second.get();
+      return true;
+    });
+
+    if (node->value) {
+      return false;
+    }
+    node->value = std::move(value);
+    ++m_size;
+    return true;
+  }
+
+  /**
+   * @brief Remove @p name
+   * @return its value, or nullopt if it was not present
+   */
+  std::optional<T>
+  erase(const Name& name)
+  {
+    // path from the root, to remove the nodes left empty
+    std::vector<std::pair<Node*, typename Children::iterator>> path;
+    path.reserve(name.size());
+    Node* node = &m_root;
+    bool isFound = forEachComponent(name, [&] (std::string_view component) {
+      auto it = node->children.find(component);
+      if (it == node->children.end()) {
+        return false;
+      }
+      path.emplace_back(node, it);
+      node = it->second.get();
+      return true;
+    });
+    if (!isFound || !node->value) {
+      return std::nullopt;
+    }
+
+    std::optional<T> value = std::move(node->value);
+    node->value.reset();
+    --m_size;
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+      auto& [parent, child] = *it;
+      if (child->second->value || !child->second->children.empty()) {
+        break;
+      }
+      m_nodeBytes -= getNodeSize(child->first);
+      parent->children.erase(child);
+    }
+    return value;
+  }
+
+  /**
+   * @brief Value of @p name, or nullptr if it is not present
+   */
+  T*
+  find(const Name& name)
+  {
+    Node* node = findNode(name);
+    return node != nullptr && node->value ? &*node->value : nullptr;
+  }
+
+  const T*
+  find(const Name& name) const
+  {
+    return const_cast<NameTrie*>(this)->find(name);
+  }
+
+  /**
+   * @brief Value of the first name starting with @p prefix, in the order of the TLV encoding
+   * @return nullptr if no name starts with @p prefix
+   */
+  const T*
+  findFirst(const Name& prefix) const
+  {
+    const Node* node = const_cast<NameTrie*>(this)->findNode(prefix);
+    if (node == nullptr) {
+      return nullptr;
+    }
+    // a name comes before the names it is a prefix of
+    while (!node->value) {
+      if (node->children.empty()) {
+        return nullptr;
+      }
+      node = node->children.begin()->second.get();
+    }
+    return &*node->value;
+  }
+
+  /**
+   * @brief Value of the last name starting with @p prefix, in the order of the TLV encoding
+   *
+   * This is the rightmost descendant of @p prefix, e.g., the latest version or last segment
+   * when their components are appended under @p prefix.
+   *
+   * @return nullptr if no name starts with @p prefix
+   */
+  const T*
+  findLast(const Name& prefix) const
+  {
+    const Node* node = const_cast<NameTrie*>(this)->findNode(prefix);
+    if (node == nullptr) {
+      return nullptr;
+    }
+    while (!node->children.empty()) {
+      node = node->children.rbegin()->second.get();
+    }
+    return node->value ? &*node->value : nullptr;
+  }
+
+  /**
+   * @brief Number of names
+   */
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  bool
+  empty() const
+  {
+    return m_size == 0;
+  }
+
+  /**
+   * @brief Estimate of the heap memory used by the trie, in bytes
+   */
+  size_t
+  getMemoryUsage() const
+  {
+    return m_nodeBytes;
+  }
+
+  void
+  clear()
+  {
+    m_root.children.clear();
+    m_size = 0;
+    m_nodeBytes = 0;
+  }
+
+private:
+  struct Node;
+  /// children keyed by the TLV encoding of their component
+  using Children = std::map<std::string, std::unique_ptr<Node>, std::less<>>;
+
+  struct Node
+  {
+    std::optional<T> value;
+    Children children;
+  };
+
+  /**
+   * @brief Call @p f with the TLV encoding of each component of @p name, until it returns false
+   * @return whether @p f returned true for all components
+   */
+  template<class F>
+  static bool
+  forEachComponent(const Name& name, const F& f)
+  {
+    auto value = name.wireEncode().value_bytes();
+    size_t offset = 0;
+    for (size_t i = 0; i < name.size(); ++i) {
+      size_t size = name[i].size();
+      if (!f(std::string_view(reinterpret_cast<const char*>(value.data()) + offset, size))) {
+        return false;
+      }
+      offset += size;
+    }
+    return true;
+  }
+
+  Node*
+  findNode(const Name& name)
+  {
+    Node* node = &m_root;
+    bool isFound = forEachComponent(name, [&] (std::string_view component) {
+      auto it = node->children.find(component);
+      if (it == node->children.end()) {
+        return false;
+      }
+      node = it->second.get();
+      return true;
+    });
+    return isFound ? node : nullptr;
+  }
+
+  static size_t
+  getNodeSize(const std::string& component)
+  {
+    // map node with its color and three links, the node itself, and the component
+    // if it does not fit in the string
+    const size_t mapNodeOverhead = 4 * sizeof(void*);
+    size_t size = mapNodeOverhead + sizeof(typename Children::value_type) + sizeof(Node);
+    if (component.capacity() > std::string().capacity()) {
+      size += component.capacity() + 1;
+    }
+    return size;
+  }
+
+private:
+  Node m_root;
+  size_t m_size = 0;
+  size_t m_nodeBytes = 0;
+};
+
+} // namespace repo
+
+#endif // REPO_STORAGE_NAME_TRIE_HPP
@@ -18,9 +18,13 @@
  */
 
 #include "repo-storage.hpp"
+#include "cursor.hpp"
+#include "name-order.hpp"
 #include "config.hpp"
 
+#include <algorithm>
 #include <istream>
+#include <utility>
 
 #include <ndn-cxx/util/exception.hpp>
 #include <ndn-cxx/util/logger.hpp>
@@ -29,64 +33,781 @@ namespace repo {
 
 NDN_LOG_INIT(repo.RepoStorage);
 
+const size_t EVICTION_BATCH_SIZE = 1000;
+const size_t PREFIX_CHECK_BATCH_SIZE = 10000;
+const size_t MIGRATION_BATCH_SIZE = 1000;
+const uint64_t MIGRATION_LOG_BATCHES = 100;
+const uint64_t STARTUP_SCAN_LOG_BATCHES = 100;
+const size_t LOOKUP_FILTER_BATCH_SIZE = 10000;
+
+namespace {
+
+/**
+ * @brief Whether an enumeration in the order of TLV encoding, positioned at @p position,
+ *        has reached @p fullName
+ */
+bool
+isReached(const Name& fullName, const Name& position)
+{
+  return !isEncodedLess(position, fullName);
+}
+
+/**
+ * @brief Commit the transaction of @p storage, or roll it back if the commit fails
+ * @throw Storage::Error the commit failed
+ */
+void
+commitOrRollback(Storage& storage)
+{
+  try {
+    storage.commitTransaction();
+  }
+  catch (const Storage::Error&) {
+    try {
+      storage.rollbackTransaction();
+    }
+    catch (const Storage::Error& e) {
+      NDN_LOG_WARN("Rollback failed: " << e.what());
+    }
+    throw;
+  }
+}
+
+} // namespace
+
 RepoStorage::RepoStorage(Storage& store)
   : m_storage(store)
 {
 }
 
+RepoStorage::~RepoStorage()
+{
+  // The callbacks of asynchronous operations must not be called after destruction, so the
+  // pending insertions are committed synchronously, and not signaled.
+  if (!m_hasOpenTransaction)
+    return;
+
+  try {
+    commitOrRollback(m_storage);
+  }
+  catch (const Storage::Error& e) {
+    if (!m_hasFailedBegin) {
+      NDN_LOG_ERROR("Group commit of " << m_pendingInsertions.size() << " Data failed: " << e.what());
+    }
+  }
+}
+
+void
+RepoStorage::enableGroupCommit(Scheduler& scheduler, size_t maxRows, time::milliseconds maxDelay)
+{
+  flush();
+  m_scheduler = &scheduler;
+  m_groupCommitRows = std::max<size_t>(maxRows, 1);
+  m_groupCommitDelay = maxDelay;
+}
+
+void
+RepoStorage::flush()
+{
+  if (!m_hasOpenTransaction)
+    return;
+
+  m_commitEvent.cancel();
+  m_hasOpenTransaction = false;
+
+  // Completions of asynchronous insertions into the transaction, and of a failure to begin
+  // it, are delivered before that of the commit, so their data are pending by then. Data
+  // inserted afterwards are part of the next transaction, and are completed after it.
+  m_storage.asyncRun(commitOrRollback,
+    [this] { afterCommit(); },
+    [this] (const std::string& reason) {
+      if (m_hasFailedBegin) {
+        // without the transaction, the insertions were committed one by one
+        NDN_LOG_DEBUG("No group commit transaction to commit: " << reason);
+        afterCommit();
+        return;
+      }
+      NDN_LOG_ERROR("Group commit of " << m_pendingInsertions.size() << " Data failed: " << reason);
+      m_pendingInsertions.clear();
+    });
+}
+
+void
+RepoStorage::afterCommit()
+{
+  m_hasFailedBegin = false;
+  auto committed = std::move(m_pendingInsertions);
+  m_pendingInsertions.clear();
+  NDN_LOG_DEBUG("Committed " << committed.size() << " Data");
+  for (const auto& fullName : committed) {
+    if (isEnumerated(fullName)) {
+      afterDataInsertion(fullName.getPrefix(-1));
+    }
+  }
+  checkCapacity();
+}
+
+void
+RepoStorage::enableCapacityLimits(Scheduler& scheduler, uint64_t maxPackets, uint64_t maxBytes,
+                                  std::unique_ptr<EvictionPolicy> policy)
+{
+  BOOST_ASSERT(policy != nullptr);
+  m_scheduler = &scheduler;
+  m_maxPackets = maxPackets;
+  m_maxBytes = maxBytes;
+  m_evictionPolicy = std::move(policy);
+  checkCapacity();
+}
+
+bool
+RepoStorage::isOverCapacity(uint64_t nPackets, uint64_t nBytes) const
+{
+  return (m_maxPackets > 0 && nPackets > m_maxPackets) ||
+         (m_maxBytes > 0 && nBytes > m_maxBytes);
+}
+
+void
+RepoStorage::checkCapacity()
+{
+  if (m_evictionPolicy == nullptr || m_isEvictionScheduled)
+    return;
+
+  if (m_isUsageRequested) {
+    m_isUsageCheckPending = true;
+    return;
+  }
+
+  m_isUsageRequested = true;
+  m_storage.asyncUsage(
+    [this] (uint64_t nPackets, uint64_t nBytes) {
+      m_isUsageRequested = false;
+      bool isCheckPending = std::exchange(m_isUsageCheckPending, false);
+      if (isOverCapacity(nPackets, nBytes)) {
+        if (!m_isEvictionScheduled) {
+          m_isEvictionScheduled = true;
+          m_evictionEvent = m_scheduler->schedule(0_ms, [this] { evictBatch(); });
+        }
+      }
+      else if (isCheckPending) {
+        checkCapacity();
+      }
+    },
+    [this] (const std::string& reason) {
+      m_isUsageRequested = false;
+      m_isUsageCheckPending = false;
+      NDN_LOG_ERROR("Capacity check failed: " << reason);
+    });
+}
+
+void
+RepoStorage::evictBatch()
+{
+  flush();
+
+  m_storage.asyncUsage(
+    [this] (uint64_t nPackets, uint64_t nBytes) {
+      uint64_t nExcess = 0;
+      if (m_maxPackets > 0 && nPackets > m_maxPackets) {
+        nExcess = nPackets - m_maxPackets;
+      }
+      if (m_maxBytes > 0 && nPackets > 0 && nBytes > m_maxBytes) {
+        // estimate the number of packets to evict from the average packet size
+        uint64_t avgSize = std::max<uint64_t>(nBytes / nPackets, 1);
+        nExcess = std::max(nExcess, (nBytes - m_maxBytes + avgSize - 1) / avgSize);
+      }
+      if (nExcess == 0) {
+        m_isEvictionScheduled = false;
+        return;
+      }
+      selectVictims(std::min<uint64_t>(nExcess, EVICTION_BATCH_SIZE));
+    },
+    [this] (const std::string& reason) {
+      NDN_LOG_ERROR("Eviction failed: " << reason);
+      m_isEvictionScheduled = false;
+    });
+}
+
+void
+RepoStorage::selectVictims(size_t nVictims)
+{
+  // at most one batch of stored data is examined in each event
+  struct Listing
+  {
+    Storage::InsertionOrderPosition position;
+    std::vector<Name> fullNames;
+  };
+  auto listing = std::make_shared<Listing>();
+  listing->position = m_evictionPolicy->getPosition();
+  m_storage.asyncRun(
+    [listing, nVictims] (Storage& storage) {
+      listing->fullNames = storage.nextInInsertionOrder(listing->position, nVictims);
+    },
+    [this, listing, nVictims] {
+      bool isEnd = listing->fullNames.size() < nVictims;
+      auto victims = m_evictionPolicy->selectVictims(listing->fullNames, std::move(listing->position),
+                                                     isEnd, nVictims);
+
+      m_hasEvictionPassVictims = m_hasEvictionPassVictims || !victims.empty();
+      if (isEnd) {
+        // a policy may need a pass over the stored data before it selects any, but not two
+        m_nIdleEvictionPasses = m_hasEvictionPassVictims ? 0 : m_nIdleEvictionPasses + 1;
+        m_hasEvictionPassVictims = false;
+        if (m_nIdleEvictionPasses >= 2) {
+          NDN_LOG_WARN("Storage exceeds capacity limits, but no data can be evicted");
+          m_nIdleEvictionPasses = 0;
+          m_isEvictionScheduled = false;
+          return;
+        }
+      }
+      if (victims.empty()) {
+        // continue after other pending events are processed
+        m_isEvictionScheduled = false;
+        checkCapacity();
+        return;
+      }
+      eraseVictims(std::move(victims));
+    },
+    [this] (const std::string& reason) {
+      NDN_LOG_ERROR("Eviction failed: " << reason);
+      m_isEvictionScheduled = false;
+    });
+}
+
+void
+RepoStorage::eraseVictims(std::vector<Name> victims)
+{
+  // the victims are erased in a transaction of their own
+  flush();
+
+  auto evicted = std::make_shared<std::vector<Name>>();
+  evicted->reserve(victims.size());
+  m_storage.asyncRun(
+    [victims = std::move(victims), evicted] (Storage& storage) {
+      storage.beginTransaction();
+      try {
+        for (const auto& name : victims) {
+          if (storage.erase(name)) {
+            evicted->push_back(name);
+          }
+        }
+      }
+      catch (const Storage::Error&) {
+        storage.rollbackTransaction();
+        throw;
+      }
+      commitOrRollback(storage);
+    },
+    [this, evicted] {
+      NDN_LOG_DEBUG("Evicted " << evicted->size() << " Data");
+      afterErasure(*evicted);
+
+      // continue with the next batch after other pending events are processed
+      m_isEvictionScheduled = false;
+      checkCapacity();
+    },
+    [this] (const std::string& reason) {
+      NDN_LOG_ERROR("Eviction failed: " << reason);
+      m_isEvictionScheduled = false;
+    });
+}
+
+void
+RepoStorage::enablePrefixSummary(size_t nSuffixComponents)
+{
+  flush();
+  m_hasPrefixSummary = m_storage.enablePrefixSummary(nSuffixComponents);
+  if (!m_hasPrefixSummary) {
+    NDN_LOG_DEBUG("Storage does not support prefix summaries");
+  }
+}
+
+void
+RepoStorage::startPrefixSummaryCheck(Scheduler& scheduler)
+{
+  if (!m_hasPrefixSummary)
+    return;
+
+  m_scheduler = &scheduler;
+  m_prefixCheckEvent = m_scheduler->schedule(0_ms, [this] { checkPrefixSummaryStep(); });
+}
+
+void
+RepoStorage::checkPrefixSummaryStep()
+{
+  // the storage counts the names of each step outside of a transaction
+  flush();
+
+  struct Step
+  {
+    bool hasMore = false;
+    std::vector<std::pair<Name, int64_t>> corrections;
+  };
+  auto step = std::make_shared<Step>();
+  m_storage.asyncRun(
+    [step] (Storage& storage) {
+      step->hasMore = storage.checkPrefixSummary(PREFIX_CHECK_BATCH_SIZE,
+        [&step] (const Name& prefix, int64_t delta) {
+          step->corrections.emplace_back(prefix, delta);
+        });
+    },
+    [this, step] {
+      for (const auto& [prefix, delta] : step->corrections) {
+        afterPrefixCountChange(prefix, delta);
+      }
+      if (step->hasMore) {
+        m_prefixCheckEvent = m_scheduler->schedule(0_ms, [this] { checkPrefixSummaryStep(); });
+      }
+    },
+    [] (const std::string& reason) {
+      NDN_LOG_ERROR("Prefix summary check failed: " << reason);
+    });
+}
+
+void
+RepoStorage::startMigration(Scheduler& scheduler)
+{
+  m_migrationProgress = m_storage.getMigrationProgress();
+  if (m_migrationProgress.version == 0)
+    return;
+
+  NDN_LOG_INFO("Migrating " << m_migrationProgress.nEntries - m_migrationProgress.nMigrated
+               << " stored Data to schema version " << m_migrationProgress.version);
+  m_scheduler = &scheduler;
+  m_nMigrationSteps = 0;
+  m_migrationEvent = m_scheduler->schedule(0_ms, [this] { migrateStep(); });
+}
+
+void
+RepoStorage::migrateStep()
+{
+  // Outside a group commit, the batch is committed by migrate() itself, so the progress kept
+  // in memory by the backend cannot get ahead of a group commit that is later rolled back.
+  flush();
+
+  struct Step
+  {
+    bool hasMore = false;
+    Storage::MigrationProgress progress;
+  };
+  auto step = std::make_shared<Step>();
+  m_storage.asyncRun(
+    [step] (Storage& storage) {
+      step->hasMore = storage.migrate(MIGRATION_BATCH_SIZE);
+      step->progress = storage.getMigrationProgress();
+    },
+    [this, step] {
+      m_migrationProgress = step->progress;
+      if (!step->hasMore) {
+        NDN_LOG_INFO("Schema migration completed");
+        return;
+      }
+      if (++m_nMigrationSteps % MIGRATION_LOG_BATCHES == 0) {
+        const auto& progress = m_migrationProgress;
+        NDN_LOG_INFO("Migrated " << progress.nMigrated << " of " << progress.nEntries
+                     << " stored Data to schema version " << progress.version);
+      }
+      m_migrationEvent = m_scheduler->schedule(0_ms, [this] { migrateStep(); });
+    },
+    [] (const std::string& reason) {
+      NDN_LOG_ERROR("Schema migration failed: " << reason);
+    });
+}
+
 void
 RepoStorage::notifyAboutExistingData()
 {
-  m_storage.forEach([this] (const Name& name) {
-      afterDataInsertion(name);
+  if (m_hasPrefixSummary) {
+    m_storage.forEachPrefixCount([this] (const Name& prefix, uint64_t count) {
+      afterPrefixCountChange(prefix, static_cast<int64_t>(count));
+      m_nScannedData += count;
     });
+    return;
+  }
+
+  Cursor cursor(m_storage, {});
+  while (cursor.next()) {
+    afterDataInsertion(cursor.getFullName().getPrefix(-1));
+    ++m_nScannedData;
+  }
+}
+
+void
+RepoStorage::notifyAboutExistingDataIncrementally(Scheduler& scheduler, size_t batchSize)
+{
+  if (m_hasPrefixSummary) {
+    // loading the summary does not take long enough to be worth splitting
+    notifyAboutExistingData();
+    return;
+  }
+
+  m_scheduler = &scheduler;
+  m_isScanning = true;
+  m_scanBatchSize = std::max<size_t>(batchSize, 1);
+  // A page is one batch, so no entries are buffered between events and the entries modified
+  // meanwhile are all on either side of the cursor position, see isEnumerated().
+  Cursor::Options options;
+  options.pageSize = m_scanBatchSize;
+  m_scanCursor = std::make_unique<Cursor>(m_storage, options);
+  m_nScannedData = 0;
+  m_scanStartTime = time::steady_clock::now();
+  NDN_LOG_INFO("Enumerating existing data in the background");
+  m_scanEvent = m_scheduler->schedule(0_ms, [this] { scanBatch(); });
+}
+
+void
+RepoStorage::scanBatch()
+{
+  // Pending insertions are already visible to the enumeration. Committing them before the
+  // cursor moves ensures each is signaled exactly once, by either flush() or the enumeration.
+  // The page is read after the modifications started so far, and its completion is delivered
+  // after theirs and before those of later ones, so the same holds for them.
+  flush();
+
+  m_scanCursor->asyncReadAhead([this] { enumerateScanBatch(); },
+    [this] (const std::string& reason) {
+      NDN_LOG_ERROR("Enumeration of existing data failed after " << m_nScannedData << " Data: "
+                    << reason);
+      m_isScanning = false;
+      m_scanCursor.reset();
+    });
+}
+
+void
+RepoStorage::enumerateScanBatch()
+{
+  // a page is one batch, so the cursor does not read from the storage here
+  size_t nScanned = 0;
+  bool hasMore = true;
+  while (nScanned < m_scanBatchSize && (hasMore = m_scanCursor->next())) {
+    afterDataInsertion(m_scanCursor->getFullName().getPrefix(-1));
+    ++nScanned;
+  }
+
+  uint64_t nScannedBefore = m_nScannedData;
+  m_nScannedData += nScanned;
+  if (!hasMore) {
+    m_isScanning = false;
+    m_scanCursor.reset();
+    NDN_LOG_INFO("Enumerated " << m_nScannedData << " existing Data in "
+                 << time::duration_cast<time::milliseconds>(time::steady_clock::now() - m_scanStartTime));
+    return;
+  }
+
+  uint64_t logInterval = STARTUP_SCAN_LOG_BATCHES * m_scanBatchSize;
+  if (m_nScannedData / logInterval != nScannedBefore / logInterval) {
+    m_storage.asyncUsage(
+      [nScanned = m_nScannedData] (uint64_t nPackets, uint64_t) {
+        NDN_LOG_INFO("Enumerated " << nScanned << " of about " << nPackets << " existing Data");
+      },
+      [] (const std::string&) {});
+  }
+  m_scanEvent = m_scheduler->schedule(0_ms, [this] { scanBatch(); });
 }
 
 bool
-RepoStorage::insertData(const Data& data)
+RepoStorage::isEnumerated(const Name& fullName) const
+{
+  if (!m_isScanning)
+    return true;
+
+  return isReached(fullName, m_scanCursor->getResumeToken());
+}
+
+void
+RepoStorage::enableLookupFilter(Scheduler& scheduler, uint64_t capacity, size_t minPrefixLength)
+{
+  m_scheduler = &scheduler;
+  m_lookupFilter = std::make_unique<LookupFilter>(capacity, minPrefixLength);
+  m_lookupFilterCounters = {};
+  Cursor::Options options;
+  options.pageSize = LOOKUP_FILTER_BATCH_SIZE;
+  m_filterCursor = std::make_unique<Cursor>(m_storage, options);
+  NDN_LOG_INFO("Building lookup filter with " << m_lookupFilter->getNCounters() << " counters and "
+               << m_lookupFilter->getNHashes() << " hash functions");
+  m_filterBuildEvent = m_scheduler->schedule(0_ms, [this] { buildLookupFilterBatch(); });
+}
+
+void
+RepoStorage::buildLookupFilterBatch()
+{
+  // as in scanBatch(), pending insertions are added either now or when they are committed
+  flush();
+
+  m_filterCursor->asyncReadAhead([this] { addLookupFilterBatch(); },
+    [this] (const std::string& reason) {
+      NDN_LOG_ERROR("Building lookup filter failed, Data are looked up without it: " << reason);
+      m_filterCursor.reset();
+      m_lookupFilter.reset();
+    });
+}
+
+void
+RepoStorage::addLookupFilterBatch()
+{
+  // a page is one batch, so the cursor does not read from the storage here
+  size_t nAdded = 0;
+  bool hasMore = true;
+  while (nAdded < LOOKUP_FILTER_BATCH_SIZE && (hasMore = m_filterCursor->next())) {
+    m_lookupFilter->add(m_filterCursor->getFullName());
+    ++nAdded;
+  }
+
+  if (hasMore) {
+    m_filterBuildEvent = m_scheduler->schedule(0_ms, [this] { buildLookupFilterBatch(); });
+    return;
+  }
+  NDN_LOG_INFO("Lookup filter built from " << m_filterCursor->getNEnumerated() << " Data");
+  m_filterCursor.reset();
+}
+
+bool
+RepoStorage::isInLookupFilter(const Name& fullName) const
+{
+  if (m_lookupFilter == nullptr)
+    return false;
+  if (m_filterCursor == nullptr)
+    return true;
+
+  // data ahead of the cursor are added when the enumeration reaches them
+  return isReached(fullName, m_filterCursor->getResumeToken());
+}
+
+RepoStorage::FilterResult
+RepoStorage::checkLookupFilter(const Name& name) const
 {
-  bool isExist = m_storage.has(data.getFullName());
+  if (!isLookupFilterReady() || !m_lookupFilter->canCheck(name))
+    return FilterResult::NOT_CHECKED;
+
+  ++m_lookupFilterCounters.nChecked;
+  if (m_lookupFilter->mayMatch(name))
+    return FilterResult::MAY_MATCH;
 
-  if (isExist) {
+  ++m_lookupFilterCounters.nSkipped;
+  NDN_LOG_DEBUG("No data for " << name << " according to the lookup filter");
+  return FilterResult::NO_MATCH;
+}
+
+void
+RepoStorage::countLookup(FilterResult result, bool isFound) const
+{
+  if (result != FilterResult::MAY_MATCH)
+    return;
+
+  if (isFound) {
+    ++m_lookupFilterCounters.nHits;
+  }
+  else {
+    ++m_lookupFilterCounters.nFalsePositives;
+  }
+}
+
+bool
+RepoStorage::prepareInsertion()
+{
+  bool isGroupCommit = m_groupCommitRows > 1;
+  if (isGroupCommit && !m_hasOpenTransaction) {
+    m_hasOpenTransaction = true;
+    m_commitEvent = m_scheduler->schedule(m_groupCommitDelay, [this] { flush(); });
+    m_storage.asyncBeginTransaction([this] (const std::string& reason) {
+      NDN_LOG_ERROR("Group commit transaction could not begin: " << reason);
+      m_hasFailedBegin = true;
+    });
+  }
+  return isGroupCommit;
+}
+
+void
+RepoStorage::afterInsertion(const Name& fullName, bool isGroupCommit)
+{
+  NDN_LOG_DEBUG("Inserted " << fullName);
+  // the data can be read before it is committed
+  if (isInLookupFilter(fullName)) {
+    m_lookupFilter->add(fullName);
+  }
+
+  if (isGroupCommit) {
+    m_pendingInsertions.push_back(fullName);
+    // not while the transaction is being committed, which then includes this insertion
+    if (m_hasOpenTransaction && m_pendingInsertions.size() >= m_groupCommitRows) {
+      flush();
+    }
+    return;
+  }
+
+  if (isEnumerated(fullName)) {
+    afterDataInsertion(fullName.getPrefix(-1));
+  }
+  checkCapacity();
+}
+
+bool
+RepoStorage::insertData(const Data& data)
+{
+  bool isGroupCommit = prepareInsertion();
+  if (!m_storage.insertIfAbsent(data)) {
     NDN_LOG_DEBUG("Data already in storage, regarded as successful data insertion");
     return true;
   }
+  afterInsertion(data.getFullName(), isGroupCommit);
+  return true;
+}
 
-  int64_t id = m_storage.insert(data);
-  NDN_LOG_DEBUG("Insert ID: " << id << ", full name:" << data.getFullName());
-  if (id == NOTFOUND)
-    return false;
+void
+RepoStorage::insertData(const Data& data, const std::function<void(bool)>& onDone)
+{
+  bool isGroupCommit = prepareInsertion();
+  m_storage.asyncInsert(data,
+    [this, fullName = data.getFullName(), isGroupCommit, onDone] (bool isInserted) {
+      if (isInserted) {
+        afterInsertion(fullName, isGroupCommit);
+      }
+      else {
+        NDN_LOG_DEBUG("Data already in storage, regarded as successful data insertion");
+      }
+      if (onDone) {
+        onDone(true);
+      }
+    },
+    [name = data.getName(), onDone] (const std::string& reason) {
+      NDN_LOG_ERROR("Insertion of " << name << " failed: " << reason);
+      if (onDone) {
+        onDone(false);
+      }
+    });
+}
 
-  afterDataInsertion(data.getName());
+bool
+RepoStorage::insertData(ndn::span<const Data> batch)
+{
+  // the batch is a transaction of its own
+  flush();
+
+  std::vector<Name> fullNames;
+  fullNames.reserve(batch.size());
+  for (const auto& data : batch) {
+    fullNames.push_back(data.getFullName());
+  }
+  afterBatchInsertion(fullNames, m_storage.insertBatch(batch));
   return true;
 }
 
-ssize_t
-RepoStorage::deleteData(const Name& name)
+void
+RepoStorage::insertData(ndn::span<const Data> batch, const std::function<void(bool)>& onDone)
 {
-  NDN_LOG_DEBUG("Delete: " << name);
-  bool hasError = false;
-
-  int64_t count = 0;
-  std::shared_ptr<Data> foundData;
-  Name foundName;
-  while ((foundData = m_storage.find(name))) {
-    foundName = foundData->getFullName();
-    bool resultDb = m_storage.erase(foundName);
-    if (resultDb) {
-      afterDataDeletion(foundName);
-      count++;
+  flush();
+
+  std::vector<Name> fullNames;
+  fullNames.reserve(batch.size());
+  for (const auto& data : batch) {
+    fullNames.push_back(data.getFullName());
+  }
+  m_storage.asyncInsertBatch(batch,
+    [this, fullNames, onDone] (const std::vector<bool>& isInserted) {
+      afterBatchInsertion(fullNames, isInserted);
+      if (onDone) {
+        onDone(true);
+      }
+    },
+    [nData = batch.size(), onDone] (const std::string& reason) {
+      NDN_LOG_ERROR("Insertion of a batch of " << nData << " Data failed: " << reason);
+      if (onDone) {
+        onDone(false);
+      }
+    });
+}
+
+void
+RepoStorage::afterBatchInsertion(const std::vector<Name>& fullNames,
+                                 const std::vector<bool>& isInserted)
+{
+  std::vector<Name> names;
+  for (size_t i = 0; i < fullNames.size(); ++i) {
+    if (!isInserted[i])
+      continue;
+
+    if (isInLookupFilter(fullNames[i])) {
+      m_lookupFilter->add(fullNames[i]);
     }
-    else {
-      hasError = true;
+    if (isEnumerated(fullNames[i])) {
+      names.push_back(fullNames[i].getPrefix(-1));
     }
-    NDN_LOG_DEBUG("Delete: " << name << ", found " << foundName << ", count " << count << ", result " << resultDb);
   }
+  NDN_LOG_DEBUG("Inserted " << std::count(isInserted.begin(), isInserted.end(), true) << " of "
+                << fullNames.size() << " Data in a batch");
+
+  if (!names.empty()) {
+    afterDataBatchInsertion(names);
+  }
+  checkCapacity();
+}
+
+void
+RepoStorage::afterErasure(const std::vector<Name>& fullNames)
+{
+  for (const auto& fullName : fullNames) {
+    if (m_evictionPolicy != nullptr) {
+      m_evictionPolicy->afterErase(fullName);
+    }
+    if (isInLookupFilter(fullName)) {
+      m_lookupFilter->remove(fullName);
+    }
+    if (isEnumerated(fullName)) {
+      afterDataDeletion(fullName);
+    }
+  }
+}
+
+ssize_t
+RepoStorage::deleteData(const Name& name)
+{
+  return deleteRange(name, name.getSuccessor());
+}
+
+void
+RepoStorage::deleteData(const Name& name, const std::function<void(ssize_t)>& onDone)
+{
+  deleteRange(name, name.getSuccessor(), onDone);
+}
 
-  if (hasError)
+ssize_t
+RepoStorage::deleteRange(const Name& begin, const Name& end)
+{
+  NDN_LOG_DEBUG("Delete: [" << begin << ", " << end << ")");
+  // deletions must not overtake insertions that have not been signaled yet
+  flush();
+
+  try {
+    uint64_t count = m_storage.eraseRange(begin, end, [this] (const std::vector<Name>& erased) {
+      afterErasure(erased);
+    });
+    NDN_LOG_DEBUG("Deleted " << count << " Data");
+    return static_cast<ssize_t>(count);
+  }
+  catch (const Storage::Error& e) {
+    NDN_LOG_ERROR("Deletion of [" << begin << ", " << end << ") failed: " << e.what());
     return -1;
-  else
-    return count;
+  }
+}
+
+void
+RepoStorage::deleteRange(const Name& begin, const Name& end,
+                         const std::function<void(ssize_t)>& onDone)
+{
+  NDN_LOG_DEBUG("Delete: [" << begin << ", " << end << ")");
+  flush();
+
+  m_storage.asyncEraseRange(begin, end,
+    [this] (const std::vector<Name>& erased) {
+      afterErasure(erased);
+    },
+    [onDone] (uint64_t count) {
+      NDN_LOG_DEBUG("Deleted " << count << " Data");
+      onDone(static_cast<ssize_t>(count));
+    },
+    [begin, end, onDone] (const std::string& reason) {
+      NDN_LOG_ERROR("Deletion of [" << begin << ", " << end << ") failed: " << reason);
+      onDone(-1);
+    });
 }
 
 ssize_t
@@ -100,8 +821,38 @@ RepoStorage::readData(const Interest& interest) const
 {
   NDN_LOG_DEBUG("Reading data for " << interest.getName());
 
-  return m_storage.read(interest.getName());
+  auto filterResult = checkLookupFilter(interest.getName());
+  if (filterResult == FilterResult::NO_MATCH) {
+    return nullptr;
+  }
+
+  auto data = m_storage.findMatch(interest, m_isRightmostPrefixMatch);
+  countLookup(filterResult, data != nullptr);
+  if (data != nullptr && m_evictionPolicy != nullptr) {
+    m_evictionPolicy->afterRead(data->getName());
+  }
+  return data;
 }
 
+void
+RepoStorage::readData(const Interest& interest, const Storage::FindCallback& onResult) const
+{
+  NDN_LOG_DEBUG("Reading data for " << interest.getName());
+
+  auto filterResult = checkLookupFilter(interest.getName());
+  if (filterResult == FilterResult::NO_MATCH) {
+    onResult(nullptr);
+    return;
+  }
+
+  m_storage.asyncFindMatch(interest, m_isRightmostPrefixMatch,
+                           [this, filterResult, onResult] (std::shared_ptr<Data> data) {
+    countLookup(filterResult, data != nullptr);
+    if (data != nullptr && m_evictionPolicy != nullptr) {
+      m_evictionPolicy->afterRead(data->getName());
+    }
+    onResult(std::move(data));
+  });
+}
 
 } // namespace repo
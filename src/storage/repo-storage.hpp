@@ -20,6 +20,8 @@
 #ifndef REPO_STORAGE_REPO_STORAGE_HPP
 #define REPO_STORAGE_REPO_STORAGE_HPP
 
+#include "eviction-policy.hpp"
+#include "lookup-filter.hpp"
 #include "storage.hpp"
 #include "../repo-command-parameter.hpp"
 
@@ -27,6 +29,8 @@
 
 namespace repo {
 
+class Cursor;
+
 /**
  *  @brief  RepoStorage handles the storage part of whole repo,
  *          including index and database
@@ -40,23 +44,214 @@ public:
     using std::runtime_error::runtime_error;
   };
 
+  /**
+   * @brief Outcomes of the lookups of data for Interests, with a lookup filter
+   */
+  struct LookupFilterCounters
+  {
+    uint64_t nChecked = 0;        ///< lookups checked against the filter
+    uint64_t nSkipped = 0;        ///< lookups the filter found to miss, without accessing storage
+    uint64_t nHits = 0;           ///< lookups passed to the storage that found data
+    uint64_t nFalsePositives = 0; ///< lookups passed to the storage that found no data
+  };
+
   explicit
   RepoStorage(Storage& store);
 
+  /**
+   * @brief Commits pending insertions, if any, without signaling them
+   */
+  ~RepoStorage();
+
+  /**
+   * @brief Enable group commit of inserted data
+   *
+   * Inserted data are accumulated in a single storage transaction, which is committed
+   * after @p maxRows insertions or @p maxDelay after the first pending insertion,
+   * whichever comes first. afterDataInsertion is signaled only after the commit succeeds.
+   */
+  void
+  enableGroupCommit(Scheduler& scheduler, size_t maxRows, time::milliseconds maxDelay);
+
+  /**
+   * @brief Commit pending insertions and signal afterDataInsertion for them
+   *
+   * The commit is done without waiting for the storage. Operations started afterwards are
+   * not part of the committed transaction.
+   */
+  void
+  flush();
+
+  /**
+   * @brief Enforce capacity limits on stored data
+   * @param maxPackets maximum number of stored data packets, 0 for no limit
+   * @param maxBytes maximum total size in bytes of stored data packets, 0 for no limit
+   * @param policy selects the data to evict when a limit is exceeded
+   *
+   * Limits are checked after each insertion. Eviction runs on @p scheduler in batches,
+   * so that it does not stall other processing, and signals afterDataDeletion for each
+   * evicted data.
+   */
+  void
+  enableCapacityLimits(Scheduler& scheduler, uint64_t maxPackets, uint64_t maxBytes,
+                       std::unique_ptr<EvictionPolicy> policy);
+
+  /**
+   * @brief Maintain a persisted summary of registration prefixes, if the storage supports it
+   * @param nSuffixComponents number of last name components removed to obtain the
+   *        registration prefix of data
+   * @sa Storage::enablePrefixSummary
+   */
+  void
+  enablePrefixSummary(size_t nSuffixComponents);
+
+  /**
+   * @brief Verify the prefix summary against the stored data on @p scheduler, in small steps
+   *
+   * Counts found inconsistent are corrected, and afterPrefixCountChange is signaled with
+   * the applied differences.
+   */
+  void
+  startPrefixSummaryCheck(Scheduler& scheduler);
+
+  /**
+   * @brief Migrate data stored under an older schema version on @p scheduler, in small
+   *        steps, while they are served
+   * @sa Storage::migrate
+   */
+  void
+  startMigration(Scheduler& scheduler);
+
+  /**
+   * @brief Progress of the migration started by startMigration(), as of its last step; its
+   *        version is 0 when no migration is in progress
+   */
+  const Storage::MigrationProgress&
+  getMigrationProgress() const
+  {
+    return m_migrationProgress;
+  }
+
+  /**
+   * @brief Skip the storage for lookups of names that no stored data matches
+   * @param capacity expected number of stored data
+   * @param minPrefixLength Interest names shorter than this are always looked up in storage
+   * @sa LookupFilter
+   *
+   * The filter is built on @p scheduler from the stored data in small batches, and is used
+   * once it is complete. It is kept up to date as data are inserted and deleted.
+   */
+  void
+  enableLookupFilter(Scheduler& scheduler, uint64_t capacity, size_t minPrefixLength);
+
+  /**
+   * @brief Whether a lookup filter is complete and used for lookups
+   */
+  bool
+  isLookupFilterReady() const
+  {
+    return m_lookupFilter != nullptr && m_filterCursor == nullptr;
+  }
+
+  /**
+   * @brief Counters of the lookups checked against the lookup filter, reported in the
+   *        status dataset of the repo
+   */
+  const LookupFilterCounters&
+  getLookupFilterCounters() const
+  {
+    return m_lookupFilterCounters;
+  }
+
+  /**
+   * @brief Answer Interests with CanBePrefix with the last matching data, instead of the first
+   *
+   * The last data under an Interest name is its rightmost descendant, e.g., the latest
+   * version of an object whose versions are the next name component.
+   * @sa Storage::findLast
+   */
+  void
+  enableRightmostPrefixMatch(bool isEnabled)
+  {
+    m_isRightmostPrefixMatch = isEnabled;
+  }
+
   /**
    * @brief Notify about existing data
    *
+   * With a prefix summary, afterPrefixCountChange is signaled once for each registration
+   * prefix. Otherwise, afterDataInsertion is signaled for each stored data.
+   *
    * Note, this cannot be in constructor, as have to be called after signal is connected
    */
   void
   notifyAboutExistingData();
 
+  /**
+   * @brief Notify about existing data in small batches on @p scheduler
+   *
+   * Unlike notifyAboutExistingData(), this returns immediately, so that the repo can serve
+   * Interests while existing data are enumerated. Until the enumeration reaches them, data
+   * inserted or deleted meanwhile are not signaled, as the enumeration reports their state
+   * when it gets there.
+   *
+   * @param batchSize maximum number of data enumerated in one scheduler event
+   */
+  void
+  notifyAboutExistingDataIncrementally(Scheduler& scheduler, size_t batchSize = 10000);
+
+  /**
+   * @brief Whether the incremental enumeration of existing data is in progress
+   */
+  bool
+  isEnumeratingExistingData() const
+  {
+    return m_isScanning;
+  }
+
+  /**
+   * @brief Number of existing data notified about so far
+   */
+  uint64_t
+  getNEnumeratedExistingData() const
+  {
+    return m_nScannedData;
+  }
+
   /**
    *  @brief  insert data into repo
    */
   bool
   insertData(const Data& data);
 
+  /**
+   *  @brief  insert data into repo without waiting for the storage
+   *  @param  onDone  if not empty, called with true when the data is stored, or with false
+   *                  if the insertion failed
+   *  @sa     Storage::asyncInsert
+   */
+  void
+  insertData(const Data& data, const std::function<void(bool)>& onDone);
+
+  /**
+   *  @brief  insert a batch of data into repo
+   *
+   *  Pending group commit insertions are committed first. The batch is then inserted by
+   *  Storage::insertBatch() in one transaction, and afterDataBatchInsertion is signaled once
+   *  for the newly inserted data.
+   */
+  bool
+  insertData(ndn::span<const Data> batch);
+
+  /**
+   *  @brief  insert a batch of data into repo without waiting for the storage
+   *  @param  onDone  if not empty, called with true when the batch is stored, or with false
+   *                  if the insertion failed
+   *  @sa     Storage::asyncInsertBatch
+   */
+  void
+  insertData(ndn::span<const Data> batch, const std::function<void(bool)>& onDone);
+
   /**
    *  @brief   delete data from repo
    *  @param   name from interest, use it as a prefix to find entry needed to be erased in repo
@@ -66,6 +261,33 @@ public:
   ssize_t
   deleteData(const Name& name);
 
+  /**
+   *  @brief   delete data whose names start with @p name, without waiting for the storage
+   *  @param   onDone  called with the number of erased entries, or -1 if deletion fails
+   */
+  void
+  deleteData(const Name& name, const std::function<void(ssize_t)>& onDone);
+
+  /**
+   *  @brief   delete all data whose full names are in the range [@p begin, @p end)
+   *
+   *  Data are deleted in chunks by Storage::eraseRange(), and afterDataDeletion is signaled
+   *  for each deleted data.
+   *
+   *  @return  -1 if deletion fails, otherwise the number of erased entries
+   */
+  ssize_t
+  deleteRange(const Name& begin, const Name& end);
+
+  /**
+   *  @brief   delete all data whose full names are in the range [@p begin, @p end), without
+   *           waiting for the storage
+   *  @param   onDone  called with the number of erased entries, or -1 if deletion fails
+   *  @sa      Storage::asyncEraseRange
+   */
+  void
+  deleteRange(const Name& begin, const Name& end, const std::function<void(ssize_t)>& onDone);
+
   /**
    *  @brief   delete data from repo
    *  @param   interest used to find entry needed to be erased in repo
@@ -77,19 +299,193 @@ public:
 
   /**
    *  @brief   read data from repo
-   *  @param   interest  used to request data
+   *  @param   interest  used to request data, with its CanBePrefix and MustBeFresh
    *  @return  std::shared_ptr<Data>
+   *  @sa      Storage::findMatch
    */
   std::shared_ptr<Data>
   readData(const Interest& interest) const;
 
+  /**
+   *  @brief   read data from repo without blocking on the storage, if it supports concurrent reads
+   *  @param   onResult  called with the data, or nullptr if there is none
+   *  @sa      Storage::asyncFindMatch
+   */
+  void
+  readData(const Interest& interest, const Storage::FindCallback& onResult) const;
+
+private:
+  /**
+   * @brief Open the group commit transaction, if group commit is enabled and it is not open
+   *
+   * The transaction is opened without waiting for the storage.
+   *
+   * @return whether the insertion is part of a group commit
+   */
+  bool
+  prepareInsertion();
+
+  /**
+   * @brief Signal the insertions of the committed group commit transaction
+   */
+  void
+  afterCommit();
+
+  /**
+   * @brief Signal or record a stored insertion
+   */
+  void
+  afterInsertion(const Name& fullName, bool isGroupCommit);
+
+  /**
+   * @brief Signal the data inserted by a batch, whose full names are @p fullNames
+   */
+  void
+  afterBatchInsertion(const std::vector<Name>& fullNames, const std::vector<bool>& isInserted);
+
+  /**
+   * @brief Update the eviction policy and signal afterDataDeletion for erased data
+   */
+  void
+  afterErasure(const std::vector<Name>& fullNames);
+
+  bool
+  isOverCapacity(uint64_t nPackets, uint64_t nBytes) const;
+
+  /**
+   * @brief Schedule eviction if capacity limits are exceeded
+   *
+   * The usage is requested without waiting for the storage. While a request is outstanding,
+   * further checks are folded into one request made after it.
+   */
+  void
+  checkCapacity();
+
+  /**
+   * @brief Evict one batch of data, then reschedule if limits are still exceeded
+   *
+   * The policy examines at most one batch of stored data in each event, and continues
+   * in the next event.
+   */
+  void
+  evictBatch();
+
+  /**
+   * @brief Let the policy examine up to @p nVictims stored data, and evict those it selects
+   */
+  void
+  selectVictims(size_t nVictims);
+
+  void
+  eraseVictims(std::vector<Name> victims);
+
+  void
+  checkPrefixSummaryStep();
+
+  void
+  migrateStep();
+
+  /**
+   * @brief Read the next batch of existing data, then notify about it
+   */
+  void
+  scanBatch();
+
+  void
+  enumerateScanBatch();
+
+  /**
+   * @brief Read the next batch of stored data, then add it to the lookup filter
+   */
+  void
+  buildLookupFilterBatch();
+
+  void
+  addLookupFilterBatch();
+
+  /**
+   * @brief Whether the lookup filter contains, or is to contain, data named @p fullName
+   *
+   * False for data not reached yet by the enumeration that builds the filter.
+   */
+  bool
+  isInLookupFilter(const Name& fullName) const;
+
+  enum class FilterResult {
+    NOT_CHECKED,
+    NO_MATCH,
+    MAY_MATCH,
+  };
+
+  /**
+   * @brief Check @p name against the lookup filter, if it is ready
+   */
+  FilterResult
+  checkLookupFilter(const Name& name) const;
+
+  /**
+   * @brief Count the outcome of a lookup that the filter let through
+   */
+  void
+  countLookup(FilterResult result, bool isFound) const;
+
+  /**
+   * @brief Whether observers have been notified about data named @p fullName, or are
+   *        to be notified about changes to it
+   *
+   * False only for data not reached yet by the incremental enumeration of existing data.
+   */
+  bool
+  isEnumerated(const Name& fullName) const;
+
 public:
   ndn::signal::Signal<RepoStorage, ndn::Name> afterDataInsertion;
   ndn::signal::Signal<RepoStorage, ndn::Name> afterDataDeletion;
+  /// names of the data inserted by one batch; afterDataInsertion is not signaled for them
+  ndn::signal::Signal<RepoStorage, std::vector<ndn::Name>> afterDataBatchInsertion;
+  /// registration prefix and the change in the number of stored data under it
+  ndn::signal::Signal<RepoStorage, ndn::Name, int64_t> afterPrefixCountChange;
 
 private:
   Storage& m_storage;
-  static constexpr int NOTFOUND = -1;
+
+  Scheduler* m_scheduler = nullptr;
+  size_t m_groupCommitRows = 1;
+  time::milliseconds m_groupCommitDelay = 0_ms;
+  bool m_hasOpenTransaction = false;
+  bool m_hasFailedBegin = false; ///< the open group commit runs outside of a transaction
+  std::vector<Name> m_pendingInsertions; ///< full names
+  ndn::scheduler::ScopedEventId m_commitEvent;
+
+  uint64_t m_maxPackets = 0;
+  uint64_t m_maxBytes = 0;
+  std::unique_ptr<EvictionPolicy> m_evictionPolicy;
+  bool m_isEvictionScheduled = false; ///< whether a batch is scheduled, or being evicted
+  bool m_isUsageRequested = false;
+  bool m_isUsageCheckPending = false;
+  bool m_hasEvictionPassVictims = false; ///< whether the current pass of the policy selected data
+  int m_nIdleEvictionPasses = 0; ///< consecutive passes of the policy that selected no data
+  ndn::scheduler::ScopedEventId m_evictionEvent;
+
+  bool m_hasPrefixSummary = false;
+  ndn::scheduler::ScopedEventId m_prefixCheckEvent;
+  Storage::MigrationProgress m_migrationProgress;
+  uint64_t m_nMigrationSteps = 0;
+  ndn::scheduler::ScopedEventId m_migrationEvent;
+
+  bool m_isScanning = false;
+  size_t m_scanBatchSize = 0;
+  std::unique_ptr<Cursor> m_scanCursor;
+  uint64_t m_nScannedData = 0;
+  time::steady_clock::time_point m_scanStartTime;
+  ndn::scheduler::ScopedEventId m_scanEvent;
+
+  std::unique_ptr<LookupFilter> m_lookupFilter;
+  std::unique_ptr<Cursor> m_filterCursor; ///< enumeration building the filter, if in progress
+  ndn::scheduler::ScopedEventId m_filterBuildEvent;
+  mutable LookupFilterCounters m_lookupFilterCounters;
+
+  bool m_isRightmostPrefixMatch = false;
 };
 
 } // namespace repo
@@ -0,0 +1,712 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sharded-storage.hpp"
+#include "name-order.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <map>
+#include <numeric>
+#include <thread>
+
+namespace repo {
+
+NDN_LOG_INIT(repo.ShardedStorage);
+
+namespace {
+
+const char LAYOUT_FILE_NAME[] = "ndn_repo.shards";
+
+/// number of rows read from a shard at a time when enumerating in insertion order
+const size_t INSERTION_ORDER_PAGE_SIZE = 1000;
+
+bool
+isFullName(const Name& name)
+{
+  return !name.empty() && name[-1].isImplicitSha256Digest();
+}
+
+/**
+ * @brief 64-bit FNV-1a, which does not depend on the platform or the standard library
+ */
+uint64_t
+hashBytes(ndn::span<const uint8_t> bytes)
+{
+  uint64_t hash = 0xcbf29ce484222325;
+  for (uint8_t byte : bytes) {
+    hash ^= byte;
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+} // namespace
+
+/**
+ * @brief Thread that runs the operations of one shard submitted by runOnShards()
+ */
+class ShardedStorage::ShardThread : boost::noncopyable
+{
+public:
+  ShardThread()
+    : m_workGuard(boost::asio::make_work_guard(m_ctx))
+    , m_thread([this] { m_ctx.run(); })
+  {
+  }
+
+  ~ShardThread()
+  {
+    m_workGuard.reset();
+    m_thread.join();
+  }
+
+  std::future<void>
+  run(std::function<void()> f)
+  {
+    std::packaged_task<void()> task(std::move(f));
+    auto result = task.get_future();
+    boost::asio::post(m_ctx, std::move(task));
+    return result;
+  }
+
+private:
+  boost::asio::io_context m_ctx;
+  boost::asio::executor_work_guard<boost::asio::io_context::executor_type> m_workGuard;
+  std::thread m_thread;
+};
+
+ShardedStorage::ShardedStorage(const std::string& dirPath, size_t nShards, size_t prefixLength)
+  : m_prefixLength(prefixLength)
+{
+  if (nShards == 0) {
+    NDN_THROW(Error("The number of shards must be positive"));
+  }
+  if (prefixLength == 0) {
+    NDN_THROW(Error("The shard prefix length must be positive"));
+  }
+
+  std::error_code ec;
+  std::filesystem::create_directories(dirPath, ec);
+  checkLayout(dirPath, nShards);
+
+  for (size_t i = 0; i < nShards; ++i) {
+    auto shardPath = std::filesystem::path(dirPath) / ("shard-" + std::to_string(i));
+    m_shards.push_back(std::make_unique<SqliteStorage>(shardPath.string()));
+  }
+  m_hasShardTransaction.resize(nShards, false);
+  if (nShards > 1) {
+    for (size_t i = 0; i < nShards; ++i) {
+      m_threads.push_back(std::make_unique<ShardThread>());
+    }
+  }
+  NDN_LOG_DEBUG("Using " << nShards << " shards in " << dirPath <<
+                " routed by the first " << prefixLength << " name components");
+}
+
+ShardedStorage::~ShardedStorage() = default;
+
+template<typename Function>
+void
+ShardedStorage::runOnShards(const std::vector<size_t>& shards, Function&& f)
+{
+  if (shards.size() == 1) {
+    f(shards.front());
+    return;
+  }
+
+  // the caller waits for all calls, so the shards are never used by two threads at once
+  std::vector<std::future<void>> results;
+  results.reserve(shards.size());
+  for (size_t shard : shards) {
+    results.push_back(m_threads[shard]->run([&f, shard] { f(shard); }));
+  }
+  std::exception_ptr error;
+  for (auto& result : results) {
+    try {
+      result.get();
+    }
+    catch (...) {
+      if (error == nullptr) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+template<typename Function>
+void
+ShardedStorage::runOnAllShards(Function&& f)
+{
+  std::vector<size_t> shards(m_shards.size());
+  std::iota(shards.begin(), shards.end(), 0);
+  runOnShards(shards, std::forward<Function>(f));
+}
+
+void
+ShardedStorage::prepareModification(size_t shard)
+{
+  if (m_isInTransaction && !m_hasShardTransaction[shard]) {
+    m_shards[shard]->beginTransaction();
+    m_hasShardTransaction[shard] = true;
+  }
+}
+
+std::optional<ShardedStorage::Layout>
+ShardedStorage::readLayout(const std::string& dirPath)
+{
+  Layout layout{0, 0};
+  std::ifstream is(std::filesystem::path(dirPath) / LAYOUT_FILE_NAME);
+  if (!(is >> layout.nShards >> layout.prefixLength)) {
+    return std::nullopt;
+  }
+  return layout;
+}
+
+void
+ShardedStorage::checkLayout(const std::string& dirPath, size_t nShards) const
+{
+  auto stored = readLayout(dirPath);
+  if (stored) {
+    if (stored->nShards != nShards || stored->prefixLength != m_prefixLength) {
+      NDN_THROW(Error("Storage in " + dirPath + " has " + std::to_string(stored->nShards) +
+                      " shards with prefix length " + std::to_string(stored->prefixLength) +
+                      ", use repo-ng-reshard to change the layout"));
+    }
+    return;
+  }
+
+  auto layoutPath = std::filesystem::path(dirPath) / LAYOUT_FILE_NAME;
+  std::ofstream os(layoutPath, std::ios::trunc);
+  os << nShards << ' ' << m_prefixLength << '\n';
+  if (!os) {
+    NDN_THROW(Error("Cannot write shard layout file " + layoutPath.string()));
+  }
+}
+
+size_t
+ShardedStorage::getShardIndex(const Name& dataName) const
+{
+  // getPrefix() returns the whole name if it has fewer components
+  auto prefix = dataName.getPrefix(static_cast<ssize_t>(m_prefixLength));
+  return hashBytes(prefix.wireEncode().value_bytes()) % m_shards.size();
+}
+
+std::optional<size_t>
+ShardedStorage::routeLookup(const Name& name) const
+{
+  if (m_shards.size() == 1) {
+    return 0;
+  }
+  if (isFullName(name)) {
+    return getShardIndex(name.getPrefix(-1));
+  }
+  if (name.size() >= m_prefixLength) {
+    return getShardIndex(name);
+  }
+  // a shorter name can be the name of Data in one shard, or a prefix of names in all shards
+  return std::nullopt;
+}
+
+int64_t
+ShardedStorage::insert(const Data& data)
+{
+  size_t shard = getShardIndex(data.getName());
+  prepareModification(shard);
+  return m_shards[shard]->insert(data);
+}
+
+bool
+ShardedStorage::insertIfAbsent(const Data& data)
+{
+  size_t shard = getShardIndex(data.getName());
+  prepareModification(shard);
+  return m_shards[shard]->insertIfAbsent(data);
+}
+
+std::vector<bool>
+ShardedStorage::insertBatch(ndn::span<const Data> batch)
+{
+  std::vector<std::vector<size_t>> indices(m_shards.size());
+  for (size_t i = 0; i < batch.size(); ++i) {
+    indices[getShardIndex(batch[i].getName())].push_back(i);
+  }
+
+  std::vector<size_t> shards;
+  for (size_t shard = 0; shard < m_shards.size(); ++shard) {
+    if (!indices[shard].empty()) {
+      shards.push_back(shard);
+    }
+  }
+
+  std::vector<std::vector<bool>> isPartInserted(m_shards.size());
+  runOnShards(shards, [&] (size_t shard) {
+    std::vector<Data> part;
+    part.reserve(indices[shard].size());
+    for (size_t i : indices[shard]) {
+      part.push_back(batch[i]);
+    }
+    prepareModification(shard);
+    isPartInserted[shard] = m_shards[shard]->insertBatch(part);
+  });
+
+  std::vector<bool> isInserted(batch.size(), false);
+  for (size_t shard : shards) {
+    for (size_t j = 0; j < indices[shard].size(); ++j) {
+      isInserted[indices[shard][j]] = isPartInserted[shard][j];
+    }
+  }
+  return isInserted;
+}
+
+bool
+ShardedStorage::erase(const Name& name)
+{
+  auto shard = routeLookup(name);
+  if (shard) {
+    prepareModification(*shard);
+    return m_shards[*shard]->erase(name);
+  }
+
+  bool isErased = false;
+  for (size_t i = 0; i < m_shards.size(); ++i) {
+    if (m_shards[i]->has(name)) {
+      prepareModification(i);
+      isErased = m_shards[i]->erase(name) || isErased;
+    }
+  }
+  return isErased;
+}
+
+uint64_t
+ShardedStorage::eraseRange(const Name& begin, const Name& end,
+                           const std::function<void(const std::vector<Name>&)>& onChunk)
+{
+  // the shards are taken one after another, so that onChunk is called on the caller's thread;
+  // only the shards with Data in the range are modified
+  uint64_t nErased = 0;
+  for (size_t i = 0; i < m_shards.size(); ++i) {
+    bool hasData = m_shards[i]->scan({begin, true, end}, 1, false, [] (const Name&, auto&&) {}) > 0;
+    if (hasData) {
+      prepareModification(i);
+      nErased += m_shards[i]->eraseRange(begin, end, onChunk);
+    }
+  }
+  return nErased;
+}
+
+std::shared_ptr<Data>
+ShardedStorage::read(const Name& name)
+{
+  return find(name);
+}
+
+bool
+ShardedStorage::has(const Name& name)
+{
+  auto shard = routeLookup(name);
+  if (shard) {
+    return m_shards[*shard]->has(name);
+  }
+
+  std::vector<char> hasName(m_shards.size(), false);
+  runOnAllShards([&] (size_t i) { hasName[i] = m_shards[i]->has(name); });
+  return std::find(hasName.begin(), hasName.end(), true) != hasName.end();
+}
+
+std::shared_ptr<Data>
+ShardedStorage::find(const Name& name, bool exactMatch)
+{
+  auto shard = routeLookup(name);
+  if (shard) {
+    return m_shards[*shard]->find(name, exactMatch);
+  }
+
+  // each shard returns its first match in name order, and the first of them is the result
+  std::vector<std::shared_ptr<Data>> matches(m_shards.size());
+  runOnAllShards([&] (size_t i) { matches[i] = m_shards[i]->find(name, exactMatch); });
+  std::shared_ptr<Data> found;
+  for (auto& data : matches) {
+    if (data != nullptr &&
+        (found == nullptr || isEncodedLess(data->getFullName(), found->getFullName()))) {
+      found = std::move(data);
+    }
+  }
+  return found;
+}
+
+void
+ShardedStorage::asyncFind(const Name& name, bool exactMatch, const FindCallback& onResult)
+{
+  auto shard = routeLookup(name);
+  if (shard) {
+    m_shards[*shard]->asyncFind(name, exactMatch, onResult);
+    return;
+  }
+  Storage::asyncFind(name, exactMatch, onResult);
+}
+
+std::shared_ptr<Data>
+ShardedStorage::findLast(const Name& prefix)
+{
+  auto shard = routeLookup(prefix);
+  if (shard) {
+    return m_shards[*shard]->findLast(prefix);
+  }
+
+  // each shard returns its last match in name order, and the last of them is the result
+  std::vector<std::shared_ptr<Data>> matches(m_shards.size());
+  runOnAllShards([&] (size_t i) { matches[i] = m_shards[i]->findLast(prefix); });
+  std::shared_ptr<Data> found;
+  for (auto& data : matches) {
+    if (data != nullptr &&
+        (found == nullptr || isEncodedLess(found->getFullName(), data->getFullName()))) {
+      found = std::move(data);
+    }
+  }
+  return found;
+}
+
+void
+ShardedStorage::asyncFindLast(const Name& prefix, const FindCallback& onResult)
+{
+  auto shard = routeLookup(prefix);
+  if (shard) {
+    m_shards[*shard]->asyncFindLast(prefix, onResult);
+    return;
+  }
+  Storage::asyncFindLast(prefix, onResult);
+}
+
+std::shared_ptr<Data>
+ShardedStorage::findMatch(const Interest& interest, bool isRightmost)
+{
+  auto shard = routeLookup(interest.getName());
+  if (shard) {
+    return m_shards[*shard]->findMatch(interest, isRightmost);
+  }
+
+  // the first or last of the matches of the shards, in name order
+  bool isLast = isRightmost && interest.getCanBePrefix();
+  std::vector<std::shared_ptr<Data>> matches(m_shards.size());
+  runOnAllShards([&] (size_t i) { matches[i] = m_shards[i]->findMatch(interest, isRightmost); });
+  std::shared_ptr<Data> found;
+  for (auto& data : matches) {
+    if (data != nullptr &&
+        (found == nullptr || (isLast ? isEncodedLess(found->getFullName(), data->getFullName()) :
+                                       isEncodedLess(data->getFullName(), found->getFullName())))) {
+      found = std::move(data);
+    }
+  }
+  return found;
+}
+
+void
+ShardedStorage::asyncFindMatch(const Interest& interest, bool isRightmost, const FindCallback& onResult)
+{
+  auto shard = routeLookup(interest.getName());
+  if (shard) {
+    m_shards[*shard]->asyncFindMatch(interest, isRightmost, onResult);
+    return;
+  }
+  Storage::asyncFindMatch(interest, isRightmost, onResult);
+}
+
+bool
+ShardedStorage::enableConcurrentReads(boost::asio::io_context& ioCtx, size_t nThreads)
+{
+  size_t nThreadsPerShard = std::max<size_t>(1, nThreads / m_shards.size());
+  bool isEnabled = true;
+  for (auto& storage : m_shards) {
+    isEnabled = storage->enableConcurrentReads(ioCtx, nThreadsPerShard) && isEnabled;
+  }
+  return isEnabled;
+}
+
+bool
+ShardedStorage::enableNameIndex(size_t maxBytes)
+{
+  bool isEnabled = true;
+  for (auto& storage : m_shards) {
+    isEnabled = storage->enableNameIndex(maxBytes / m_shards.size()) && isEnabled;
+  }
+  return isEnabled;
+}
+
+void
+ShardedStorage::forEachInInsertionOrder(const std::function<bool(const Name&)>& f)
+{
+  InsertionOrderPosition position;
+  mergeInInsertionOrder(position, INSERTION_ORDER_PAGE_SIZE, f);
+}
+
+std::vector<Name>
+ShardedStorage::nextInInsertionOrder(InsertionOrderPosition& position, size_t limit)
+{
+  std::vector<Name> names;
+  if (limit == 0)
+    return names;
+
+  mergeInInsertionOrder(position, std::min(limit, INSERTION_ORDER_PAGE_SIZE),
+                        [&] (const Name& fullName) {
+                          names.push_back(fullName);
+                          return names.size() < limit;
+                        });
+  return names;
+}
+
+void
+ShardedStorage::mergeInInsertionOrder(InsertionOrderPosition& position, size_t pageSize,
+                                      const std::function<bool(const Name&)>& f)
+{
+  // Each shard lists its rows in insertion order, one page at a time, and the shards are
+  // merged by insertion time. Rows stored before insertion times were recorded come first,
+  // and rows inserted within the same millisecond are taken from the lower shard first.
+  struct Page
+  {
+    std::vector<SqliteStorage::InsertionOrderEntry> entries;
+    size_t next = 0;
+    bool isLast = false;
+  };
+  std::vector<Page> pages(m_shards.size());
+  // the last row of each shard, by rowid
+  auto& lastRowids = position.sequences;
+  lastRowids.resize(m_shards.size(), 0);
+  auto getHead = [&] (size_t shard) -> const SqliteStorage::InsertionOrderEntry* {
+    auto& page = pages[shard];
+    if (page.next == page.entries.size()) {
+      if (page.isLast) {
+        return nullptr;
+      }
+      page.entries = m_shards[shard]->listInInsertionOrder(static_cast<int64_t>(lastRowids[shard]),
+                                                           pageSize);
+      page.next = 0;
+      page.isLast = page.entries.size() < pageSize;
+      if (page.entries.empty()) {
+        return nullptr;
+      }
+    }
+    return &page.entries[page.next];
+  };
+
+  while (true) {
+    size_t oldest = 0;
+    const SqliteStorage::InsertionOrderEntry* oldestEntry = nullptr;
+    for (size_t i = 0; i < m_shards.size(); ++i) {
+      const auto* head = getHead(i);
+      if (head != nullptr && (oldestEntry == nullptr || head->insertTime < oldestEntry->insertTime)) {
+        oldest = i;
+        oldestEntry = head;
+      }
+    }
+    if (oldestEntry == nullptr) {
+      return;
+    }
+
+    ++pages[oldest].next;
+    lastRowids[oldest] = static_cast<uint64_t>(oldestEntry->rowid);
+    if (!oldestEntry->fullName.empty() && !f(oldestEntry->fullName)) {
+      return;
+    }
+  }
+}
+
+size_t
+ShardedStorage::scan(const Range& range, size_t limit, bool withData, const ScanCallback& f)
+{
+  if (m_shards.size() == 1) {
+    return m_shards.front()->scan(range, limit, withData, f);
+  }
+
+  // The first names in the range are among the first names of each shard. The Data are
+  // read afterwards, only for the names that are enumerated.
+  std::vector<std::vector<Name>> shardNames(m_shards.size());
+  runOnAllShards([&] (size_t i) {
+    m_shards[i]->scan(range, limit, false, [&] (const Name& name, auto&&) {
+      shardNames[i].push_back(name);
+    });
+  });
+  std::vector<std::pair<Name, size_t>> names;
+  for (size_t i = 0; i < m_shards.size(); ++i) {
+    for (auto& name : shardNames[i]) {
+      names.emplace_back(std::move(name), i);
+    }
+  }
+
+  size_t nEnumerated = std::min(limit, names.size());
+  std::partial_sort(names.begin(), names.begin() + nEnumerated, names.end(),
+                    [] (const auto& a, const auto& b) { return isEncodedLess(a.first, b.first); });
+  for (size_t i = 0; i < nEnumerated; ++i) {
+    const auto& [name, shard] = names[i];
+    f(name, withData ? m_shards[shard]->find(name, true) : nullptr);
+  }
+  return nEnumerated;
+}
+
+uint64_t
+ShardedStorage::size()
+{
+  uint64_t nEntries = 0;
+  for (auto& storage : m_shards) {
+    nEntries += storage->size();
+  }
+  return nEntries;
+}
+
+uint64_t
+ShardedStorage::bytes()
+{
+  uint64_t nBytes = 0;
+  for (auto& storage : m_shards) {
+    nBytes += storage->bytes();
+  }
+  return nBytes;
+}
+
+bool
+ShardedStorage::enablePrefixSummary(size_t nSuffixComponents)
+{
+  bool isEnabled = true;
+  for (auto& storage : m_shards) {
+    isEnabled = storage->enablePrefixSummary(nSuffixComponents) && isEnabled;
+  }
+  return isEnabled;
+}
+
+void
+ShardedStorage::forEachPrefixCount(const std::function<void(const Name& prefix, uint64_t count)>& f)
+{
+  // a registration prefix shorter than the shard prefix can have Data in several shards
+  std::map<Name, uint64_t> counts;
+  for (auto& storage : m_shards) {
+    storage->forEachPrefixCount([&] (const Name& prefix, uint64_t count) {
+      counts[prefix] += count;
+    });
+  }
+  for (const auto& [prefix, count] : counts) {
+    f(prefix, count);
+  }
+}
+
+bool
+ShardedStorage::checkPrefixSummary(size_t nEntries,
+                                   const std::function<void(const Name&, int64_t)>& onCorrection)
+{
+  // the shards are checked one after another; corrections of a prefix in several shards add up
+  if (m_shards[m_prefixCheckShard]->checkPrefixSummary(nEntries, onCorrection)) {
+    return true;
+  }
+  if (++m_prefixCheckShard < m_shards.size()) {
+    return true;
+  }
+  m_prefixCheckShard = 0;
+  return false;
+}
+
+bool
+ShardedStorage::migrate(size_t nEntries)
+{
+  // the shards are migrated one after another
+  if (m_shards[m_migrationShard]->migrate(nEntries)) {
+    return true;
+  }
+  if (++m_migrationShard < m_shards.size()) {
+    return true;
+  }
+  m_migrationShard = 0;
+  return false;
+}
+
+Storage::MigrationProgress
+ShardedStorage::getMigrationProgress()
+{
+  // shards whose migration completed no longer count
+  MigrationProgress progress;
+  for (auto& storage : m_shards) {
+    auto shardProgress = storage->getMigrationProgress();
+    progress.version = std::max(progress.version, shardProgress.version);
+    progress.nMigrated += shardProgress.nMigrated;
+    progress.nEntries += shardProgress.nEntries;
+  }
+  return progress;
+}
+
+void
+ShardedStorage::beginTransaction()
+{
+  m_isInTransaction = true;
+}
+
+void
+ShardedStorage::commitTransaction()
+{
+  m_isInTransaction = false;
+  std::vector<size_t> shards;
+  for (size_t i = 0; i < m_shards.size(); ++i) {
+    if (m_hasShardTransaction[i]) {
+      shards.push_back(i);
+    }
+  }
+
+  // a shard that fails to commit is rolled back, so that it is left without a transaction
+  std::vector<char> isFailed(m_shards.size(), false);
+  try {
+    runOnShards(shards, [&] (size_t i) {
+      m_hasShardTransaction[i] = false;
+      try {
+        m_shards[i]->commitTransaction();
+      }
+      catch (const Error&) {
+        isFailed[i] = true;
+        m_shards[i]->rollbackTransaction();
+        throw;
+      }
+    });
+  }
+  catch (const Error& e) {
+    auto nFailed = std::count(isFailed.begin(), isFailed.end(), true);
+    NDN_THROW(Error(std::to_string(nFailed) + " of " + std::to_string(shards.size()) +
+                    " shards failed to commit: " + e.what()));
+  }
+}
+
+void
+ShardedStorage::rollbackTransaction()
+{
+  m_isInTransaction = false;
+  for (size_t i = 0; i < m_shards.size(); ++i) {
+    if (m_hasShardTransaction[i]) {
+      m_hasShardTransaction[i] = false;
+      m_shards[i]->rollbackTransaction();
+    }
+  }
+}
+
+} // namespace repo
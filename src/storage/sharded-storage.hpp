@@ -0,0 +1,268 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_STORAGE_SHARDED_STORAGE_HPP
+#define REPO_STORAGE_SHARDED_STORAGE_HPP
+
+#include "sqlite-storage.hpp"
+
+#include <optional>
+
+namespace repo {
+
+/**
+ * @brief Storage that distributes Data across several SQLite databases
+ *
+ * Data are routed to a shard by a stable hash of the first @c prefixLength components of
+ * their names, so all Data under such a prefix are in the same database. Each shard is
+ * a SqliteStorage in its own subdirectory, with its own write-ahead log.
+ *
+ * Lookups of names with fewer components than the prefix length query every shard, and
+ * return the first match in name order across them. Enumerations in name order are merged
+ * across shards, and so is enumeration in insertion order, by the insertion time recorded
+ * with each row, to the millisecond.
+ *
+ * Operations that involve several shards, such as batch insertions, commits, and lookups
+ * that are not routed to a single shard, run on a thread per shard, in parallel, and the
+ * caller waits for all of them. Operations on a single shard run on the caller's thread.
+ *
+ * The layout is recorded in the storage directory, and opening it with a different layout
+ * fails; use repo-ng-reshard to change the layout of an existing storage.
+ */
+class ShardedStorage : public Storage
+{
+public:
+  struct Layout
+  {
+    size_t nShards;
+    size_t prefixLength;
+  };
+
+public:
+  ShardedStorage(const std::string& dirPath, size_t nShards, size_t prefixLength);
+
+  ~ShardedStorage() override;
+
+  /**
+   * @brief Read the layout recorded in @p dirPath
+   * @return the layout, or nullopt if @p dirPath does not contain a sharded storage
+   */
+  static std::optional<Layout>
+  readLayout(const std::string& dirPath);
+
+  int64_t
+  insert(const Data& data) override;
+
+  bool
+  insertIfAbsent(const Data& data) override;
+
+  /**
+   *  @brief  split the batch by shard, and insert the parts in parallel, each with one call
+   *
+   *  Each part is inserted atomically, but not the batch as a whole.
+   */
+  std::vector<bool>
+  insertBatch(ndn::span<const Data> batch) override;
+
+  bool
+  erase(const Name& name) override;
+
+  uint64_t
+  eraseRange(const Name& begin, const Name& end,
+             const std::function<void(const std::vector<Name>&)>& onChunk) override;
+
+  std::shared_ptr<Data>
+  read(const Name& name) override;
+
+  bool
+  has(const Name& name) override;
+
+  std::shared_ptr<Data>
+  find(const Name& name, bool exactMatch = false) override;
+
+  /**
+   * @brief Look up asynchronously in the shard a lookup is routed to, if there is one,
+   *        or synchronously in all shards
+   */
+  void
+  asyncFind(const Name& name, bool exactMatch, const FindCallback& onResult) override;
+
+  std::shared_ptr<Data>
+  findLast(const Name& prefix) override;
+
+  /**
+   * @brief Look up asynchronously in the shard a lookup is routed to, if there is one,
+   *        or synchronously in all shards
+   */
+  void
+  asyncFindLast(const Name& prefix, const FindCallback& onResult) override;
+
+  std::shared_ptr<Data>
+  findMatch(const Interest& interest, bool isRightmost = false) override;
+
+  /**
+   * @brief Look up asynchronously in the shard a lookup is routed to, if there is one,
+   *        or synchronously in all shards
+   */
+  void
+  asyncFindMatch(const Interest& interest, bool isRightmost, const FindCallback& onResult) override;
+
+  /**
+   * @brief Divide @p maxBytes evenly among the shards, each indexing its own names
+   */
+  bool
+  enableNameIndex(size_t maxBytes) override;
+
+  /**
+   * @brief Divide @p nThreads readers among the shards, with at least one reader per shard
+   * @return whether all shards enabled concurrent reads
+   */
+  bool
+  enableConcurrentReads(boost::asio::io_context& ioCtx, size_t nThreads) override;
+
+  /**
+   * @brief Merge the shards, each enumerated in insertion order, by insertion time
+   */
+  void
+  forEachInInsertionOrder(const std::function<bool(const Name&)>& f) override;
+
+  /**
+   * @brief Merge the shards by insertion time as forEachInInsertionOrder() does; @p position
+   *        holds the last listed row of each shard
+   */
+  std::vector<Name>
+  nextInInsertionOrder(InsertionOrderPosition& position, size_t limit) override;
+
+  /**
+   *  @brief  merge the first entries of each shard in the range
+   */
+  size_t
+  scan(const Range& range, size_t limit, bool withData, const ScanCallback& f) override;
+
+  uint64_t
+  size() override;
+
+  uint64_t
+  bytes() override;
+
+  bool
+  enablePrefixSummary(size_t nSuffixComponents) override;
+
+  void
+  forEachPrefixCount(const std::function<void(const Name& prefix, uint64_t count)>& f) override;
+
+  bool
+  checkPrefixSummary(size_t nEntries,
+                     const std::function<void(const Name&, int64_t)>& onCorrection) override;
+
+  bool
+  migrate(size_t nEntries) override;
+
+  MigrationProgress
+  getMigrationProgress() override;
+
+  /**
+   * @brief Start a transaction, which begins in each shard when the shard is first modified
+   */
+  void
+  beginTransaction() override;
+
+  /**
+   * @brief Commit the modified shards in parallel
+   *
+   * Each shard commits on its own: if some shards fail to commit, they are rolled back and
+   * Error is thrown, while the other shards stay committed.
+   */
+  void
+  commitTransaction() override;
+
+  void
+  rollbackTransaction() override;
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /**
+   * @brief Get the shard that holds Data named @p dataName (without implicit digest)
+   */
+  size_t
+  getShardIndex(const Name& dataName) const;
+
+  /**
+   * @brief Get the only shard that can hold Data matching @p name, if there is one
+   * @param name a name, or a full name
+   */
+  std::optional<size_t>
+  routeLookup(const Name& name) const;
+
+private:
+  /**
+   * @brief Check the layout recorded in the storage directory, or record it
+   * @throw Error the storage was created with a different layout
+   */
+  void
+  checkLayout(const std::string& dirPath, size_t nShards) const;
+
+  /**
+   * @brief Begin the transaction of @p shard before its first modification in a transaction
+   */
+  void
+  prepareModification(size_t shard);
+
+  /**
+   * @brief Call @p f with each shard index of @p shards, on the thread of the shard, and wait
+   *        for all calls to complete
+   * @throw the exception thrown by the call of the lowest shard, if any
+   */
+  template<typename Function>
+  void
+  runOnShards(const std::vector<size_t>& shards, Function&& f);
+
+  /**
+   * @brief Call runOnShards() with all shards
+   */
+  template<typename Function>
+  void
+  runOnAllShards(Function&& f);
+
+  /**
+   * @brief Merge the shards by insertion time, after the rows recorded in @p position
+   *
+   * Each shard is read @p pageSize rows at a time. @p position is moved past each row before
+   * @p f is called with it; the merge stops when @p f returns false.
+   */
+  void
+  mergeInInsertionOrder(InsertionOrderPosition& position, size_t pageSize,
+                        const std::function<bool(const Name&)>& f);
+
+private:
+  class ShardThread;
+
+  std::vector<std::unique_ptr<SqliteStorage>> m_shards;
+  /// one per shard, if there are several shards; destroyed before the shards
+  std::vector<std::unique_ptr<ShardThread>> m_threads;
+  size_t m_prefixLength;
+  size_t m_prefixCheckShard = 0;
+  size_t m_migrationShard = 0;
+  bool m_isInTransaction = false;
+  /// whether each shard began the transaction; not vector<bool>, as shard threads set their own
+  std::vector<char> m_hasShardTransaction;
+};
+
+} // namespace repo
+
+#endif // REPO_STORAGE_SHARDED_STORAGE_HPP
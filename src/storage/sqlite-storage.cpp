@@ -18,144 +18,247 @@
  */
 
 #include "sqlite-storage.hpp"
+#include "cursor.hpp"
+#include "name-order.hpp"
 
+#include <ndn-cxx/encoding/block-helpers.hpp>
 #include <ndn-cxx/util/logger.hpp>
 #include <ndn-cxx/util/sha256.hpp>
 #include <ndn-cxx/util/sqlite3-statement.hpp>
 
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
+#include <mutex>
+#include <thread>
 
 namespace repo {
 
 NDN_LOG_INIT(repo.SqliteStorage);
 
-SqliteStorage::SqliteStorage(const std::string& dbPath)
+namespace {
+
+const int ERASE_RANGE_CHUNK_SIZE = 1000;
+/// number of names looked up by one query of SqliteStorage::insertBatch, within SQLite's
+/// default limit on the number of statement parameters
+const size_t STORED_CHECK_CHUNK_SIZE = 500;
+
+/**
+ * @brief Resets a cached statement and clears its bindings when going out of scope
+ *
+ * Resetting promptly also ends the implicit read transaction held by an unfinished SELECT.
+ */
+class StatementGuard : noncopyable
 {
-  if (dbPath.empty()) {
-    m_dbPath = "ndn_repo.db";
+public:
+  explicit
+  StatementGuard(ndn::util::Sqlite3Statement& stmt)
+    : m_stmt(stmt)
+  {
   }
-  else {
-    std::filesystem::path fsPath(dbPath);
-    if (!std::filesystem::is_directory(fsPath)) {
-      if (!std::filesystem::create_directory(fsPath)) {
-        NDN_THROW(Error("Directory '" + dbPath + "' does not exists and cannot be created"));
-      }
-    }
-    m_dbPath = dbPath + "/ndn_repo.db";
+
+  ~StatementGuard()
+  {
+    sqlite3_reset(m_stmt);
+    sqlite3_clear_bindings(m_stmt);
   }
 
-  NDN_LOG_DEBUG("Using database file " << m_dbPath);
-  initializeRepo();
-}
+private:
+  ndn::util::Sqlite3Statement& m_stmt;
+};
 
-void
-SqliteStorage::initializeRepo()
+/**
+ * @brief Decode a Name from a column holding the TLV-VALUE of the Name
+ */
+Name
+getName(ndn::util::Sqlite3Statement& stmt, int column)
 {
-  char* errMsg = nullptr;
-  int rc = sqlite3_open_v2(m_dbPath.c_str(), &m_db,
-                           SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
-#ifdef DISABLE_SQLITE3_FS_LOCKING
-                           "unix-dotfile"
-#else
-                           nullptr
-#endif
-                          );
+  return Name(ndn::encoding::makeBinaryBlock(ndn::tlv::Name,
+                                             ndn::make_span(stmt.getBlob(column),
+                                                            static_cast<size_t>(stmt.getSize(column)))));
+}
 
-  if (rc == SQLITE_OK) {
-    // Create a new table named NDN_REPO_V2, distinguish from the old table name(NDN_REPO)
-    sqlite3_exec(m_db, "CREATE TABLE NDN_REPO_V2 (name BLOB, data BLOB);", nullptr, nullptr, &errMsg);
-    // Ignore errors (when database already exists, errors are expected)
-    sqlite3_exec(m_db, "CREATE UNIQUE INDEX index_name ON NDN_REPO_V2 (name);", nullptr, nullptr, &errMsg);
-  }
-  else {
-    NDN_LOG_DEBUG("Database file open failure rc:" << rc);
-    NDN_THROW(Error("Database file open failure"));
+/**
+ * @brief Decode the Name of the Data from a column holding the TLV-VALUE of its full name
+ *
+ * The implicit digest is always the last, fixed-size component of the full name,
+ * so it is cut off before decoding instead of being decoded and dropped.
+ */
+Name
+getNameWithoutDigest(ndn::util::Sqlite3Statement& stmt, int column)
+{
+  const size_t digestTlvSize = 2 + ndn::util::Sha256::DIGEST_SIZE;
+  auto value = ndn::make_span(stmt.getBlob(column), static_cast<size_t>(stmt.getSize(column)));
+  if (value.size() < digestTlvSize ||
+      value[value.size() - digestTlvSize] != ndn::tlv::ImplicitSha256DigestComponent ||
+      value[value.size() - digestTlvSize + 1] != ndn::util::Sha256::DIGEST_SIZE) {
+    return getName(stmt, column).getPrefix(-1);
   }
-
-  // SQLite continues without syncing as soon as it has handed data off to the operating system
-  sqlite3_exec(m_db, "PRAGMA synchronous = OFF;", nullptr, nullptr, &errMsg);
-  // Uses a write-ahead log instead of a rollback journal to implement transactions.
-  sqlite3_exec(m_db, "PRAGMA journal_mode = WAL;", nullptr, nullptr, &errMsg);
+  return Name(ndn::encoding::makeBinaryBlock(ndn::tlv::Name,
+                                             value.first(value.size() - digestTlvSize)));
 }
 
-SqliteStorage::~SqliteStorage()
+const char FIND_EXACT_SQL[] = "SELECT name, data FROM NDN_REPO_V2 WHERE name = ?;";
+const char FIND_PREFIX_SQL[] = "SELECT name, data FROM NDN_REPO_V2 WHERE name >= ? and name < ?;";
+// a descending scan of the index on the name column, which stops at the first row
+const char FIND_LAST_SQL[] = "SELECT name, data FROM NDN_REPO_V2 WHERE name >= ? and name < ? "
+                             "ORDER BY name DESC LIMIT 1;";
+// the range is scanned on the index on the name column, and the fresh_until column of each
+// row is checked as it is visited, so stale rows are skipped without decoding them, and
+// only the row returned is decoded
+const char FIND_FRESH_SQL[] = "SELECT name, data FROM NDN_REPO_V2 "
+                              "WHERE name >= ? and name < ? AND fresh_until > ? ORDER BY name LIMIT 1;";
+const char FIND_LAST_FRESH_SQL[] = "SELECT name, data FROM NDN_REPO_V2 "
+                                   "WHERE name >= ? and name < ? AND fresh_until > ? "
+                                   "ORDER BY name DESC LIMIT 1;";
+
+/**
+ * @brief Kind of lookup served by the ReaderPool
+ */
+enum class Lookup {
+  EXACT,
+  FIRST,
+  LAST,
+  MATCH,
+};
+
+/**
+ * @brief Version of the schema, stored in PRAGMA user_version
+ *
+ * 0: NDN_REPO_V2 (name, data), as created before the schema was versioned
+ * 1: metadata columns, see METADATA_COLUMNS
+ */
+const int SCHEMA_VERSION = 1;
+
+/**
+ * @brief Metadata columns of NDN_REPO_V2, filled at insertion so that policies can filter
+ *        on them without decoding the data column
+ */
+const std::pair<const char*, const char*> METADATA_COLUMNS[] = {
+  {"size", "INTEGER"},             // size of the Data packet in bytes
+  {"content_type", "INTEGER"},
+  {"freshness_period", "INTEGER"}, // milliseconds
+  {"signer", "BLOB"},              // TLV-VALUE of the KeyLocator name, NULL without one
+  {"insert_time", "INTEGER"},      // milliseconds since the Unix epoch, NULL if unknown
+  {"fresh_until", "INTEGER"},      // insert_time plus freshness_period
+};
+
+/**
+ * @brief Index of the statement in SqliteStorage::m_scanStmts that serves a scan
+ */
+size_t
+getScanVariant(bool isBeginIncluded, bool hasEnd, bool withData)
 {
-  sqlite3_close(m_db);
+  return (isBeginIncluded ? 1 : 0) | (hasEnd ? 2 : 0) | (withData ? 4 : 0);
 }
 
-int64_t
-SqliteStorage::insert(const Data& data)
-{
-  Name name = data.getFullName(); // store the full name
-  ndn::util::Sqlite3Statement stmt(m_db, "INSERT INTO NDN_REPO_V2 (name, data) VALUES (?, ?);");
+const char INSERT_SQL[] = "INSERT INTO NDN_REPO_V2 (name, data, size, content_type, freshness_period, "
+                          "signer, insert_time, fresh_until) VALUES (?, ?, ?, ?, ?, ?, ?, ?);";
+const char INSERT_IF_ABSENT_SQL[] = "INSERT OR IGNORE INTO NDN_REPO_V2 (name, data, size, content_type, "
+                                    "freshness_period, signer, insert_time, fresh_until) "
+                                    "VALUES (?, ?, ?, ?, ?, ?, ?, ?);";
 
-  // Insert
-  // Bind NULL to name value in NDN_REPO_V2 when initialize result.
-  auto result = sqlite3_bind_null(stmt, 1);
+/**
+ * @brief Bind the size, content_type, freshness_period, and signer columns of @p data to
+ *        consecutive parameters of @p stmt, starting at @p index
+ */
+int
+bindPacketMetadata(ndn::util::Sqlite3Statement& stmt, int index, const Data& data)
+{
+  int result = sqlite3_bind_int64(stmt, index, static_cast<int64_t>(data.wireEncode().size()));
   if (result == SQLITE_OK) {
-    result = stmt.bind(1, name.wireEncode().value(),
-                          name.wireEncode().value_size(), SQLITE_STATIC);
+    result = sqlite3_bind_int64(stmt, index + 1, data.getContentType());
   }
   if (result == SQLITE_OK) {
-    result = stmt.bind(2, data.wireEncode(), SQLITE_STATIC);
+    result = sqlite3_bind_int64(stmt, index + 2, data.getFreshnessPeriod().count());
   }
-
   if (result == SQLITE_OK) {
-    int rc = 0;
-    rc = stmt.step();
-    if (rc == SQLITE_CONSTRAINT) {
-      NDN_LOG_DEBUG("Insert failed");
-      NDN_THROW(Error("Insert failed"));
+    const auto& sigInfo = data.getSignatureInfo();
+    if (sigInfo.hasKeyLocator() && sigInfo.getKeyLocator().getType() == ndn::tlv::Name) {
+      const auto& signer = sigInfo.getKeyLocator().getName().wireEncode();
+      result = stmt.bind(index + 3, signer.value(), signer.value_size(), SQLITE_STATIC);
+    }
+    else {
+      result = sqlite3_bind_null(stmt, index + 3);
     }
-    sqlite3_reset(stmt);
-    return sqlite3_last_insert_rowid(m_db);
-  }
-  else {
-    NDN_THROW(Error("Database insert failure (code: " + std::to_string(result)));
   }
+  return result;
 }
 
-bool
-SqliteStorage::erase(const Name& name)
+/**
+ * @brief Bind the metadata columns of @p data, inserted now, to parameters 3 to 8 of a
+ *        statement compiled from INSERT_SQL or INSERT_IF_ABSENT_SQL
+ *
+ * Data without FreshnessPeriod are stale right away.
+ */
+int
+bindMetadata(ndn::util::Sqlite3Statement& stmt, const Data& data)
 {
-  ndn::util::Sqlite3Statement stmt(m_db, "DELETE FROM NDN_REPO_V2 WHERE name = ?;");
-
-  auto result = stmt.bind(1,
-                          name.wireEncode().value(),
-                          name.wireEncode().value_size(), SQLITE_STATIC);
-
+  auto now = time::system_clock::now();
+  int result = bindPacketMetadata(stmt, 3, data);
   if (result == SQLITE_OK) {
-    int rc = stmt.step();
-    if (rc != SQLITE_DONE && rc != SQLITE_ROW) {
-      NDN_LOG_DEBUG("Node delete error rc:" << rc);
-      NDN_THROW(Error("Node delete error"));
-    }
-    if (sqlite3_changes(m_db) != 1) {
-      return false;
-    }
+    result = sqlite3_bind_int64(stmt, 7, time::toUnixTimestamp(now).count());
   }
-  else {
-    NDN_LOG_DEBUG("delete bind error");
-    NDN_THROW(Error("delete bind error"));
+  if (result == SQLITE_OK) {
+    result = sqlite3_bind_int64(stmt, 8, time::toUnixTimestamp(now + data.getFreshnessPeriod()).count());
   }
-  return true;
+  return result;
 }
 
-std::shared_ptr<Data>
-SqliteStorage::read(const Name& name)
+/**
+ * @brief Conversion of the rows stored before a schema version, done in the background
+ */
+struct RowMigration
 {
-  return find(name);
-}
+  int version;
+  /// statement converting one row, with the row id bound to its last parameter
+  const char* sql;
+  /// bind the other parameters of @c sql from the Data of the row and the time of the
+  /// schema upgrade
+  int (*bind)(ndn::util::Sqlite3Statement& stmt, const Data& data,
+              const time::system_clock::time_point& upgradeTime);
+};
 
-bool
-SqliteStorage::has(const Name& name)
+const RowMigration ROW_MIGRATIONS[] = {
+  // The insertion time of older rows is unknown. They are taken as inserted at the upgrade,
+  // which keeps them before the rows inserted since in insertion order, and are fresh for
+  // their FreshnessPeriod after it.
+  {1, "UPDATE NDN_REPO_V2 SET size = ?, content_type = ?, freshness_period = ?, signer = ?, "
+      "insert_time = ?, fresh_until = ? WHERE rowid = ?;",
+   [] (ndn::util::Sqlite3Statement& stmt, const Data& data,
+       const time::system_clock::time_point& upgradeTime) {
+     int result = bindPacketMetadata(stmt, 1, data);
+     if (result == SQLITE_OK) {
+       result = sqlite3_bind_int64(stmt, 5, time::toUnixTimestamp(upgradeTime).count());
+     }
+     if (result == SQLITE_OK) {
+       result = sqlite3_bind_int64(stmt, 6,
+                                   time::toUnixTimestamp(upgradeTime + data.getFreshnessPeriod()).count());
+     }
+     return result;
+   }},
+};
+
+const RowMigration*
+findRowMigration(int version)
 {
-  // find exact match
-  return find(name, true) != nullptr;
+  for (const auto& migration : ROW_MIGRATIONS) {
+    if (migration.version == version) {
+      return &migration;
+    }
+  }
+  return nullptr;
 }
 
+/**
+ * @brief Look up Data with a statement compiled from FIND_EXACT_SQL, FIND_PREFIX_SQL,
+ *        or FIND_LAST_SQL
+ */
 std::shared_ptr<Data>
-SqliteStorage::find(const Name& name, bool exactMatch)
+findWithStatement(ndn::util::Sqlite3Statement& stmt, const Name& name, bool exactMatch)
 {
   NDN_LOG_DEBUG("Trying to find: " << name);
   Name nameSuccessor;
@@ -163,13 +266,7 @@ SqliteStorage::find(const Name& name, bool exactMatch)
     nameSuccessor = name.getSuccessor();
   }
 
-  std::string sql;
-  if (exactMatch)
-    sql = "SELECT * FROM NDN_REPO_V2 WHERE name = ?;";
-  else
-    sql = "SELECT * FROM NDN_REPO_V2 WHERE name >= ? and name < ?;";
-
-  ndn::util::Sqlite3Statement stmt(m_db, sql);
+  StatementGuard guard(stmt);
 
   auto result = stmt.bind(1,
                           name.wireEncode().value(),
@@ -186,7 +283,15 @@ SqliteStorage::find(const Name& name, bool exactMatch)
   if (result == SQLITE_OK) {
     int rc = stmt.step();
     if (rc == SQLITE_ROW) {
-      Name foundName;
+      // The name column holds the full name, so the match is checked on it directly,
+      // without recomputing the implicit digest of the stored Data.
+      auto queryName = name.wireEncode().value_bytes();
+      auto foundName = ndn::make_span(stmt.getBlob(0), static_cast<size_t>(stmt.getSize(0)));
+      bool isMatch = isEncodedPrefixOf(queryName, foundName) &&
+                     (!exactMatch || queryName.size() == foundName.size());
+      if (!isMatch) {
+        return nullptr;
+      }
 
       auto data = std::make_shared<Data>();
       try {
@@ -196,69 +301,1666 @@ SqliteStorage::find(const Name& name, bool exactMatch)
         NDN_LOG_DEBUG(error.what());
         return nullptr;
       }
-      NDN_LOG_DEBUG("Data from db: " << *data);
-
-      foundName = data->getFullName();
-
-      if ((exactMatch && name == foundName) || (!exactMatch && name.isPrefixOf(foundName))) {
-        NDN_LOG_DEBUG("Found: " << foundName << " " << stmt.getInt(0));
-        return data;
-      }
+      NDN_LOG_DEBUG("Found: " << data->getName());
+      return data;
     }
     else if (rc == SQLITE_DONE) {
       return nullptr;
     }
     else {
       NDN_LOG_DEBUG("Database query failure rc:" << rc);
-      NDN_THROW(Error("Database query failure"));
+      NDN_THROW(SqliteStorage::Error("Database query failure"));
     }
   }
   else {
     NDN_LOG_DEBUG("select bind error");
-    NDN_THROW(Error("select bind error"));
+    NDN_THROW(SqliteStorage::Error("select bind error"));
   }
   return nullptr;
 }
 
-void
-SqliteStorage::forEach(const std::function<void(const Name&)>& f)
+/**
+ * @brief Look up the Data that can satisfy an Interest for @p name, with a statement compiled
+ *        from FIND_PREFIX_SQL, FIND_LAST_SQL, FIND_FRESH_SQL, or FIND_LAST_FRESH_SQL
+ *
+ * With CanBePrefix, the range of full names looked up is that of the names under @p name.
+ * Otherwise, it is from @p name to @p name followed by the type and length of an implicit
+ * digest plus one, which holds only @p name as a full name and the full names of Data
+ * named @p name: the digest component has the lowest type and a fixed size. The query is
+ * then an index probe, which finds no row if no Data matches.
+ */
+std::shared_ptr<Data>
+findMatchWithStatement(ndn::util::Sqlite3Statement& stmt, const Name& name,
+                       bool canBePrefix, bool mustBeFresh)
 {
-  ndn::util::Sqlite3Statement stmt(m_db, "SELECT data FROM NDN_REPO_V2;");
+  NDN_LOG_DEBUG("Trying to match: " << name);
+  auto begin = name.wireEncode().value_bytes();
+  Name successor;
+  std::vector<uint8_t> end;
+  if (canBePrefix) {
+    successor = name.getSuccessor();
+    auto value = successor.wireEncode().value_bytes();
+    end.assign(value.begin(), value.end());
+  }
+  else {
+    end.assign(begin.begin(), begin.end());
+    end.push_back(ndn::tlv::ImplicitSha256DigestComponent);
+    end.push_back(ndn::util::Sha256::DIGEST_SIZE + 1);
+  }
 
-  while (true) {
-    int rc = stmt.step();
-    if (rc == SQLITE_ROW) {
-      Data data;
-      try {
-        data.wireDecode(stmt.getBlock(0));
-      }
-      catch (const ndn::Block::Error& error) {
-        NDN_LOG_DEBUG("Error while decoding data from the database: " << error.what());
-        continue;
+  StatementGuard guard(stmt);
+  auto result = stmt.bind(1, begin.data(), begin.size(), SQLITE_STATIC);
+  if (result == SQLITE_OK) {
+    result = stmt.bind(2, end.data(), end.size(), SQLITE_STATIC);
+  }
+  if (result == SQLITE_OK && mustBeFresh) {
+    result = sqlite3_bind_int64(stmt, 3, time::toUnixTimestamp(time::system_clock::now()).count());
+  }
+  if (result != SQLITE_OK) {
+    NDN_LOG_DEBUG("select bind error");
+    NDN_THROW(SqliteStorage::Error("select bind error"));
+  }
+
+  int rc = stmt.step();
+  if (rc == SQLITE_DONE) {
+    return nullptr;
+  }
+  if (rc != SQLITE_ROW) {
+    NDN_LOG_DEBUG("Database query failure rc:" << rc);
+    NDN_THROW(SqliteStorage::Error("Database query failure"));
+  }
+
+  auto data = std::make_shared<Data>();
+  try {
+    data->wireDecode(stmt.getBlock(1));
+  }
+  catch (const ndn::Block::Error& error) {
+    NDN_LOG_DEBUG(error.what());
+    return nullptr;
+  }
+  NDN_LOG_DEBUG("Found: " << data->getName());
+  return data;
+}
+
+/**
+ * @brief Time a connection waits for a lock held by another connection, e.g., while a WAL
+ *        checkpoint runs, before the statement fails with SQLITE_BUSY
+ */
+const int BUSY_TIMEOUT_MS = 5000;
+
+/**
+ * @brief Open a connection to the database at @p path, waiting up to BUSY_TIMEOUT_MS for locks
+ */
+int
+openDatabase(const std::string& path, sqlite3** db, int flags)
+{
+  int rc = sqlite3_open_v2(path.data(), db, flags,
+#ifdef DISABLE_SQLITE3_FS_LOCKING
+                           "unix-dotfile"
+#else
+                           nullptr
+#endif
+                          );
+  if (rc != SQLITE_OK) {
+    return rc;
+  }
+  return sqlite3_busy_timeout(*db, BUSY_TIMEOUT_MS);
+}
+
+} // namespace
+
+/**
+ * @brief State of a prefix summary consistency check in progress
+ *
+ * The check enumerates the stored names in short steps, each one a page ordered by name read
+ * in its own transaction, so that no read transaction stays open across the steps. Temporary
+ * triggers record the names inserted or erased behind the check position in
+ * prefix_check_changes, within the transaction of the modification, so that the changes
+ * rolled back are not recorded either.
+ */
+struct SqliteStorage::PrefixSummaryCheck
+{
+  std::map<Name, int64_t> actual;
+};
+
+/**
+ * @brief Worker threads serving asyncFind(), each through its own read-only connection
+ *
+ * In WAL mode, the readers block neither the writer nor each other, and each lookup sees
+ * the database as of the last commit before it started.
+ */
+class SqliteStorage::ReaderPool
+{
+public:
+  ReaderPool(const std::string& dbPath, boost::asio::io_context& ioCtx, size_t nThreads)
+    : m_ioCtx(ioCtx)
+  {
+    // connections are opened here, so that a failure is reported to the caller
+    std::vector<sqlite3*> connections;
+    for (size_t i = 0; i < nThreads; ++i) {
+      sqlite3* db = nullptr;
+      if (openDatabase(dbPath, &db, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX) != SQLITE_OK) {
+        sqlite3_close(db);
+        for (auto* connection : connections) {
+          sqlite3_close(connection);
+        }
+        NDN_THROW(Error("Cannot open a read-only connection to " + dbPath));
       }
-      f(data.getName());
+      connections.push_back(db);
     }
-    else if (rc == SQLITE_DONE) {
-      break;
+
+    for (auto* db : connections) {
+      m_threads.emplace_back([this, db] { run(db); });
     }
-    else {
-      NDN_THROW(Error("Database query failure (code: " + std::to_string(rc)));
+    NDN_LOG_INFO("Serving lookups on " << nThreads << " worker threads");
+  }
+
+  ~ReaderPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_isStopping = true;
+    }
+    m_condition.notify_all();
+    for (auto& thread : m_threads) {
+      thread.join();
+    }
+  }
+
+  struct Request
+  {
+    Name name;
+    Lookup lookup;
+    FindCallback onResult;
+    /// Interest fields and rightmost selection of a Lookup::MATCH
+    bool canBePrefix = false;
+    bool mustBeFresh = false;
+    bool isRightmost = false;
+  };
+
+  void
+  enqueue(Request request)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_requests.push_back(std::move(request));
+    }
+    m_condition.notify_one();
+  }
+
+private:
+  void
+  run(sqlite3* db)
+  {
+    {
+      ndn::util::Sqlite3Statement findExactStmt(db, FIND_EXACT_SQL);
+      ndn::util::Sqlite3Statement findPrefixStmt(db, FIND_PREFIX_SQL);
+      ndn::util::Sqlite3Statement findLastStmt(db, FIND_LAST_SQL);
+      ndn::util::Sqlite3Statement findFreshStmt(db, FIND_FRESH_SQL);
+      ndn::util::Sqlite3Statement findLastFreshStmt(db, FIND_LAST_FRESH_SQL);
+
+      while (true) {
+        Request request;
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+          m_condition.wait(lock, [this] { return m_isStopping || !m_requests.empty(); });
+          if (m_isStopping) {
+            break;
+          }
+          request = std::move(m_requests.front());
+          m_requests.pop_front();
+        }
+
+        std::shared_ptr<Data> data;
+        try {
+          switch (request.lookup) {
+            case Lookup::EXACT:
+              data = findWithStatement(findExactStmt, request.name, true);
+              break;
+            case Lookup::FIRST:
+              data = findWithStatement(findPrefixStmt, request.name, false);
+              break;
+            case Lookup::LAST:
+              data = findWithStatement(findLastStmt, request.name, false);
+              break;
+            case Lookup::MATCH: {
+              auto& stmt = request.mustBeFresh ?
+                           (request.isRightmost ? findLastFreshStmt : findFreshStmt) :
+                           (request.isRightmost ? findLastStmt : findPrefixStmt);
+              data = findMatchWithStatement(stmt, request.name, request.canBePrefix,
+                                            request.mustBeFresh);
+              break;
+            }
+          }
+        }
+        catch (const std::exception& e) {
+          NDN_LOG_ERROR("Lookup of " << request.name << " failed: " << e.what());
+        }
+
+        // results are delivered in the io_context thread, unless the pool is gone by then
+        boost::asio::post(m_ioCtx, [isAlive = std::weak_ptr<int>(m_aliveToken),
+                                    onResult = std::move(request.onResult),
+                                    data = std::move(data)] {
+          if (!isAlive.expired()) {
+            onResult(data);
+          }
+        });
+      }
+    }
+    sqlite3_close(db);
+  }
+
+private:
+  boost::asio::io_context& m_ioCtx;
+  std::shared_ptr<int> m_aliveToken = std::make_shared<int>();
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::deque<Request> m_requests;
+  bool m_isStopping = false;
+  std::vector<std::thread> m_threads;
+};
+
+SqliteStorage::SqliteStorage(const std::string& dbPath)
+{
+  if (dbPath.empty()) {
+    m_dbPath = "ndn_repo.db";
+  }
+  else {
+    std::filesystem::path fsPath(dbPath);
+    if (!std::filesystem::is_directory(fsPath)) {
+      if (!std::filesystem::create_directory(fsPath)) {
+        NDN_THROW(Error("Directory '" + dbPath + "' does not exists and cannot be created"));
+      }
     }
+    m_dbPath = dbPath + "/ndn_repo.db";
+  }
+
+  NDN_LOG_DEBUG("Using database file " << m_dbPath);
+  try {
+    initializeRepo();
+    initializeCounters();
+    migrateSchema();
+    initializePrefixSummary();
+    prepareStatements();
+  }
+  catch (...) {
+    // the destructor does not run when the constructor throws
+    close();
+    throw;
   }
 }
 
-uint64_t
-SqliteStorage::size()
+void
+SqliteStorage::initializeRepo()
 {
-  ndn::util::Sqlite3Statement stmt(m_db, "SELECT count(*) FROM NDN_REPO_V2;");
+  char* errMsg = nullptr;
+  int rc = openDatabase(m_dbPath, &m_db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
 
-  int rc = stmt.step();
-  if (rc != SQLITE_ROW) {
-    NDN_LOG_DEBUG("Database query failure rc:" << rc);
-    NDN_THROW(Error("Database query failure"));
+  if (rc == SQLITE_OK) {
+    // Create a new table named NDN_REPO_V2, distinguish from the old table name(NDN_REPO),
+    // in its version 0 schema; migrateSchema() brings it to the current version
+    execute("CREATE TABLE IF NOT EXISTS NDN_REPO_V2 (name BLOB, data BLOB);");
+    execute("CREATE UNIQUE INDEX IF NOT EXISTS index_name ON NDN_REPO_V2 (name);");
+  }
+  else {
+    NDN_LOG_DEBUG("Database file open failure rc:" << rc);
+    NDN_THROW(Error("Database file open failure"));
   }
 
-  return stmt.getInt(0);
+  // SQLite continues without syncing as soon as it has handed data off to the operating system
+  sqlite3_exec(m_db, "PRAGMA synchronous = OFF;", nullptr, nullptr, &errMsg);
+  // Uses a write-ahead log instead of a rollback journal to implement transactions.
+  sqlite3_exec(m_db, "PRAGMA journal_mode = WAL;", nullptr, nullptr, &errMsg);
+}
+
+void
+SqliteStorage::initializeCounters()
+{
+  // The number of rows and the total size of the stored Data are kept in NDN_REPO_META and
+  // updated by triggers, in the same transaction as the modification of NDN_REPO_V2.
+  // A database created without the counters gets them computed once, here.
+  execute("CREATE TABLE IF NOT EXISTS NDN_REPO_META (key TEXT PRIMARY KEY, value INTEGER NOT NULL);");
+
+  ndn::util::Sqlite3Statement check(m_db,
+    "SELECT count(*) FROM NDN_REPO_META WHERE key IN ('rows', 'bytes');");
+  if (check.step() == SQLITE_ROW && check.getInt(0) == 2) {
+    return;
+  }
+
+  NDN_LOG_INFO("Initializing the row and byte counters of " << m_dbPath);
+  execute("BEGIN IMMEDIATE;");
+  try {
+    execute("DELETE FROM NDN_REPO_META WHERE key IN ('rows', 'bytes');");
+    execute("INSERT INTO NDN_REPO_META (key, value) "
+            "SELECT 'rows', count(*) FROM NDN_REPO_V2;");
+    execute("INSERT INTO NDN_REPO_META (key, value) "
+            "SELECT 'bytes', coalesce(sum(length(data)), 0) FROM NDN_REPO_V2;");
+    execute("CREATE TRIGGER IF NOT EXISTS NDN_REPO_V2_count_insert AFTER INSERT ON NDN_REPO_V2 "
+            "BEGIN "
+            "UPDATE NDN_REPO_META SET value = value + 1 WHERE key = 'rows'; "
+            "UPDATE NDN_REPO_META SET value = value + length(NEW.data) WHERE key = 'bytes'; "
+            "END;");
+    execute("CREATE TRIGGER IF NOT EXISTS NDN_REPO_V2_count_delete AFTER DELETE ON NDN_REPO_V2 "
+            "BEGIN "
+            "UPDATE NDN_REPO_META SET value = value - 1 WHERE key = 'rows'; "
+            "UPDATE NDN_REPO_META SET value = value - length(OLD.data) WHERE key = 'bytes'; "
+            "END;");
+    execute("CREATE TRIGGER IF NOT EXISTS NDN_REPO_V2_count_update AFTER UPDATE OF data ON NDN_REPO_V2 "
+            "BEGIN "
+            "UPDATE NDN_REPO_META SET value = value + length(NEW.data) - length(OLD.data) "
+            "WHERE key = 'bytes'; "
+            "END;");
+    execute("COMMIT;");
+  }
+  catch (const Error&) {
+    sqlite3_exec(m_db, "ROLLBACK;", nullptr, nullptr, nullptr);
+    throw;
+  }
+}
+
+void
+SqliteStorage::migrateSchema()
+{
+  int version = 0;
+  {
+    ndn::util::Sqlite3Statement stmt(m_db, "PRAGMA user_version;");
+    if (stmt.step() == SQLITE_ROW) {
+      version = stmt.getInt(0);
+    }
+  }
+  if (version > SCHEMA_VERSION) {
+    NDN_THROW(Error("Database schema version " + std::to_string(version) + " of " + m_dbPath +
+                    " is newer than the supported version " + std::to_string(SCHEMA_VERSION)));
+  }
+
+  execute("CREATE TABLE IF NOT EXISTS NDN_REPO_MIGRATIONS (version INTEGER PRIMARY KEY, "
+          "next_rowid INTEGER NOT NULL, migrated INTEGER NOT NULL, total INTEGER NOT NULL, "
+          "upgrade_time INTEGER NOT NULL);");
+
+  if (version < SCHEMA_VERSION) {
+    NDN_LOG_INFO("Upgrading the schema of " << m_dbPath << " from version " << version
+                 << " to " << SCHEMA_VERSION);
+    execute("BEGIN IMMEDIATE;");
+    try {
+      for (int v = version + 1; v <= SCHEMA_VERSION; ++v) {
+        upgradeSchema(v);
+      }
+      execute(("PRAGMA user_version = " + std::to_string(SCHEMA_VERSION) + ";").data());
+      execute("COMMIT;");
+    }
+    catch (const Error&) {
+      sqlite3_exec(m_db, "ROLLBACK;", nullptr, nullptr, nullptr);
+      throw;
+    }
+  }
+
+  loadMigration();
+}
+
+void
+SqliteStorage::upgradeSchema(int version)
+{
+  // Schema changes must not rewrite the table, so that opening a large database stays fast.
+  // Existing rows are converted by migrate() afterwards.
+  switch (version) {
+  case 1: {
+    std::set<std::string> columns;
+    {
+      ndn::util::Sqlite3Statement stmt(m_db, "PRAGMA table_info(NDN_REPO_V2);");
+      while (stmt.step() == SQLITE_ROW) {
+        columns.insert(stmt.getString(1));
+      }
+    }
+    for (const auto& [column, type] : METADATA_COLUMNS) {
+      if (columns.count(column) == 0) {
+        execute(("ALTER TABLE NDN_REPO_V2 ADD COLUMN " + std::string(column) + " " + type + ";").data());
+      }
+    }
+    // MustBeFresh lookups scan the index on the name column, and check fresh_until in the
+    // rows, so that insertions do not write the name into a second index
+    execute("CREATE INDEX IF NOT EXISTS index_insert_time ON NDN_REPO_V2 (insert_time);");
+    break;
+  }
+  }
+
+  if (findRowMigration(version) != nullptr) {
+    // rows inserted from now on have higher row ids, and are already in the new schema
+    ndn::util::Sqlite3Statement stmt(m_db,
+      "INSERT OR REPLACE INTO NDN_REPO_MIGRATIONS (version, next_rowid, migrated, total, upgrade_time) "
+      "SELECT ?, (SELECT max(rowid) FROM NDN_REPO_V2), 0, value, ? FROM NDN_REPO_META "
+      "WHERE key = 'rows' AND value > 0;");
+    sqlite3_bind_int(stmt, 1, version);
+    sqlite3_bind_int64(stmt, 2, time::toUnixTimestamp(time::system_clock::now()).count());
+    if (stmt.step() != SQLITE_DONE) {
+      NDN_THROW(Error("Cannot schedule the migration to schema version " + std::to_string(version)));
+    }
+  }
+}
+
+void
+SqliteStorage::loadMigration()
+{
+  m_migration.reset();
+  ndn::util::Sqlite3Statement stmt(m_db,
+    "SELECT version, next_rowid, migrated, total, upgrade_time FROM NDN_REPO_MIGRATIONS "
+    "ORDER BY version LIMIT 1;");
+  if (stmt.step() == SQLITE_ROW) {
+    MigrationProgress progress;
+    progress.version = stmt.getInt(0);
+    progress.nMigrated = static_cast<uint64_t>(sqlite3_column_int64(stmt, 2));
+    progress.nEntries = static_cast<uint64_t>(sqlite3_column_int64(stmt, 3));
+    m_migration = {progress, sqlite3_column_int64(stmt, 1),
+                   time::fromUnixTimestamp(time::milliseconds(sqlite3_column_int64(stmt, 4)))};
+    NDN_LOG_INFO("Migration to schema version " << progress.version << " has " << progress.nMigrated
+                 << " of " << progress.nEntries << " rows migrated");
+  }
+}
+
+void
+SqliteStorage::execute(const char* sql)
+{
+  char* errMsg = nullptr;
+  int rc = sqlite3_exec(m_db, sql, nullptr, nullptr, &errMsg);
+  if (rc != SQLITE_OK) {
+    std::string what = errMsg != nullptr ? errMsg : sqlite3_errstr(rc);
+    sqlite3_free(errMsg);
+    NDN_LOG_DEBUG("Statement failure rc:" << rc << " " << what);
+    NDN_THROW(Error("Database statement failure: " + what));
+  }
+}
+
+void
+SqliteStorage::prepareStatements()
+{
+  using ndn::util::Sqlite3Statement;
+  m_insertStmt = std::make_unique<Sqlite3Statement>(m_db, INSERT_SQL);
+  m_insertIfAbsentStmt = std::make_unique<Sqlite3Statement>(m_db, INSERT_IF_ABSENT_SQL);
+  std::string selectStoredSql = "SELECT name FROM NDN_REPO_V2 WHERE name IN (?";
+  for (size_t i = 1; i < STORED_CHECK_CHUNK_SIZE; ++i) {
+    selectStoredSql += ", ?";
+  }
+  selectStoredSql += ");";
+  m_selectStoredStmt = std::make_unique<Sqlite3Statement>(m_db, selectStoredSql);
+  m_eraseStmt = std::make_unique<Sqlite3Statement>(m_db,
+    "DELETE FROM NDN_REPO_V2 WHERE name = ?;");
+  m_selectRangeStmt = std::make_unique<Sqlite3Statement>(m_db,
+    "SELECT name FROM NDN_REPO_V2 WHERE name >= ? AND name < ? ORDER BY name LIMIT ?;");
+  m_eraseRangeStmt = std::make_unique<Sqlite3Statement>(m_db,
+    "DELETE FROM NDN_REPO_V2 WHERE name >= ? AND name <= ?;");
+  m_findExactStmt = std::make_unique<Sqlite3Statement>(m_db, FIND_EXACT_SQL);
+  m_findPrefixStmt = std::make_unique<Sqlite3Statement>(m_db, FIND_PREFIX_SQL);
+  m_findLastStmt = std::make_unique<Sqlite3Statement>(m_db, FIND_LAST_SQL);
+  m_findFreshStmt = std::make_unique<Sqlite3Statement>(m_db, FIND_FRESH_SQL);
+  m_findLastFreshStmt = std::make_unique<Sqlite3Statement>(m_db, FIND_LAST_FRESH_SQL);
+  m_findByIdStmt = std::make_unique<Sqlite3Statement>(m_db,
+    "SELECT data FROM NDN_REPO_V2 WHERE rowid = ?;");
+  m_countStmt = std::make_unique<Sqlite3Statement>(m_db,
+    "SELECT value FROM NDN_REPO_META WHERE key = 'rows';");
+  m_bytesStmt = std::make_unique<Sqlite3Statement>(m_db,
+    "SELECT value FROM NDN_REPO_META WHERE key = 'bytes';");
+  m_beginStmt = std::make_unique<Sqlite3Statement>(m_db, "BEGIN IMMEDIATE;");
+  m_commitStmt = std::make_unique<Sqlite3Statement>(m_db, "COMMIT;");
+  m_rollbackStmt = std::make_unique<Sqlite3Statement>(m_db, "ROLLBACK;");
+  m_savepointStmt = std::make_unique<Sqlite3Statement>(m_db, "SAVEPOINT repo_savepoint;");
+  m_releaseStmt = std::make_unique<Sqlite3Statement>(m_db, "RELEASE repo_savepoint;");
+  // scans are served from the index on the name column; the Data are loaded only if requested
+  for (bool withData : {false, true}) {
+    for (bool hasEnd : {false, true}) {
+      for (bool isBeginIncluded : {false, true}) {
+        std::string sql = withData ? "SELECT name, data FROM NDN_REPO_V2" : "SELECT name FROM NDN_REPO_V2";
+        sql += isBeginIncluded ? " WHERE name >= ?" : " WHERE name > ?";
+        if (hasEnd) {
+          sql += " AND name < ?";
+        }
+        sql += " ORDER BY name LIMIT ?;";
+        m_scanStmts[getScanVariant(isBeginIncluded, hasEnd, withData)] =
+          std::make_unique<Sqlite3Statement>(m_db, sql);
+      }
+    }
+  }
+  m_updatePrefixStmt = std::make_unique<Sqlite3Statement>(m_db,
+    "INSERT INTO NDN_REPO_PREFIXES (prefix, count) VALUES (?, ?) "
+    "ON CONFLICT (prefix) DO UPDATE SET count = count + excluded.count;");
+  m_deleteEmptyPrefixStmt = std::make_unique<Sqlite3Statement>(m_db,
+    "DELETE FROM NDN_REPO_PREFIXES WHERE prefix = ? AND count <= 0;");
+}
+
+SqliteStorage::~SqliteStorage()
+{
+  close();
+}
+
+void
+SqliteStorage::close()
+{
+  // all statements must be finalized before the connection can be closed
+  m_insertStmt.reset();
+  m_insertIfAbsentStmt.reset();
+  m_selectStoredStmt.reset();
+  m_eraseStmt.reset();
+  m_selectRangeStmt.reset();
+  m_eraseRangeStmt.reset();
+  m_findExactStmt.reset();
+  m_findPrefixStmt.reset();
+  m_findLastStmt.reset();
+  m_findFreshStmt.reset();
+  m_findLastFreshStmt.reset();
+  m_findByIdStmt.reset();
+  m_countStmt.reset();
+  m_bytesStmt.reset();
+  m_beginStmt.reset();
+  m_commitStmt.reset();
+  m_rollbackStmt.reset();
+  m_savepointStmt.reset();
+  m_releaseStmt.reset();
+  for (auto& stmt : m_scanStmts) {
+    stmt.reset();
+  }
+  m_updatePrefixStmt.reset();
+  m_deleteEmptyPrefixStmt.reset();
+  m_prefixCheck.reset();
+  m_readerPool.reset();
+  sqlite3_close(m_db);
+  m_db = nullptr;
+}
+
+template<typename Function>
+auto
+SqliteStorage::withSavepoint(Function&& f)
+{
+  // A savepoint starts a transaction of its own, or nests in the caller's transaction
+  executeTransactionStatement(*m_savepointStmt);
+  size_t nIndexChanges = m_nameIndexJournal.size();
+  try {
+    auto result = f();
+    executeTransactionStatement(*m_releaseStmt);
+    if (sqlite3_get_autocommit(m_db) != 0) {
+      m_nameIndexJournal.clear();
+    }
+    return result;
+  }
+  catch (...) {
+    sqlite3_exec(m_db, "ROLLBACK TO repo_savepoint; RELEASE repo_savepoint;", nullptr, nullptr, nullptr);
+    undoIndexChanges(nIndexChanges);
+    throw;
+  }
+}
+
+int64_t
+SqliteStorage::insert(const Data& data)
+{
+  if (!m_prefixSuffixLength) {
+    return doInsert(data);
+  }
+  return withSavepoint([&] {
+    auto id = doInsert(data);
+    updatePrefixCount(getRegistrationPrefix(data.getName()), 1);
+    return id;
+  });
+}
+
+bool
+SqliteStorage::insertIfAbsent(const Data& data)
+{
+  if (!m_prefixSuffixLength) {
+    return doInsertIfAbsent(data);
+  }
+  return withSavepoint([&] {
+    bool isInserted = doInsertIfAbsent(data);
+    if (isInserted) {
+      updatePrefixCount(getRegistrationPrefix(data.getName()), 1);
+    }
+    return isInserted;
+  });
+}
+
+std::vector<bool>
+SqliteStorage::insertBatch(ndn::span<const Data> batch)
+{
+  std::vector<Name> fullNames;
+  fullNames.reserve(batch.size());
+  for (const auto& data : batch) {
+    fullNames.push_back(data.getFullName());
+  }
+
+  return withSavepoint([&] {
+    auto storedNames = selectStoredNames(fullNames);
+    std::vector<bool> isInserted(batch.size(), false);
+    std::map<Name, int64_t> prefixDeltas;
+    for (size_t i = 0; i < batch.size(); ++i) {
+      // names inserted earlier in the batch are added too, so that repeated Data are skipped
+      auto value = fullNames[i].wireEncode().value_bytes();
+      if (!storedNames.emplace(value.begin(), value.end()).second) {
+        continue;
+      }
+      doInsert(batch[i]);
+      isInserted[i] = true;
+      if (m_prefixSuffixLength) {
+        ++prefixDeltas[getRegistrationPrefix(batch[i].getName())];
+      }
+    }
+    for (const auto& [prefix, delta] : prefixDeltas) {
+      updatePrefixCount(prefix, delta);
+    }
+    return isInserted;
+  });
+}
+
+std::set<std::vector<uint8_t>>
+SqliteStorage::selectStoredNames(const std::vector<Name>& fullNames)
+{
+  std::set<std::vector<uint8_t>> storedNames;
+  if (m_nameIndex != nullptr) {
+    for (const auto& fullName : fullNames) {
+      if (m_nameIndex->find(fullName) != nullptr) {
+        auto value = fullName.wireEncode().value_bytes();
+        storedNames.emplace(value.begin(), value.end());
+      }
+    }
+    return storedNames;
+  }
+
+  auto& stmt = *m_selectStoredStmt;
+  for (size_t first = 0; first < fullNames.size(); first += STORED_CHECK_CHUNK_SIZE) {
+    // parameters left unbound in the last chunk are NULL, which matches no name
+    StatementGuard guard(stmt);
+    size_t last = std::min(first + STORED_CHECK_CHUNK_SIZE, fullNames.size());
+    for (size_t i = first; i < last; ++i) {
+      const auto& wire = fullNames[i].wireEncode();
+      if (stmt.bind(static_cast<int>(i - first + 1), wire.value(), wire.value_size(),
+                    SQLITE_STATIC) != SQLITE_OK) {
+        NDN_THROW(Error("select bind error"));
+      }
+    }
+
+    int rc = 0;
+    while ((rc = stmt.step()) == SQLITE_ROW) {
+      storedNames.emplace(stmt.getBlob(0), stmt.getBlob(0) + stmt.getSize(0));
+    }
+    if (rc != SQLITE_DONE) {
+      NDN_LOG_DEBUG("Database query failure rc:" << rc);
+      NDN_THROW(Error("Database query failure (code: " + std::to_string(rc) + ")"));
+    }
+  }
+  return storedNames;
+}
+
+bool
+SqliteStorage::erase(const Name& name)
+{
+  if (!m_prefixSuffixLength) {
+    return doErase(name);
+  }
+  return withSavepoint([&] {
+    bool isErased = doErase(name);
+    if (isErased) {
+      updatePrefixCount(getRegistrationPrefix(name.getPrefix(-1)), -1);
+    }
+    return isErased;
+  });
+}
+
+int64_t
+SqliteStorage::doInsert(const Data& data)
+{
+  const Name& name = data.getFullName(); // store the full name
+  auto& stmt = *m_insertStmt;
+  StatementGuard guard(stmt);
+
+  // Insert
+  // Bind NULL to name value in NDN_REPO_V2 when initialize result.
+  auto result = sqlite3_bind_null(stmt, 1);
+  if (result == SQLITE_OK) {
+    result = stmt.bind(1, name.wireEncode().value(),
+                          name.wireEncode().value_size(), SQLITE_STATIC);
+  }
+  if (result == SQLITE_OK) {
+    result = stmt.bind(2, data.wireEncode(), SQLITE_STATIC);
+  }
+  if (result == SQLITE_OK) {
+    result = bindMetadata(stmt, data);
+  }
+
+  if (result == SQLITE_OK) {
+    int rc = 0;
+    rc = stmt.step();
+    if (rc == SQLITE_CONSTRAINT) {
+      NDN_LOG_DEBUG("Insert failed");
+      NDN_THROW(Error("Insert failed"));
+    }
+    int64_t id = sqlite3_last_insert_rowid(m_db);
+    if (rc == SQLITE_DONE) {
+      indexInsert(name, id);
+    }
+    return id;
+  }
+  else {
+    NDN_THROW(Error("Database insert failure (code: " + std::to_string(result)));
+  }
+}
+
+bool
+SqliteStorage::doInsertIfAbsent(const Data& data)
+{
+  const Name& name = data.getFullName(); // computed once, used as the unique key
+  auto& stmt = *m_insertIfAbsentStmt;
+  StatementGuard guard(stmt);
+
+  auto result = stmt.bind(1, name.wireEncode().value(), name.wireEncode().value_size(), SQLITE_STATIC);
+  if (result == SQLITE_OK) {
+    result = stmt.bind(2, data.wireEncode(), SQLITE_STATIC);
+  }
+  if (result == SQLITE_OK) {
+    result = bindMetadata(stmt, data);
+  }
+  if (result != SQLITE_OK) {
+    NDN_THROW(Error("Database insert failure (code: " + std::to_string(result) + ")"));
+  }
+
+  int rc = stmt.step();
+  if (rc != SQLITE_DONE) {
+    NDN_LOG_DEBUG("Insert failed rc:" << rc);
+    NDN_THROW(Error("Insert failed (code: " + std::to_string(rc) + ")"));
+  }
+  if (sqlite3_changes(m_db) != 1) {
+    return false;
+  }
+  indexInsert(name, sqlite3_last_insert_rowid(m_db));
+  return true;
+}
+
+bool
+SqliteStorage::doErase(const Name& name)
+{
+  auto& stmt = *m_eraseStmt;
+  StatementGuard guard(stmt);
+
+  auto result = stmt.bind(1,
+                          name.wireEncode().value(),
+                          name.wireEncode().value_size(), SQLITE_STATIC);
+
+  if (result == SQLITE_OK) {
+    int rc = stmt.step();
+    if (rc != SQLITE_DONE && rc != SQLITE_ROW) {
+      NDN_LOG_DEBUG("Node delete error rc:" << rc);
+      NDN_THROW(Error("Node delete error"));
+    }
+    if (sqlite3_changes(m_db) != 1) {
+      return false;
+    }
+    indexErase(name);
+  }
+  else {
+    NDN_LOG_DEBUG("delete bind error");
+    NDN_THROW(Error("delete bind error"));
+  }
+  return true;
+}
+
+uint64_t
+SqliteStorage::eraseRange(const Name& begin, const Name& end,
+                          const std::function<void(const std::vector<Name>&)>& onChunk)
+{
+  NDN_LOG_DEBUG("Erasing range [" << begin << ", " << end << ")");
+  auto beginValue = begin.wireEncode().value_bytes();
+  auto endValue = end.wireEncode().value_bytes();
+
+  uint64_t nErased = 0;
+  while (true) {
+    // each chunk is selected and deleted atomically
+    std::vector<Name> names;
+    int nChanges = withSavepoint([&] {
+      std::vector<uint8_t> firstValue, lastValue;
+      auto& selectStmt = *m_selectRangeStmt;
+      StatementGuard selectGuard(selectStmt);
+      selectStmt.bind(1, beginValue.data(), beginValue.size(), SQLITE_STATIC);
+      selectStmt.bind(2, endValue.data(), endValue.size(), SQLITE_STATIC);
+      sqlite3_bind_int(selectStmt, 3, ERASE_RANGE_CHUNK_SIZE);
+
+      int nRows = 0;
+      int rc = 0;
+      while ((rc = selectStmt.step()) == SQLITE_ROW) {
+        auto value = ndn::make_span(selectStmt.getBlob(0), static_cast<size_t>(selectStmt.getSize(0)));
+        if (nRows++ == 0) {
+          firstValue.assign(value.begin(), value.end());
+        }
+        lastValue.assign(value.begin(), value.end());
+        try {
+          names.push_back(getName(selectStmt, 0));
+        }
+        catch (const ndn::tlv::Error& error) {
+          NDN_LOG_DEBUG("Erasing undecodable name from the database: " << error.what());
+        }
+      }
+      if (rc != SQLITE_DONE) {
+        NDN_LOG_DEBUG("Database query failure rc:" << rc);
+        NDN_THROW(Error("Database query failure (code: " + std::to_string(rc) + ")"));
+      }
+      if (nRows == 0) {
+        return 0;
+      }
+
+      auto& eraseStmt = *m_eraseRangeStmt;
+      StatementGuard eraseGuard(eraseStmt);
+      eraseStmt.bind(1, firstValue.data(), firstValue.size(), SQLITE_STATIC);
+      eraseStmt.bind(2, lastValue.data(), lastValue.size(), SQLITE_STATIC);
+      rc = eraseStmt.step();
+      if (rc != SQLITE_DONE) {
+        NDN_LOG_DEBUG("Range delete error rc:" << rc);
+        NDN_THROW(Error("Range delete error (code: " + std::to_string(rc) + ")"));
+      }
+      int nDeleted = sqlite3_changes(m_db);
+      for (const auto& name : names) {
+        indexErase(name);
+      }
+
+      if (m_prefixSuffixLength) {
+        std::map<Name, int64_t> deltas;
+        for (const auto& name : names) {
+          --deltas[getRegistrationPrefix(name.getPrefix(-1))];
+        }
+        for (const auto& [prefix, delta] : deltas) {
+          updatePrefixCount(prefix, delta);
+        }
+      }
+      return nDeleted;
+    });
+
+    if (nChanges == 0) {
+      break;
+    }
+    nErased += nChanges;
+    onChunk(names);
+    if (nChanges < ERASE_RANGE_CHUNK_SIZE) {
+      break;
+    }
+  }
+
+  NDN_LOG_DEBUG("Erased " << nErased << " entries");
+  return nErased;
+}
+
+std::shared_ptr<Data>
+SqliteStorage::read(const Name& name)
+{
+  return find(name);
+}
+
+bool
+SqliteStorage::has(const Name& name)
+{
+  if (m_nameIndex != nullptr) {
+    return m_nameIndex->find(name) != nullptr;
+  }
+  // find exact match
+  return find(name, true) != nullptr;
+}
+
+std::shared_ptr<Data>
+SqliteStorage::find(const Name& name, bool exactMatch)
+{
+  if (m_nameIndex != nullptr) {
+    // the first name under the prefix is the row a prefix query would return
+    const int64_t* id = exactMatch ? m_nameIndex->find(name) : m_nameIndex->findFirst(name);
+    if (id == nullptr) {
+      NDN_LOG_DEBUG("Not in the name index: " << name);
+      return nullptr;
+    }
+    return readIndexed(*id, name, exactMatch ? *m_findExactStmt : *m_findPrefixStmt, exactMatch);
+  }
+  return findWithStatement(exactMatch ? *m_findExactStmt : *m_findPrefixStmt, name, exactMatch);
+}
+
+std::shared_ptr<Data>
+SqliteStorage::findLast(const Name& prefix)
+{
+  if (m_nameIndex != nullptr) {
+    const int64_t* id = m_nameIndex->findLast(prefix);
+    if (id == nullptr) {
+      NDN_LOG_DEBUG("Not in the name index: " << prefix);
+      return nullptr;
+    }
+    return readIndexed(*id, prefix, *m_findLastStmt, false);
+  }
+  return findWithStatement(*m_findLastStmt, prefix, false);
+}
+
+std::shared_ptr<Data>
+SqliteStorage::readIndexed(int64_t id, const Name& name, ndn::util::Sqlite3Statement& fallbackStmt,
+                           bool exactMatch)
+{
+  auto& stmt = *m_findByIdStmt;
+  StatementGuard guard(stmt);
+  sqlite3_bind_int64(stmt, 1, id);
+
+  int rc = stmt.step();
+  if (rc == SQLITE_ROW) {
+    auto data = std::make_shared<Data>();
+    try {
+      data->wireDecode(stmt.getBlock(0));
+    }
+    catch (const ndn::Block::Error& error) {
+      NDN_LOG_DEBUG(error.what());
+      return nullptr;
+    }
+    NDN_LOG_DEBUG("Found: " << data->getName());
+    return data;
+  }
+  if (rc != SQLITE_DONE) {
+    NDN_LOG_DEBUG("Database query failure rc:" << rc);
+    NDN_THROW(Error("Database query failure (code: " + std::to_string(rc) + ")"));
+  }
+
+  NDN_LOG_WARN("Row " << id << " of the name index is missing, looking up " << name << " by name");
+  return findWithStatement(fallbackStmt, name, exactMatch);
+}
+
+void
+SqliteStorage::asyncFind(const Name& name, bool exactMatch, const FindCallback& onResult)
+{
+  // worker connections cannot see the modifications of an open transaction
+  if (m_readerPool == nullptr || sqlite3_get_autocommit(m_db) == 0) {
+    Storage::asyncFind(name, exactMatch, onResult);
+    return;
+  }
+  m_readerPool->enqueue({name, exactMatch ? Lookup::EXACT : Lookup::FIRST, onResult});
+}
+
+void
+SqliteStorage::asyncFindLast(const Name& prefix, const FindCallback& onResult)
+{
+  if (m_readerPool == nullptr || sqlite3_get_autocommit(m_db) == 0) {
+    Storage::asyncFindLast(prefix, onResult);
+    return;
+  }
+  m_readerPool->enqueue({prefix, Lookup::LAST, onResult});
+}
+
+std::shared_ptr<Data>
+SqliteStorage::findMatch(const Interest& interest, bool isRightmost)
+{
+  // without MustBeFresh, the name index serves the first or last Data under the name
+  if (m_nameIndex != nullptr && !interest.getMustBeFresh()) {
+    return Storage::findMatch(interest, isRightmost);
+  }
+  isRightmost = isRightmost && interest.getCanBePrefix();
+  auto& stmt = interest.getMustBeFresh() ?
+               (isRightmost ? *m_findLastFreshStmt : *m_findFreshStmt) :
+               (isRightmost ? *m_findLastStmt : *m_findPrefixStmt);
+  return findMatchWithStatement(stmt, interest.getName(), interest.getCanBePrefix(),
+                                interest.getMustBeFresh());
+}
+
+void
+SqliteStorage::asyncFindMatch(const Interest& interest, bool isRightmost, const FindCallback& onResult)
+{
+  if (m_readerPool == nullptr || sqlite3_get_autocommit(m_db) == 0) {
+    Storage::asyncFindMatch(interest, isRightmost, onResult);
+    return;
+  }
+  ReaderPool::Request request{interest.getName(), Lookup::MATCH, onResult};
+  request.canBePrefix = interest.getCanBePrefix();
+  request.mustBeFresh = interest.getMustBeFresh();
+  request.isRightmost = isRightmost && interest.getCanBePrefix();
+  m_readerPool->enqueue(std::move(request));
+}
+
+bool
+SqliteStorage::enableConcurrentReads(boost::asio::io_context& ioCtx, size_t nThreads)
+{
+  m_readerPool = std::make_unique<ReaderPool>(m_dbPath, ioCtx, nThreads);
+  return true;
+}
+
+bool
+SqliteStorage::enableNameIndex(size_t maxBytes)
+{
+  m_nameIndex = std::make_unique<NameTrie<int64_t>>();
+  m_nameIndexMaxBytes = maxBytes;
+  m_nameIndexJournal.clear();
+
+  ndn::util::Sqlite3Statement stmt(m_db, "SELECT rowid, name FROM NDN_REPO_V2;");
+  int rc = 0;
+  while ((rc = stmt.step()) == SQLITE_ROW) {
+    Name name;
+    try {
+      name = getName(stmt, 1);
+    }
+    catch (const ndn::tlv::Error& error) {
+      NDN_LOG_DEBUG("Error while decoding name from the database: " << error.what());
+      continue;
+    }
+    indexInsert(name, sqlite3_column_int64(stmt, 0));
+    if (m_nameIndex == nullptr) {
+      return false;
+    }
+  }
+  if (rc != SQLITE_DONE) {
+    m_nameIndex.reset();
+    NDN_THROW(Error("Database query failure (code: " + std::to_string(rc) + ")"));
+  }
+
+  size_t nNames = m_nameIndex->size();
+  size_t nBytes = m_nameIndex->getMemoryUsage();
+  NDN_LOG_INFO("Name index of " << m_dbPath << ": " << nNames << " names in " << nBytes
+               << " bytes (" << (nNames > 0 ? nBytes / nNames : 0) << " bytes per name)");
+  return true;
+}
+
+void
+SqliteStorage::indexInsert(const Name& fullName, int64_t id)
+{
+  if (m_nameIndex == nullptr || !m_nameIndex->insert(fullName, id)) {
+    return;
+  }
+  if (m_nameIndex->getMemoryUsage() > m_nameIndexMaxBytes) {
+    dropNameIndex("it exceeds " + std::to_string(m_nameIndexMaxBytes) + " bytes");
+    return;
+  }
+  if (sqlite3_get_autocommit(m_db) == 0) {
+    m_nameIndexJournal.emplace_back(fullName, std::nullopt);
+  }
+}
+
+void
+SqliteStorage::indexErase(const Name& fullName)
+{
+  if (m_nameIndex == nullptr) {
+    return;
+  }
+  auto id = m_nameIndex->erase(fullName);
+  if (id && sqlite3_get_autocommit(m_db) == 0) {
+    m_nameIndexJournal.emplace_back(fullName, id);
+  }
+}
+
+void
+SqliteStorage::undoIndexChanges(size_t nKept)
+{
+  while (m_nameIndexJournal.size() > nKept) {
+    auto& [name, erasedId] = m_nameIndexJournal.back();
+    if (m_nameIndex != nullptr) {
+      if (erasedId) {
+        m_nameIndex->insert(name, *erasedId);
+      }
+      else {
+        m_nameIndex->erase(name);
+      }
+    }
+    m_nameIndexJournal.pop_back();
+  }
+}
+
+void
+SqliteStorage::dropNameIndex(const std::string& reason)
+{
+  NDN_LOG_WARN("Name index of " << m_dbPath << " dropped after " << m_nameIndex->size()
+               << " names, as " << reason << "; Data are looked up by queries");
+  m_nameIndex.reset();
+  m_nameIndexJournal.clear();
+}
+
+void
+SqliteStorage::forEachInInsertionOrder(const std::function<bool(const Name&)>& f)
+{
+  // rowid increases with every insertion, so it reflects the insertion order
+  ndn::util::Sqlite3Statement stmt(m_db, "SELECT name FROM NDN_REPO_V2 ORDER BY rowid;");
+
+  while (true) {
+    int rc = stmt.step();
+    if (rc == SQLITE_ROW) {
+      Name name;
+      try {
+        name = getName(stmt, 0);
+      }
+      catch (const ndn::tlv::Error& error) {
+        NDN_LOG_DEBUG("Error while decoding name from the database: " << error.what());
+        continue;
+      }
+      if (!f(name)) {
+        break;
+      }
+    }
+    else if (rc == SQLITE_DONE) {
+      break;
+    }
+    else {
+      NDN_THROW(Error("Database query failure (code: " + std::to_string(rc) + ")"));
+    }
+  }
+}
+
+std::vector<Name>
+SqliteStorage::nextInInsertionOrder(InsertionOrderPosition& position, size_t limit)
+{
+  int64_t afterRowid = position.sequences.empty() ? 0 : static_cast<int64_t>(position.sequences.front());
+  std::vector<Name> names;
+  // undecodable names are skipped, so further rows are listed to reach the limit
+  while (names.size() < limit) {
+    size_t pageSize = limit - names.size();
+    auto entries = listInInsertionOrder(afterRowid, pageSize);
+    for (auto& entry : entries) {
+      if (!entry.fullName.empty()) {
+        names.push_back(std::move(entry.fullName));
+      }
+      afterRowid = entry.rowid;
+    }
+    position.sequences = {static_cast<uint64_t>(afterRowid)};
+    if (entries.size() < pageSize) {
+      break;
+    }
+  }
+  return names;
+}
+
+std::vector<SqliteStorage::InsertionOrderEntry>
+SqliteStorage::listInInsertionOrder(int64_t afterRowid, size_t limit)
+{
+  ndn::util::Sqlite3Statement stmt(m_db, "SELECT rowid, insert_time, name FROM NDN_REPO_V2 "
+                                         "WHERE rowid > ? ORDER BY rowid LIMIT ?;");
+  sqlite3_bind_int64(stmt, 1, afterRowid);
+  sqlite3_bind_int64(stmt, 2, static_cast<int64_t>(limit));
+
+  std::vector<InsertionOrderEntry> entries;
+  int rc = 0;
+  while ((rc = stmt.step()) == SQLITE_ROW) {
+    auto& entry = entries.emplace_back();
+    entry.rowid = sqlite3_column_int64(stmt, 0);
+    if (sqlite3_column_type(stmt, 1) != SQLITE_NULL) {
+      entry.insertTime = sqlite3_column_int64(stmt, 1);
+    }
+    try {
+      entry.fullName = getName(stmt, 2);
+    }
+    catch (const ndn::tlv::Error& error) {
+      NDN_LOG_DEBUG("Error while decoding name from the database: " << error.what());
+    }
+  }
+  if (rc != SQLITE_DONE) {
+    NDN_THROW(Error("Database query failure (code: " + std::to_string(rc) + ")"));
+  }
+  return entries;
+}
+
+size_t
+SqliteStorage::scan(const Range& range, size_t limit, bool withData, const ScanCallback& f)
+{
+  // Undecodable entries are skipped and not counted. The query then resumes after the last
+  // row read, so that fewer than limit entries are enumerated only at the end of the range.
+  auto beginValue = range.begin.wireEncode().value_bytes();
+  std::vector<uint8_t> lowerBound(beginValue.begin(), beginValue.end());
+  bool isLowerBoundIncluded = range.isBeginIncluded;
+
+  size_t nEnumerated = 0;
+  while (nEnumerated < limit) {
+    auto& stmt = *m_scanStmts[getScanVariant(isLowerBoundIncluded, !range.end.empty(), withData)];
+    StatementGuard guard(stmt);
+
+    int index = 1;
+    stmt.bind(index++, lowerBound.data(), lowerBound.size(), SQLITE_TRANSIENT);
+    if (!range.end.empty()) {
+      stmt.bind(index++, range.end.wireEncode().value(), range.end.wireEncode().value_size(),
+                SQLITE_STATIC);
+    }
+    size_t nRequested = std::min<size_t>(limit - nEnumerated, INT64_MAX);
+    sqlite3_bind_int64(stmt, index, static_cast<int64_t>(nRequested));
+
+    size_t nRows = 0;
+    bool hasSkipped = false;
+    while (true) {
+      int rc = stmt.step();
+      if (rc == SQLITE_ROW) {
+        ++nRows;
+        Name name;
+        std::shared_ptr<Data> data;
+        try {
+          name = getName(stmt, 0);
+          if (withData) {
+            data = std::make_shared<Data>(stmt.getBlock(1));
+          }
+        }
+        catch (const ndn::tlv::Error& error) {
+          NDN_LOG_DEBUG("Error while decoding an entry of the database: " << error.what());
+          hasSkipped = true;
+          lowerBound.assign(stmt.getBlob(0), stmt.getBlob(0) + stmt.getSize(0));
+          continue;
+        }
+        ++nEnumerated;
+        f(name, std::move(data));
+        if (hasSkipped) {
+          auto value = name.wireEncode().value_bytes();
+          lowerBound.assign(value.begin(), value.end());
+        }
+      }
+      else if (rc == SQLITE_DONE) {
+        break;
+      }
+      else {
+        NDN_THROW(Error("Database query failure (code: " + std::to_string(rc) + ")"));
+      }
+    }
+
+    if (!hasSkipped || nRows < nRequested) {
+      break;
+    }
+    isLowerBoundIncluded = false;
+  }
+  return nEnumerated;
+}
+
+uint64_t
+SqliteStorage::size()
+{
+  auto& stmt = *m_countStmt;
+  StatementGuard guard(stmt);
+
+  int rc = stmt.step();
+  if (rc != SQLITE_ROW) {
+    NDN_LOG_DEBUG("Database query failure rc:" << rc);
+    NDN_THROW(Error("Database query failure"));
+  }
+
+  return sqlite3_column_int64(stmt, 0);
+}
+
+uint64_t
+SqliteStorage::bytes()
+{
+  auto& stmt = *m_bytesStmt;
+  StatementGuard guard(stmt);
+
+  int rc = stmt.step();
+  if (rc != SQLITE_ROW) {
+    NDN_LOG_DEBUG("Database query failure rc:" << rc);
+    NDN_THROW(Error("Database query failure"));
+  }
+
+  return sqlite3_column_int64(stmt, 0);
+}
+
+void
+SqliteStorage::initializePrefixSummary()
+{
+  execute("CREATE TABLE IF NOT EXISTS NDN_REPO_PREFIXES "
+          "(prefix BLOB PRIMARY KEY, count INTEGER NOT NULL) WITHOUT ROWID;");
+
+  {
+    ndn::util::Sqlite3Statement stmt(m_db,
+      "SELECT value FROM NDN_REPO_META WHERE key = 'prefix_suffix_length';");
+    if (stmt.step() == SQLITE_ROW) {
+      m_storedPrefixSuffixLength = sqlite3_column_int64(stmt, 0);
+    }
+  }
+
+  // The summary stays valid only while every modification maintains it. Until
+  // enablePrefixSummary() is called, the first insertion or deletion invalidates it, in the
+  // transaction of the modification, so that opening the database, e.g., by a tool that only
+  // reads it, or modifications rolled back leave it valid.
+  if (m_storedPrefixSuffixLength) {
+    execute("CREATE TEMP TRIGGER IF NOT EXISTS prefix_summary_insert AFTER INSERT ON main.NDN_REPO_V2 "
+            "BEGIN DELETE FROM NDN_REPO_META WHERE key = 'prefix_suffix_length'; END;");
+    execute("CREATE TEMP TRIGGER IF NOT EXISTS prefix_summary_delete AFTER DELETE ON main.NDN_REPO_V2 "
+            "BEGIN DELETE FROM NDN_REPO_META WHERE key = 'prefix_suffix_length'; END;");
+  }
+}
+
+bool
+SqliteStorage::enablePrefixSummary(size_t nSuffixComponents)
+{
+  execute("DROP TRIGGER IF EXISTS temp.prefix_summary_insert;");
+  execute("DROP TRIGGER IF EXISTS temp.prefix_summary_delete;");
+  {
+    // the summary may have been invalidated since the database was opened
+    ndn::util::Sqlite3Statement stmt(m_db,
+      "SELECT value FROM NDN_REPO_META WHERE key = 'prefix_suffix_length';");
+    m_storedPrefixSuffixLength.reset();
+    if (stmt.step() == SQLITE_ROW) {
+      m_storedPrefixSuffixLength = sqlite3_column_int64(stmt, 0);
+    }
+  }
+
+  if (m_storedPrefixSuffixLength != static_cast<int64_t>(nSuffixComponents)) {
+    rebuildPrefixSummary(nSuffixComponents);
+  }
+
+  ndn::util::Sqlite3Statement stmt(m_db,
+    "INSERT OR REPLACE INTO NDN_REPO_META (key, value) VALUES ('prefix_suffix_length', ?);");
+  sqlite3_bind_int64(stmt, 1, static_cast<int64_t>(nSuffixComponents));
+  if (stmt.step() != SQLITE_DONE) {
+    NDN_THROW(Error("Cannot store the prefix summary state"));
+  }
+
+  m_storedPrefixSuffixLength = nSuffixComponents;
+  m_prefixSuffixLength = nSuffixComponents;
+  return true;
+}
+
+void
+SqliteStorage::rebuildPrefixSummary(size_t nSuffixComponents)
+{
+  NDN_LOG_INFO("Rebuilding the prefix summary of " << m_dbPath);
+  auto start = time::steady_clock::now();
+
+  m_prefixSuffixLength = nSuffixComponents;
+  std::map<Name, int64_t> counts;
+  Cursor cursor(*this, {});
+  while (cursor.next()) {
+    ++counts[getRegistrationPrefix(cursor.getFullName().getPrefix(-1))];
+  }
+
+  withSavepoint([&] {
+    execute("DELETE FROM NDN_REPO_PREFIXES;");
+    for (const auto& [prefix, count] : counts) {
+      updatePrefixCount(prefix, count);
+    }
+    return counts.size();
+  });
+
+  NDN_LOG_INFO("Rebuilt the prefix summary with " << counts.size() << " prefixes in "
+               << time::duration_cast<time::milliseconds>(time::steady_clock::now() - start));
+}
+
+Name
+SqliteStorage::getRegistrationPrefix(const Name& dataName) const
+{
+  return dataName.getPrefix(-static_cast<ssize_t>(*m_prefixSuffixLength));
+}
+
+void
+SqliteStorage::updatePrefixCount(const Name& prefix, int64_t delta)
+{
+  const auto& value = prefix.wireEncode();
+  {
+    auto& stmt = *m_updatePrefixStmt;
+    StatementGuard guard(stmt);
+    stmt.bind(1, value.value(), value.value_size(), SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 2, delta);
+    int rc = stmt.step();
+    if (rc != SQLITE_DONE) {
+      NDN_LOG_DEBUG("Prefix count update failure rc:" << rc);
+      NDN_THROW(Error("Prefix count update failure (code: " + std::to_string(rc) + ")"));
+    }
+  }
+
+  if (delta < 0) {
+    auto& stmt = *m_deleteEmptyPrefixStmt;
+    StatementGuard guard(stmt);
+    stmt.bind(1, value.value(), value.value_size(), SQLITE_STATIC);
+    int rc = stmt.step();
+    if (rc != SQLITE_DONE) {
+      NDN_LOG_DEBUG("Prefix count delete failure rc:" << rc);
+      NDN_THROW(Error("Prefix count delete failure (code: " + std::to_string(rc) + ")"));
+    }
+  }
+}
+
+void
+SqliteStorage::forEachPrefixCount(const std::function<void(const Name& prefix, uint64_t count)>& f)
+{
+  ndn::util::Sqlite3Statement stmt(m_db, "SELECT prefix, count FROM NDN_REPO_PREFIXES;");
+
+  while (true) {
+    int rc = stmt.step();
+    if (rc == SQLITE_ROW) {
+      Name prefix;
+      try {
+        prefix = getName(stmt, 0);
+      }
+      catch (const ndn::tlv::Error& error) {
+        NDN_LOG_DEBUG("Error while decoding prefix from the database: " << error.what());
+        continue;
+      }
+      f(prefix, sqlite3_column_int64(stmt, 1));
+    }
+    else if (rc == SQLITE_DONE) {
+      break;
+    }
+    else {
+      NDN_THROW(Error("Database query failure (code: " + std::to_string(rc) + ")"));
+    }
+  }
+}
+
+bool
+SqliteStorage::checkPrefixSummary(size_t nEntries,
+                                  const std::function<void(const Name& prefix, int64_t delta)>& onCorrection)
+{
+  if (!m_prefixSuffixLength) {
+    return false;
+  }
+  if (sqlite3_get_autocommit(m_db) == 0) {
+    // the names counted by a step must not be rolled back afterwards
+    NDN_THROW(Error("The prefix summary cannot be checked within a transaction"));
+  }
+
+  if (m_prefixCheck == nullptr) {
+    execute("CREATE TEMP TABLE IF NOT EXISTS prefix_check_position (name BLOB NOT NULL);");
+    execute("CREATE TEMP TABLE IF NOT EXISTS prefix_check_changes "
+            "(name BLOB NOT NULL, delta INTEGER NOT NULL);");
+    execute("DELETE FROM prefix_check_position;");
+    execute("DELETE FROM prefix_check_changes;");
+    execute("INSERT INTO prefix_check_position (name) VALUES (X'');");
+    execute("CREATE TEMP TRIGGER IF NOT EXISTS prefix_check_insert AFTER INSERT ON main.NDN_REPO_V2 "
+            "WHEN NEW.name <= (SELECT name FROM prefix_check_position) "
+            "BEGIN INSERT INTO prefix_check_changes (name, delta) VALUES (NEW.name, 1); END;");
+    execute("CREATE TEMP TRIGGER IF NOT EXISTS prefix_check_delete AFTER DELETE ON main.NDN_REPO_V2 "
+            "WHEN OLD.name <= (SELECT name FROM prefix_check_position) "
+            "BEGIN INSERT INTO prefix_check_changes (name, delta) VALUES (OLD.name, -1); END;");
+    m_prefixCheck = std::make_unique<PrefixSummaryCheck>();
+    NDN_LOG_DEBUG("Started the prefix summary check");
+  }
+
+  auto& actual = m_prefixCheck->actual;
+  auto countName = [&] (ndn::util::Sqlite3Statement& stmt, int64_t delta) {
+    try {
+      actual[getRegistrationPrefix(getNameWithoutDigest(stmt, 0))] += delta;
+    }
+    catch (const ndn::tlv::Error& error) {
+      NDN_LOG_DEBUG("Error while decoding name from the database: " << error.what());
+    }
+  };
+
+  try {
+    size_t nRows = withSavepoint([&] {
+      // names already enumerated that were modified since the previous step
+      {
+        ndn::util::Sqlite3Statement stmt(m_db, "SELECT name, delta FROM prefix_check_changes;");
+        int rc = 0;
+        while ((rc = stmt.step()) == SQLITE_ROW) {
+          countName(stmt, sqlite3_column_int64(stmt, 1));
+        }
+        if (rc != SQLITE_DONE) {
+          NDN_THROW(Error("Database query failure (code: " + std::to_string(rc) + ")"));
+        }
+      }
+      execute("DELETE FROM prefix_check_changes;");
+
+      ndn::util::Sqlite3Statement stmt(m_db,
+        "SELECT name FROM NDN_REPO_V2 WHERE name > (SELECT name FROM prefix_check_position) "
+        "ORDER BY name LIMIT ?;");
+      sqlite3_bind_int64(stmt, 1, static_cast<int64_t>(nEntries));
+      size_t n = 0;
+      std::vector<uint8_t> lastName;
+      int rc = 0;
+      while ((rc = stmt.step()) == SQLITE_ROW) {
+        ++n;
+        lastName.assign(stmt.getBlob(0), stmt.getBlob(0) + stmt.getSize(0));
+        countName(stmt, 1);
+      }
+      if (rc != SQLITE_DONE) {
+        NDN_THROW(Error("Database query failure (code: " + std::to_string(rc) + ")"));
+      }
+
+      if (n > 0) {
+        ndn::util::Sqlite3Statement update(m_db, "UPDATE prefix_check_position SET name = ?;");
+        update.bind(1, lastName.data(), lastName.size(), SQLITE_STATIC);
+        if (update.step() != SQLITE_DONE) {
+          NDN_THROW(Error("Cannot store the prefix summary check position"));
+        }
+      }
+      return n;
+    });
+
+    if (nRows == nEntries) {
+      return true;
+    }
+    finishPrefixSummaryCheck(onCorrection);
+  }
+  catch (const Error&) {
+    m_prefixCheck.reset();
+    sqlite3_exec(m_db, "DROP TRIGGER IF EXISTS temp.prefix_check_insert; "
+                 "DROP TRIGGER IF EXISTS temp.prefix_check_delete;", nullptr, nullptr, nullptr);
+    throw;
+  }
+  return false;
+}
+
+void
+SqliteStorage::finishPrefixSummaryCheck(const std::function<void(const Name& prefix, int64_t delta)>& onCorrection)
+{
+  // All names were counted, including the ones modified during the check, so the counts
+  // are compared with the recorded ones as of now, within the same transaction.
+  std::map<Name, int64_t> corrections = std::move(m_prefixCheck->actual);
+  m_prefixCheck.reset();
+  withSavepoint([&] {
+    execute("DROP TRIGGER IF EXISTS temp.prefix_check_insert;");
+    execute("DROP TRIGGER IF EXISTS temp.prefix_check_delete;");
+
+    {
+      ndn::util::Sqlite3Statement stmt(m_db, "SELECT prefix, count FROM NDN_REPO_PREFIXES;");
+      int rc = 0;
+      while ((rc = stmt.step()) == SQLITE_ROW) {
+        corrections[getName(stmt, 0)] -= sqlite3_column_int64(stmt, 1);
+      }
+      if (rc != SQLITE_DONE) {
+        NDN_THROW(Error("Database query failure (code: " + std::to_string(rc) + ")"));
+      }
+    }
+
+    for (auto it = corrections.begin(); it != corrections.end();) {
+      it = it->second == 0 ? corrections.erase(it) : std::next(it);
+    }
+    for (const auto& [prefix, delta] : corrections) {
+      updatePrefixCount(prefix, delta);
+    }
+    return corrections.size();
+  });
+
+  NDN_LOG_INFO("Prefix summary check completed, " << corrections.size() << " prefixes corrected");
+  for (const auto& [prefix, delta] : corrections) {
+    NDN_LOG_WARN("Corrected the count of " << prefix << " by " << delta);
+    onCorrection(prefix, delta);
+  }
+}
+
+bool
+SqliteStorage::migrate(size_t nEntries)
+{
+  if (!m_migration) {
+    return false;
+  }
+
+  // Rows are migrated from the highest row id down, so that rows inserted since the schema
+  // changed, which have a higher row id, are not visited.
+  auto& migration = *m_migration;
+  const auto& rowMigration = *findRowMigration(migration.progress.version);
+  auto [nRows, nextRowid] = withSavepoint([&] {
+    ndn::util::Sqlite3Statement select(m_db,
+      "SELECT rowid, data FROM NDN_REPO_V2 WHERE rowid <= ? ORDER BY rowid DESC LIMIT ?;");
+    sqlite3_bind_int64(select, 1, migration.nextRowid);
+    sqlite3_bind_int64(select, 2, static_cast<int64_t>(nEntries));
+    ndn::util::Sqlite3Statement update(m_db, rowMigration.sql);
+    int rowidParameter = sqlite3_bind_parameter_count(update);
+
+    size_t nRows = 0;
+    int64_t rowid = migration.nextRowid + 1;
+    int rc = 0;
+    while ((rc = select.step()) == SQLITE_ROW) {
+      ++nRows;
+      rowid = sqlite3_column_int64(select, 0);
+      Data data;
+      try {
+        data.wireDecode(select.getBlock(1));
+      }
+      catch (const ndn::tlv::Error& error) {
+        NDN_LOG_DEBUG("Error while decoding data from the database: " << error.what());
+        continue;
+      }
+
+      StatementGuard guard(update);
+      int result = rowMigration.bind(update, data, migration.upgradeTime);
+      if (result == SQLITE_OK) {
+        result = sqlite3_bind_int64(update, rowidParameter, rowid);
+      }
+      if (result != SQLITE_OK || update.step() != SQLITE_DONE) {
+        NDN_THROW(Error("Migration of row " + std::to_string(rowid) + " failed"));
+      }
+    }
+    if (rc != SQLITE_DONE) {
+      NDN_THROW(Error("Database query failure (code: " + std::to_string(rc) + ")"));
+    }
+
+    ndn::util::Sqlite3Statement progress(m_db, nRows < nEntries ?
+      "DELETE FROM NDN_REPO_MIGRATIONS WHERE version = ?;" :
+      "UPDATE NDN_REPO_MIGRATIONS SET next_rowid = ?2, migrated = migrated + ?3 WHERE version = ?1;");
+    sqlite3_bind_int(progress, 1, migration.progress.version);
+    if (nRows == nEntries) {
+      sqlite3_bind_int64(progress, 2, rowid - 1);
+      sqlite3_bind_int64(progress, 3, static_cast<int64_t>(nRows));
+    }
+    if (progress.step() != SQLITE_DONE) {
+      NDN_THROW(Error("Cannot store the migration progress"));
+    }
+    return std::make_pair(nRows, rowid - 1);
+  });
+
+  migration.progress.nMigrated += nRows;
+  migration.nextRowid = nextRowid;
+  if (nRows == nEntries) {
+    return true;
+  }
+
+  NDN_LOG_INFO("Completed the migration of " << migration.progress.nMigrated
+               << " rows to schema version " << migration.progress.version);
+  loadMigration();
+  return m_migration.has_value();
+}
+
+Storage::MigrationProgress
+SqliteStorage::getMigrationProgress()
+{
+  return m_migration ? m_migration->progress : MigrationProgress{};
+}
+
+void
+SqliteStorage::beginTransaction()
+{
+  executeTransactionStatement(*m_beginStmt);
+}
+
+void
+SqliteStorage::commitTransaction()
+{
+  executeTransactionStatement(*m_commitStmt);
+  m_nameIndexJournal.clear();
+}
+
+void
+SqliteStorage::rollbackTransaction()
+{
+  undoIndexChanges(0);
+  executeTransactionStatement(*m_rollbackStmt);
+}
+
+void
+SqliteStorage::executeTransactionStatement(ndn::util::Sqlite3Statement& stmt)
+{
+  StatementGuard guard(stmt);
+  int rc = stmt.step();
+  if (rc != SQLITE_DONE) {
+    NDN_LOG_DEBUG("Transaction statement failure rc:" << rc);
+    NDN_THROW(Error("Transaction statement failure (code: " + std::to_string(rc) + ")"));
+  }
 }
 
 } // namespace repo
@@ -20,14 +20,36 @@
 #ifndef REPO_STORAGE_SQLITE_STORAGE_HPP
 #define REPO_STORAGE_SQLITE_STORAGE_HPP
 
+#include "name-trie.hpp"
 #include "storage.hpp"
 
 #include <sqlite3.h>
 
+#include <array>
+#include <optional>
+#include <set>
+
+namespace ndn::util {
+class Sqlite3Statement;
+} // namespace ndn::util
+
 namespace repo {
 
 class SqliteStorage : public Storage
 {
+public:
+  /**
+   *  @brief  a row listed by listInInsertionOrder()
+   */
+  struct InsertionOrderEntry
+  {
+    int64_t rowid;
+    /// milliseconds since the Unix epoch, unknown for rows stored before schema version 1
+    std::optional<int64_t> insertTime;
+    /// empty if the stored name cannot be decoded
+    Name fullName;
+  };
+
 public:
   explicit
   SqliteStorage(const std::string& dbPath);
@@ -42,6 +64,16 @@ public:
   int64_t
   insert(const Data& data) override;
 
+  bool
+  insertIfAbsent(const Data& data) override;
+
+  /**
+   *  @brief  insert the batch in a savepoint, after selecting its already stored names
+   *          with one query per chunk of names
+   */
+  std::vector<bool>
+  insertBatch(ndn::span<const Data> batch) override;
+
   /**
    *  @brief  remove the entry in the database by using name as index
    *  @param  name   name of the data
@@ -49,6 +81,13 @@ public:
   bool
   erase(const Name& name) override;
 
+  /**
+   *  @brief  remove a range of entries, selecting and deleting each chunk with one statement each
+   */
+  uint64_t
+  eraseRange(const Name& begin, const Name& end,
+             const std::function<void(const std::vector<Name>&)>& onChunk) override;
+
   std::shared_ptr<Data>
   read(const Name& name) override;
 
@@ -59,21 +98,305 @@ public:
   find(const Name& name, bool exactMatch = false) override;
 
   void
-  forEach(const std::function<void(const Name&)>& f) override;
+  asyncFind(const Name& name, bool exactMatch, const FindCallback& onResult) override;
+
+  /**
+   *  @brief  find the last data under @p prefix with a descending scan of the index on the
+   *          name column, which reads a single row, or in the name index if it is enabled
+   */
+  std::shared_ptr<Data>
+  findLast(const Name& prefix) override;
+
+  void
+  asyncFindLast(const Name& prefix, const FindCallback& onResult) override;
+
+  /**
+   *  @brief  find the data that can satisfy @p interest with a single query on the index on
+   *          the name column
+   *
+   *  Without CanBePrefix, the query is a probe for the Interest name followed by a digest.
+   *  With MustBeFresh, stale rows in the range are skipped on the fresh_until column, set
+   *  at insertion to the insertion time plus the FreshnessPeriod, without decoding them.
+   *  Rows stored before the schema had the column get it when they are migrated, with the
+   *  time of the schema upgrade as their insertion time.
+   */
+  std::shared_ptr<Data>
+  findMatch(const Interest& interest, bool isRightmost = false) override;
+
+  void
+  asyncFindMatch(const Interest& interest, bool isRightmost, const FindCallback& onResult) override;
+
+  /**
+   *  @brief  index the stored names and their row ids in a NameTrie, built from the names
+   *          column now and maintained with each modification
+   *
+   *  find(), findLast(), and has() then look up the row id in the trie, and read the Data by row id.
+   *  Lookups served by the connections of enableConcurrentReads() still query the names
+   *  column, since worker threads cannot access the trie.
+   */
+  bool
+  enableNameIndex(size_t maxBytes) override;
+
+  /**
+   *  @brief  serve asyncFind(), asyncFindLast(), and asyncFindMatch() through a pool of read-only connections, one per thread
+   */
+  bool
+  enableConcurrentReads(boost::asio::io_context& ioCtx, size_t nThreads) override;
+
+  void
+  forEachInInsertionOrder(const std::function<bool(const Name&)>& f) override;
+
+  std::vector<Name>
+  nextInInsertionOrder(InsertionOrderPosition& position, size_t limit) override;
+
+  /**
+   *  @brief  list up to @p limit rows in insertion order, after the row @p afterRowid
+   *
+   *  Each call is a short query, so that the rows of several databases can be merged in
+   *  insertion order without keeping a statement open on each of them.
+   */
+  std::vector<InsertionOrderEntry>
+  listInInsertionOrder(int64_t afterRowid, size_t limit);
+
+  /**
+   *  @brief  enumerate with one query served from the index on the name column; the Data
+   *          column is read only if requested
+   */
+  size_t
+  scan(const Range& range, size_t limit, bool withData, const ScanCallback& f) override;
 
   /**
    *  @brief  return the size of database
+   *
+   *  Read from a counter maintained on every insertion and deletion, in constant time.
    */
   uint64_t
   size() override;
 
+  /**
+   *  @brief  return the total size of the stored Data, in constant time
+   */
+  uint64_t
+  bytes() override;
+
+  /**
+   *  @brief  maintain registration prefix counts in the NDN_REPO_PREFIXES table
+   *
+   *  The table is rebuilt from the stored names if it was not maintained with the same
+   *  @p nSuffixComponents since it was last written, e.g., after the database was used
+   *  without a prefix summary.
+   */
+  bool
+  enablePrefixSummary(size_t nSuffixComponents) override;
+
+  void
+  forEachPrefixCount(const std::function<void(const Name& prefix, uint64_t count)>& f) override;
+
+  /**
+   *  @brief  check the prefix summary against the stored names, enumerated in steps of
+   *          @p nEntries names, each one a short transaction
+   *
+   *  Must be called outside a transaction.
+   */
+  bool
+  checkPrefixSummary(size_t nEntries,
+                     const std::function<void(const Name& prefix, int64_t delta)>& onCorrection) override;
+
+  /**
+   *  @brief  convert a batch of rows stored before the last schema upgrade, highest row id
+   *          first, recording the progress in NDN_REPO_MIGRATIONS so that a restart resumes it
+   *
+   *  The schema version is kept in PRAGMA user_version. Opening a database of an older
+   *  version upgrades its schema, and schedules the conversion of its rows if needed;
+   *  opening one of a newer version fails.
+   */
+  bool
+  migrate(size_t nEntries) override;
+
+  MigrationProgress
+  getMigrationProgress() override;
+
+  void
+  beginTransaction() override;
+
+  void
+  commitTransaction() override;
+
+  void
+  rollbackTransaction() override;
+
 private:
+  int64_t
+  doInsert(const Data& data);
+
+  bool
+  doInsertIfAbsent(const Data& data);
+
+  bool
+  doErase(const Name& name);
+
+  /**
+   *  @brief  return the TLV-VALUEs of the names in @p fullNames that are stored
+   */
+  std::set<std::vector<uint8_t>>
+  selectStoredNames(const std::vector<Name>& fullNames);
+
+  /**
+   *  @brief  run @p f in a savepoint, which is rolled back if @p f throws
+   */
+  template<typename Function>
+  auto
+  withSavepoint(Function&& f);
+
+  /**
+   *  @brief  add @p fullName to the name index, if enabled
+   */
+  void
+  indexInsert(const Name& fullName, int64_t id);
+
+  /**
+   *  @brief  remove @p fullName from the name index, if enabled
+   */
+  void
+  indexErase(const Name& fullName);
+
+  /**
+   *  @brief  revert the changes to the name index journaled after the first @p nKept changes
+   */
+  void
+  undoIndexChanges(size_t nKept);
+
+  void
+  dropNameIndex(const std::string& reason);
+
+  /**
+   *  @brief  read the Data in row @p id, falling back to a lookup of @p name with
+   *          @p fallbackStmt if it is missing
+   */
+  std::shared_ptr<Data>
+  readIndexed(int64_t id, const Name& name, ndn::util::Sqlite3Statement& fallbackStmt,
+              bool exactMatch);
+
+  void
+  initializePrefixSummary();
+
+  void
+  rebuildPrefixSummary(size_t nSuffixComponents);
+
+  Name
+  getRegistrationPrefix(const Name& dataName) const;
+
+  void
+  updatePrefixCount(const Name& prefix, int64_t delta);
+
+  void
+  finishPrefixSummaryCheck(const std::function<void(const Name& prefix, int64_t delta)>& onCorrection);
+
+  void
+  executeTransactionStatement(ndn::util::Sqlite3Statement& stmt);
+
   void
   initializeRepo();
 
+  /**
+   *  @brief  create the row and byte counters, computing them if the database has none
+   */
+  void
+  initializeCounters();
+
+  /**
+   *  @brief  execute @p sql without result rows, throwing Error on failure
+   */
+  void
+  execute(const char* sql);
+
+  /**
+   *  @brief  upgrade the schema to SCHEMA_VERSION, and load the pending row migration
+   */
+  void
+  migrateSchema();
+
+  /**
+   *  @brief  apply the schema changes of @p version, and schedule the migration of the
+   *          stored rows if it has one
+   */
+  void
+  upgradeSchema(int version);
+
+  /**
+   *  @brief  load the pending row migration of the lowest version, if any
+   */
+  void
+  loadMigration();
+
+  void
+  prepareStatements();
+
+  /**
+   *  @brief  finalize the statements and close the connection
+   */
+  void
+  close();
+
 private:
-  sqlite3* m_db;
+  sqlite3* m_db = nullptr;
   std::string m_dbPath;
+
+  // Statements used on every Interest and every inserted packet are compiled once
+  // and reset after each use, instead of being re-parsed and re-planned per call.
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_insertStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_insertIfAbsentStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_selectStoredStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_eraseStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_selectRangeStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_eraseRangeStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_findExactStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_findPrefixStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_findLastStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_findFreshStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_findLastFreshStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_findByIdStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_countStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_bytesStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_beginStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_commitStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_rollbackStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_savepointStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_releaseStmt;
+  /// scan() statements, one per combination of begin inclusion, end bound, and withData
+  std::array<std::unique_ptr<ndn::util::Sqlite3Statement>, 8> m_scanStmts;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_updatePrefixStmt;
+  std::unique_ptr<ndn::util::Sqlite3Statement> m_deleteEmptyPrefixStmt;
+
+  /// suffix length the prefix summary was last maintained with, if it is valid
+  std::optional<int64_t> m_storedPrefixSuffixLength;
+  /// suffix length of the maintained prefix summary, if enabled
+  std::optional<size_t> m_prefixSuffixLength;
+
+  struct PendingMigration
+  {
+    MigrationProgress progress;
+    int64_t nextRowid; ///< highest row id that is yet to be migrated
+    time::system_clock::time_point upgradeTime; ///< when the schema was upgraded
+  };
+  /// row migration in progress, if any
+  std::optional<PendingMigration> m_migration;
+
+  struct PrefixSummaryCheck;
+  std::unique_ptr<PrefixSummaryCheck> m_prefixCheck;
+
+  class ReaderPool;
+  std::unique_ptr<ReaderPool> m_readerPool;
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /// row ids of the stored names, if the name index is enabled
+  std::unique_ptr<NameTrie<int64_t>> m_nameIndex;
+
+private:
+  size_t m_nameIndexMaxBytes = 0;
+  /// changes to the name index in the open transaction, with the row id of erased names,
+  /// so that they can be reverted if the transaction is rolled back
+  std::vector<std::pair<Name, std::optional<int64_t>>> m_nameIndexJournal;
 };
 
 } // namespace repo
@@ -0,0 +1,66 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage.hpp"
+#include "cursor.hpp"
+
+namespace repo {
+
+/// number of data read at a time when looking for a fresh match, which is usually among the
+/// first ones under the Interest name
+const size_t MATCH_PAGE_SIZE = 16;
+
+std::shared_ptr<Data>
+Storage::findMatch(const Interest& interest, bool isRightmost)
+{
+  const Name& name = interest.getName();
+  if (isRightmost && interest.getCanBePrefix()) {
+    auto data = findLast(name);
+    return data != nullptr && interest.matchesData(*data) ? data : nullptr;
+  }
+
+  // data named as the Interest are the first under its name, since the implicit digest
+  // component has the lowest type
+  auto data = find(name);
+  if (data == nullptr || interest.matchesData(*data)) {
+    return data;
+  }
+  if (!interest.getMustBeFresh()) {
+    return nullptr;
+  }
+
+  // the first data may only be stale, and a later one under the name match
+  Cursor::Options options;
+  options.range = Cursor::makePrefixRange(name);
+  options.withData = true;
+  options.pageSize = MATCH_PAGE_SIZE;
+  Cursor cursor(*this, options);
+  while (cursor.next()) {
+    if (!interest.getCanBePrefix() && cursor.getFullName().size() > name.size() + 1) {
+      // past the data named as the Interest
+      break;
+    }
+    if (interest.matchesData(*cursor.getData())) {
+      return cursor.getData();
+    }
+  }
+  return nullptr;
+}
+
+} // namespace repo
@@ -47,6 +47,33 @@ public:
   virtual int64_t
   insert(const Data& data) = 0;
 
+  /**
+   *  @brief  put the data into database, unless data with the same full name is already stored
+   *  @return true if the data was inserted, false if it was already stored
+   */
+  virtual bool
+  insertIfAbsent(const Data& data) = 0;
+
+  /**
+   *  @brief  put each data in @p batch into database, as insertIfAbsent() does
+   *
+   *  Data with the same full name as stored data, or as an earlier data in the batch, are
+   *  not inserted. By default, data are inserted one at a time; backends with transaction
+   *  support insert the batch atomically, with a single check for already stored names.
+   *
+   *  @return whether each data was inserted, in the order of @p batch
+   */
+  virtual std::vector<bool>
+  insertBatch(ndn::span<const Data> batch)
+  {
+    std::vector<bool> isInserted;
+    isInserted.reserve(batch.size());
+    for (const auto& data : batch) {
+      isInserted.push_back(insertIfAbsent(data));
+    }
+    return isInserted;
+  }
+
   /**
    *  @brief  remove the entry in the database by full name
    *  @param  full name   full name of the data
@@ -54,6 +81,19 @@ public:
   virtual bool
   erase(const Name& name) = 0;
 
+  /**
+   *  @brief  remove all entries whose full names are in the range [@p begin, @p end)
+   *
+   *  Names are ordered by their TLV encoding, so the range [prefix, prefix.getSuccessor())
+   *  covers all names starting with prefix. Entries are erased in chunks; after each chunk
+   *  is erased, @p onChunk is called with the full names of its entries.
+   *
+   *  @return number of erased entries
+   */
+  virtual uint64_t
+  eraseRange(const Name& begin, const Name& end,
+             const std::function<void(const std::vector<Name>&)>& onChunk) = 0;
+
   /**
    *  @brief  get the data from database
    *  @param  full name   full name of the data
@@ -75,17 +115,396 @@ public:
   virtual std::shared_ptr<Data>
   find(const Name& name, bool exactMatch = false) = 0;
 
-   /**
-   *  @brief Enumerate each entry in database and call @p f with name of stored data
+  using FindCallback = std::function<void(std::shared_ptr<Data>)>;
+
+  /**
+   *  @brief  find the data as find() does, and call @p onResult with the result
+   *
+   *  By default, the lookup is done and @p onResult is called before returning. After
+   *  enableConcurrentReads(), the lookup may be done on a worker thread, and @p onResult is
+   *  then called later on the io_context; it is not called if the storage is destroyed first.
+   */
+  virtual void
+  asyncFind(const Name& name, bool exactMatch, const FindCallback& onResult)
+  {
+    onResult(find(name, exactMatch));
+  }
+
+  /**
+   *  @brief  find the data whose full name is the last one starting with @p prefix, in the
+   *          order of the TLV encoding
+   *
+   *  This is the rightmost descendant of @p prefix, e.g., the latest version when versions
+   *  are the next component, while find() returns the leftmost one.
+   */
+  virtual std::shared_ptr<Data>
+  findLast(const Name& prefix) = 0;
+
+  /**
+   *  @brief  find the data as findLast() does, and call @p onResult with the result
+   *  @sa     asyncFind
+   */
+  virtual void
+  asyncFindLast(const Name& prefix, const FindCallback& onResult)
+  {
+    onResult(findLast(prefix));
+  }
+
+  /**
+   *  @brief  find the first data, in name order, that can satisfy @p interest
+   *  @param  isRightmost  with CanBePrefix, find the last matching data instead
+   *
+   *  Unlike find(), this honors the CanBePrefix and MustBeFresh fields: without CanBePrefix,
+   *  only data named as the Interest, or with the Interest name as full name, match.
+   *  A backend that records insertion times matches only data within their FreshnessPeriod
+   *  for MustBeFresh. By default, data with a positive FreshnessPeriod are fresh, and only
+   *  the last data is considered for a rightmost match.
+   */
+  virtual std::shared_ptr<Data>
+  findMatch(const Interest& interest, bool isRightmost = false);
+
+  /**
+   *  @brief  find the data as findMatch() does, and call @p onResult with the result
+   *  @sa     asyncFind
+   */
+  virtual void
+  asyncFindMatch(const Interest& interest, bool isRightmost, const FindCallback& onResult)
+  {
+    onResult(findMatch(interest, isRightmost));
+  }
+
+  using InsertCallback = std::function<void(bool isInserted)>;
+  using EraseRangeCallback = std::function<void(uint64_t nErased)>;
+  using ErrorCallback = std::function<void(const std::string& reason)>;
+
+  /**
+   *  @brief  insert the data as insertIfAbsent() does, and call @p onInserted with the result
+   *
+   *  By default, the insertion is done and one of the callbacks is called before returning.
+   *  A storage that runs operations on its own thread calls them later, on the io_context,
+   *  in the order the operations were started.
+   */
+  virtual void
+  asyncInsert(const Data& data, const InsertCallback& onInserted, const ErrorCallback& onFailure)
+  {
+    bool isInserted = false;
+    try {
+      isInserted = insertIfAbsent(data);
+    }
+    catch (const Error& e) {
+      onFailure(e.what());
+      return;
+    }
+    onInserted(isInserted);
+  }
+
+  using InsertBatchCallback = std::function<void(const std::vector<bool>& isInserted)>;
+
+  /**
+   *  @brief  insert the data as insertBatch() does, and call @p onInserted with the result
+   *
+   *  @p batch is copied if the insertion is done after returning. The callbacks are called
+   *  as those of asyncInsert().
+   */
+  virtual void
+  asyncInsertBatch(ndn::span<const Data> batch, const InsertBatchCallback& onInserted,
+                   const ErrorCallback& onFailure)
+  {
+    std::vector<bool> isInserted;
+    try {
+      isInserted = insertBatch(batch);
+    }
+    catch (const Error& e) {
+      onFailure(e.what());
+      return;
+    }
+    onInserted(isInserted);
+  }
+
+  /**
+   *  @brief  erase entries as eraseRange() does, and call @p onErased with their number
+   *
+   *  @p onChunk is called for each erased chunk before @p onErased, at the same time as
+   *  the callbacks of asyncInsert().
+   */
+  virtual void
+  asyncEraseRange(const Name& begin, const Name& end,
+                  const std::function<void(const std::vector<Name>&)>& onChunk,
+                  const EraseRangeCallback& onErased, const ErrorCallback& onFailure)
+  {
+    uint64_t nErased = 0;
+    try {
+      nErased = eraseRange(begin, end, onChunk);
+    }
+    catch (const Error& e) {
+      onFailure(e.what());
+      return;
+    }
+    onErased(nErased);
+  }
+
+  using Operation = std::function<void(Storage& storage)>;
+
+  /**
+   *  @brief  call @p operation with the storage, then @p onDone, or @p onFailure with the
+   *          reason of the Error it throws
+   *
+   *  This runs the operations that have no asynchronous form without waiting for them,
+   *  e.g., the steps of background maintenance. A storage that runs operations on its own
+   *  thread calls @p operation there, with the storage it wraps, so @p operation must use
+   *  only that storage and what it captures. The callbacks are called as those of
+   *  asyncInsert().
+   */
+  virtual void
+  asyncRun(const Operation& operation, const std::function<void()>& onDone,
+           const ErrorCallback& onFailure)
+  {
+    try {
+      operation(*this);
+    }
+    catch (const Error& e) {
+      onFailure(e.what());
+      return;
+    }
+    onDone();
+  }
+
+  /**
+   *  @brief  serve asyncFind() on @p nThreads worker threads, and deliver results on @p ioCtx
+   *
+   *  Lookups on worker threads see committed modifications only; a lookup made while a
+   *  transaction is open is done synchronously, so that it sees the pending modifications.
+   *
+   *  @return false if the storage does not support concurrent lookups
+   */
+  virtual bool
+  enableConcurrentReads(boost::asio::io_context& ioCtx, size_t nThreads)
+  {
+    return false;
+  }
+
+  /**
+   *  @brief  keep an index of the stored names in memory, to serve exact and prefix lookups
+   *          without searching the storage
+   *  @param  maxBytes  memory the index may use; a storage whose index outgrows it drops the
+   *                    index and serves lookups without it
+   *  @return false if the storage does not support a name index, or the index of the stored
+   *          names does not fit in @p maxBytes
+   */
+  virtual bool
+  enableNameIndex(size_t maxBytes)
+  {
+    return false;
+  }
+
+  /**
+   *  @brief  Enumerate full names of stored data in insertion order, oldest first
+   *
+   *  Enumeration stops when @p f returns false. @p f must not modify the storage.
    */
   virtual void
-  forEach(const std::function<void(const Name&)>& f) = 0;
+  forEachInInsertionOrder(const std::function<bool(const Name&)>& f) = 0;
+
+  /**
+   *  @brief  Position in the insertion order of stored data, see nextInInsertionOrder()
+   *
+   *  A default-constructed position is before the oldest entry. Its content is specific to
+   *  the storage that moved it.
+   */
+  struct InsertionOrderPosition
+  {
+    std::vector<uint64_t> sequences;
+  };
+
+  /**
+   *  @brief  List the full names of up to @p limit stored data that follow @p position in
+   *          insertion order, oldest first, and move @p position past them
+   *
+   *  Data inserted later follow all data stored before, so a position can be kept to
+   *  continue the enumeration in another event. Fewer than @p limit names are listed only
+   *  when the end is reached.
+   */
+  virtual std::vector<Name>
+  nextInInsertionOrder(InsertionOrderPosition& position, size_t limit) = 0;
+
+  /**
+   *  @brief  Range of full names, in the order of their TLV encoding as in eraseRange()
+   */
+  struct Range
+  {
+    Name begin;                  ///< lower bound; the empty name is below all names
+    bool isBeginIncluded = true; ///< whether @c begin itself is in the range
+    Name end;                    ///< exclusive upper bound; empty for no upper bound
+  };
+
+  using ScanCallback = std::function<void(const Name& fullName, std::shared_ptr<Data> data)>;
+
+  /**
+   *  @brief  Enumerate up to @p limit stored entries whose full names are in @p range
+   *
+   *  Entries are enumerated in the order of their full names. @p f is called with the full
+   *  name of each entry and, if @p withData is true, with its Data; otherwise with nullptr.
+   *  @p f must not modify the storage. Cursor builds resumable enumerations on this.
+   *
+   *  @return number of enumerated entries; less than @p limit when the end of @p range is
+   *          reached
+   */
+  virtual size_t
+  scan(const Range& range, size_t limit, bool withData, const ScanCallback& f) = 0;
 
   /**
    *  @brief  return the size of database
    */
   virtual uint64_t
   size() = 0;
+
+  /**
+   *  @brief  return the total size in bytes of stored data packets
+   */
+  virtual uint64_t
+  bytes() = 0;
+
+  using UsageCallback = std::function<void(uint64_t nPackets, uint64_t nBytes)>;
+
+  /**
+   *  @brief  call @p onResult with size() and bytes()
+   *
+   *  The callbacks are called as those of asyncInsert(), and the result includes the
+   *  operations started before.
+   */
+  virtual void
+  asyncUsage(const UsageCallback& onResult, const ErrorCallback& onFailure)
+  {
+    uint64_t nPackets = 0;
+    uint64_t nBytes = 0;
+    try {
+      nPackets = size();
+      nBytes = bytes();
+    }
+    catch (const Error& e) {
+      onFailure(e.what());
+      return;
+    }
+    onResult(nPackets, nBytes);
+  }
+
+  /**
+   *  @brief  maintain the number of stored data under each registration prefix
+   *
+   *  The registration prefix of data is its name (without implicit digest) with the last
+   *  @p nSuffixComponents components removed. The counts are updated in the same transaction
+   *  as insertions and deletions, so that they can be loaded at startup instead of
+   *  enumerating all stored data.
+   *
+   *  @return false if the storage does not support prefix summaries
+   */
+  virtual bool
+  enablePrefixSummary(size_t nSuffixComponents)
+  {
+    return false;
+  }
+
+  /**
+   *  @brief  Enumerate registration prefixes and the number of stored data under each
+   *  @pre    enablePrefixSummary() returned true
+   */
+  virtual void
+  forEachPrefixCount(const std::function<void(const Name& prefix, uint64_t count)>& f)
+  {
+  }
+
+  /**
+   *  @brief  Perform one step of a consistency check of the prefix summary
+   *
+   *  The first call starts the check on a snapshot of the storage, and each call examines
+   *  up to @p nEntries stored entries. After all entries are examined, counts that disagree
+   *  with the snapshot are corrected, and @p onCorrection is called with each corrected
+   *  prefix and the difference applied to its count.
+   *
+   *  @return true if more steps are needed, false when the check is complete
+   */
+  virtual bool
+  checkPrefixSummary(size_t nEntries,
+                     const std::function<void(const Name& prefix, int64_t delta)>& onCorrection)
+  {
+    return false;
+  }
+
+  /**
+   *  @brief  Progress of the migration of stored entries to a new schema version
+   */
+  struct MigrationProgress
+  {
+    int version = 0;        ///< schema version migrated to; 0 if no migration is in progress
+    uint64_t nMigrated = 0; ///< number of entries migrated so far
+    uint64_t nEntries = 0;  ///< number of entries stored when the migration started
+  };
+
+  /**
+   *  @brief  Perform one step of the migration of entries stored under an older schema version
+   *
+   *  A storage whose schema changed applies the change when it is opened, and converts the
+   *  entries stored before in the background, while serving. Each call converts up to
+   *  @p nEntries entries. Entries inserted since are stored in the new schema.
+   *
+   *  @return true if more steps are needed, false when no migration is in progress
+   */
+  virtual bool
+  migrate(size_t nEntries)
+  {
+    return false;
+  }
+
+  virtual MigrationProgress
+  getMigrationProgress()
+  {
+    return {};
+  }
+
+  /**
+   *  @brief  start a transaction that groups subsequent modifications until commitTransaction()
+   *
+   *  Storage backends without transaction support may treat this as a no-op.
+   */
+  virtual void
+  beginTransaction()
+  {
+  }
+
+  /**
+   *  @brief  begin a transaction as beginTransaction() does, without waiting for it
+   *
+   *  The operations started afterwards are part of the transaction. @p onFailure is called
+   *  as the failure callback of asyncInsert(); the operations then run outside of any
+   *  transaction.
+   */
+  virtual void
+  asyncBeginTransaction(const ErrorCallback& onFailure)
+  {
+    try {
+      beginTransaction();
+    }
+    catch (const Error& e) {
+      onFailure(e.what());
+    }
+  }
+
+  /**
+   *  @brief  make all modifications since beginTransaction() durable
+   *  @throw  Error the transaction could not be committed
+   */
+  virtual void
+  commitTransaction()
+  {
+  }
+
+  /**
+   *  @brief  discard all modifications since beginTransaction()
+   */
+  virtual void
+  rollbackTransaction()
+  {
+  }
 };
 
 } // namespace repo
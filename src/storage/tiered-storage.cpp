@@ -0,0 +1,373 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tiered-storage.hpp"
+
+#include <ndn-cxx/util/logger.hpp>
+
+#include <limits>
+
+namespace repo {
+
+NDN_LOG_INIT(repo.TieredStorage);
+
+namespace {
+
+/// hit counts are halved after this many accesses
+const uint64_t AGING_INTERVAL = 100000;
+
+} // namespace
+
+TieredStorage::TieredStorage(std::shared_ptr<Storage> cold, uint64_t hotBytes)
+  : m_cold(std::move(cold))
+  , m_maxHotBytes(hotBytes)
+{
+  NDN_LOG_DEBUG("Caching up to " << m_maxHotBytes << " bytes in memory");
+}
+
+uint64_t
+TieredStorage::countAccess()
+{
+  if (++m_nAccesses % AGING_INTERVAL == 0) {
+    ageFrequencies();
+  }
+  return m_nAccesses;
+}
+
+void
+TieredStorage::ageFrequencies()
+{
+  m_demotionOrder.clear();
+  for (auto& [name, entry] : m_entries) {
+    entry.frequency /= 2;
+    m_demotionOrder.emplace(entry.frequency, entry.lastAccess, name);
+  }
+}
+
+std::shared_ptr<Data>
+TieredStorage::lookupHot(const Name& name)
+{
+  auto it = m_entries.find(name);
+  if (it == m_entries.end()) {
+    return nullptr;
+  }
+
+  uint64_t access = countAccess();
+  auto& entry = it->second;
+  m_demotionOrder.erase(DemotionKey(entry.frequency, entry.lastAccess, name));
+  if (entry.frequency < std::numeric_limits<uint32_t>::max()) {
+    ++entry.frequency;
+  }
+  entry.lastAccess = access;
+  m_demotionOrder.emplace(entry.frequency, entry.lastAccess, name);
+
+  // the copy shares the wire encoding of the cached Data
+  return std::make_shared<Data>(*entry.data);
+}
+
+void
+TieredStorage::admit(const Name& name, std::shared_ptr<const Data> data)
+{
+  uint64_t size = data->wireEncode().size();
+  if (size > m_maxHotBytes) {
+    return;
+  }
+
+  auto existing = m_entries.find(name);
+  if (existing != m_entries.end()) {
+    removeHot(existing);
+  }
+  while (m_hotBytes + size > m_maxHotBytes) {
+    removeHot(m_entries.find(std::get<Name>(*m_demotionOrder.begin())));
+  }
+
+  uint64_t lastAccess = countAccess();
+  m_entries.emplace(name, Entry{std::move(data), size, 1, lastAccess});
+  m_demotionOrder.emplace(1, lastAccess, name);
+  m_hotBytes += size;
+}
+
+void
+TieredStorage::removeHot(std::unordered_map<Name, Entry>::iterator it)
+{
+  const auto& entry = it->second;
+  m_demotionOrder.erase(DemotionKey(entry.frequency, entry.lastAccess, it->first));
+  m_hotBytes -= entry.size;
+  m_entries.erase(it);
+}
+
+void
+TieredStorage::invalidate(const Name& fullName)
+{
+  ++m_nModifications;
+  if (m_entries.empty()) {
+    return;
+  }
+  for (size_t length = 0; length <= fullName.size(); ++length) {
+    auto it = m_entries.find(fullName.getPrefix(length));
+    if (it != m_entries.end()) {
+      removeHot(it);
+    }
+  }
+}
+
+void
+TieredStorage::afterInsert(const Data& data)
+{
+  const Name& fullName = data.getFullName();
+  invalidate(fullName);
+
+  // Recently inserted Data are the most likely to be requested soon. They are admitted under
+  // their full name, which no other Data can match, so that no lookup in the cold tier is
+  // needed; a lookup by name admits them under that name when it reads them.
+  admit(fullName, std::make_shared<const Data>(data));
+}
+
+int64_t
+TieredStorage::insert(const Data& data)
+{
+  auto id = m_cold->insert(data);
+  afterInsert(data);
+  return id;
+}
+
+bool
+TieredStorage::insertIfAbsent(const Data& data)
+{
+  if (!m_cold->insertIfAbsent(data)) {
+    return false;
+  }
+  afterInsert(data);
+  return true;
+}
+
+std::vector<bool>
+TieredStorage::insertBatch(ndn::span<const Data> batch)
+{
+  auto isInserted = m_cold->insertBatch(batch);
+  for (size_t i = 0; i < batch.size(); ++i) {
+    if (isInserted[i]) {
+      afterInsert(batch[i]);
+    }
+  }
+  return isInserted;
+}
+
+bool
+TieredStorage::erase(const Name& name)
+{
+  if (!m_cold->erase(name)) {
+    return false;
+  }
+  invalidate(name);
+  return true;
+}
+
+uint64_t
+TieredStorage::eraseRange(const Name& begin, const Name& end,
+                          const std::function<void(const std::vector<Name>&)>& onChunk)
+{
+  return m_cold->eraseRange(begin, end, [&] (const std::vector<Name>& names) {
+    for (const auto& name : names) {
+      invalidate(name);
+    }
+    onChunk(names);
+  });
+}
+
+std::shared_ptr<Data>
+TieredStorage::read(const Name& name)
+{
+  return find(name);
+}
+
+bool
+TieredStorage::has(const Name& name)
+{
+  auto it = m_entries.find(name);
+  if (it != m_entries.end() && it->second.data->getFullName() == name) {
+    return true;
+  }
+  return m_cold->has(name);
+}
+
+std::shared_ptr<Data>
+TieredStorage::find(const Name& name, bool exactMatch)
+{
+  auto data = lookupHot(name);
+  if (data != nullptr && (!exactMatch || data->getFullName() == name)) {
+    return data;
+  }
+
+  data = m_cold->find(name, exactMatch);
+  if (data != nullptr) {
+    // an exact match is also the result of a prefix lookup of the same full name
+    admit(name, std::make_shared<const Data>(*data));
+  }
+  return data;
+}
+
+void
+TieredStorage::asyncFind(const Name& name, bool exactMatch, const FindCallback& onResult)
+{
+  auto data = lookupHot(name);
+  if (data != nullptr && (!exactMatch || data->getFullName() == name)) {
+    onResult(data);
+    return;
+  }
+
+  m_cold->asyncFind(name, exactMatch,
+    [this, name, onResult, isAlive = std::weak_ptr<int>(m_aliveToken),
+     nModifications = m_nModifications] (std::shared_ptr<Data> data) {
+      if (!isAlive.expired() && data != nullptr && nModifications == m_nModifications) {
+        admit(name, std::make_shared<const Data>(*data));
+      }
+      onResult(std::move(data));
+    });
+}
+
+std::shared_ptr<Data>
+TieredStorage::findLast(const Name& prefix)
+{
+  return m_cold->findLast(prefix);
+}
+
+void
+TieredStorage::asyncFindLast(const Name& prefix, const FindCallback& onResult)
+{
+  m_cold->asyncFindLast(prefix, onResult);
+}
+
+std::shared_ptr<Data>
+TieredStorage::findMatch(const Interest& interest, bool isRightmost)
+{
+  if (interest.getMustBeFresh() || (isRightmost && interest.getCanBePrefix())) {
+    return m_cold->findMatch(interest, isRightmost);
+  }
+  return Storage::findMatch(interest, isRightmost);
+}
+
+void
+TieredStorage::asyncFindMatch(const Interest& interest, bool isRightmost, const FindCallback& onResult)
+{
+  if (interest.getMustBeFresh() || (isRightmost && interest.getCanBePrefix())) {
+    m_cold->asyncFindMatch(interest, isRightmost, onResult);
+    return;
+  }
+  asyncFind(interest.getName(), false, [interest, onResult] (std::shared_ptr<Data> data) {
+    onResult(data != nullptr && interest.matchesData(*data) ? std::move(data) : nullptr);
+  });
+}
+
+bool
+TieredStorage::enableConcurrentReads(boost::asio::io_context& ioCtx, size_t nThreads)
+{
+  return m_cold->enableConcurrentReads(ioCtx, nThreads);
+}
+
+bool
+TieredStorage::enableNameIndex(size_t maxBytes)
+{
+  return m_cold->enableNameIndex(maxBytes);
+}
+
+void
+TieredStorage::forEachInInsertionOrder(const std::function<bool(const Name&)>& f)
+{
+  m_cold->forEachInInsertionOrder(f);
+}
+
+std::vector<Name>
+TieredStorage::nextInInsertionOrder(InsertionOrderPosition& position, size_t limit)
+{
+  return m_cold->nextInInsertionOrder(position, limit);
+}
+
+size_t
+TieredStorage::scan(const Range& range, size_t limit, bool withData, const ScanCallback& f)
+{
+  return m_cold->scan(range, limit, withData, f);
+}
+
+uint64_t
+TieredStorage::size()
+{
+  return m_cold->size();
+}
+
+uint64_t
+TieredStorage::bytes()
+{
+  return m_cold->bytes();
+}
+
+bool
+TieredStorage::enablePrefixSummary(size_t nSuffixComponents)
+{
+  return m_cold->enablePrefixSummary(nSuffixComponents);
+}
+
+void
+TieredStorage::forEachPrefixCount(const std::function<void(const Name& prefix, uint64_t count)>& f)
+{
+  m_cold->forEachPrefixCount(f);
+}
+
+bool
+TieredStorage::checkPrefixSummary(size_t nEntries,
+                                  const std::function<void(const Name&, int64_t)>& onCorrection)
+{
+  return m_cold->checkPrefixSummary(nEntries, onCorrection);
+}
+
+bool
+TieredStorage::migrate(size_t nEntries)
+{
+  return m_cold->migrate(nEntries);
+}
+
+Storage::MigrationProgress
+TieredStorage::getMigrationProgress()
+{
+  return m_cold->getMigrationProgress();
+}
+
+void
+TieredStorage::beginTransaction()
+{
+  m_cold->beginTransaction();
+}
+
+void
+TieredStorage::commitTransaction()
+{
+  m_cold->commitTransaction();
+}
+
+void
+TieredStorage::rollbackTransaction()
+{
+  m_cold->rollbackTransaction();
+  ++m_nModifications;
+  m_entries.clear();
+  m_demotionOrder.clear();
+  m_hotBytes = 0;
+}
+
+} // namespace repo
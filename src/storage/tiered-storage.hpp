@@ -0,0 +1,233 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_STORAGE_TIERED_STORAGE_HPP
+#define REPO_STORAGE_TIERED_STORAGE_HPP
+
+#include "storage.hpp"
+
+#include <set>
+#include <tuple>
+#include <unordered_map>
+
+namespace repo {
+
+/**
+ * @brief Storage that serves frequently read Data from memory, in front of another Storage
+ *
+ * All Data are stored in the cold tier, and all modifications go to it. The hot tier caches
+ * the results of lookups, keyed by the looked up name, within a byte budget: inserted Data
+ * are admitted under their full name, Data read from the cold tier under the looked up name,
+ * and the entries that were hit the least often are demoted first. Hit counts are halved periodically, so that Data that are no
+ * longer popular can be demoted.
+ *
+ * A modification invalidates the cached lookups of all prefixes of the modified full name,
+ * so the hot tier returns the same Data as the cold tier would.
+ */
+class TieredStorage : public Storage
+{
+public:
+  /**
+   * @param cold the storage holding all Data
+   * @param hotBytes the maximum total size of Data cached in memory
+   */
+  TieredStorage(std::shared_ptr<Storage> cold, uint64_t hotBytes);
+
+  int64_t
+  insert(const Data& data) override;
+
+  bool
+  insertIfAbsent(const Data& data) override;
+
+  std::vector<bool>
+  insertBatch(ndn::span<const Data> batch) override;
+
+  bool
+  erase(const Name& name) override;
+
+  uint64_t
+  eraseRange(const Name& begin, const Name& end,
+             const std::function<void(const std::vector<Name>&)>& onChunk) override;
+
+  std::shared_ptr<Data>
+  read(const Name& name) override;
+
+  bool
+  has(const Name& name) override;
+
+  std::shared_ptr<Data>
+  find(const Name& name, bool exactMatch = false) override;
+
+  /**
+   * @brief Serve hits from the hot tier right away, and look up misses in the cold tier
+   *
+   * A result from the cold tier is admitted only if no modification happened during the
+   * lookup, as it may be outdated otherwise.
+   */
+  void
+  asyncFind(const Name& name, bool exactMatch, const FindCallback& onResult) override;
+
+  /**
+   * @brief Look up in the cold tier, bypassing the hot tier
+   *
+   * The hot tier is keyed by the lookup name and holds leftmost matches, and the last
+   * Data under a prefix changes with the insertions under it.
+   */
+  std::shared_ptr<Data>
+  findLast(const Name& prefix) override;
+
+  void
+  asyncFindLast(const Name& prefix, const FindCallback& onResult) override;
+
+  /**
+   * @brief Serve the first Data under the Interest name as find() does, through the hot tier,
+   *        and look up other matches in the cold tier
+   *
+   * The hot tier cannot tell whether Data are fresh, so Interests with MustBeFresh bypass it,
+   * as do rightmost matches.
+   */
+  std::shared_ptr<Data>
+  findMatch(const Interest& interest, bool isRightmost = false) override;
+
+  void
+  asyncFindMatch(const Interest& interest, bool isRightmost, const FindCallback& onResult) override;
+
+  bool
+  enableNameIndex(size_t maxBytes) override;
+
+  bool
+  enableConcurrentReads(boost::asio::io_context& ioCtx, size_t nThreads) override;
+
+  void
+  forEachInInsertionOrder(const std::function<bool(const Name&)>& f) override;
+
+  std::vector<Name>
+  nextInInsertionOrder(InsertionOrderPosition& position, size_t limit) override;
+
+  size_t
+  scan(const Range& range, size_t limit, bool withData, const ScanCallback& f) override;
+
+  uint64_t
+  size() override;
+
+  uint64_t
+  bytes() override;
+
+  bool
+  enablePrefixSummary(size_t nSuffixComponents) override;
+
+  void
+  forEachPrefixCount(const std::function<void(const Name& prefix, uint64_t count)>& f) override;
+
+  bool
+  checkPrefixSummary(size_t nEntries,
+                     const std::function<void(const Name&, int64_t)>& onCorrection) override;
+
+  bool
+  migrate(size_t nEntries) override;
+
+  MigrationProgress
+  getMigrationProgress() override;
+
+  void
+  beginTransaction() override;
+
+  void
+  commitTransaction() override;
+
+  /**
+   * @brief Roll back the cold tier and empty the hot tier, which may hold rolled back Data
+   */
+  void
+  rollbackTransaction() override;
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  size_t
+  getNHotEntries() const
+  {
+    return m_entries.size();
+  }
+
+  uint64_t
+  getHotBytes() const
+  {
+    return m_hotBytes;
+  }
+
+private:
+  struct Entry
+  {
+    std::shared_ptr<const Data> data;
+    uint64_t size;
+    uint32_t frequency;
+    uint64_t lastAccess;
+  };
+
+  /// (frequency, last access, name), ordered from the first to the last to be demoted
+  using DemotionKey = std::tuple<uint32_t, uint64_t, Name>;
+
+private:
+  std::shared_ptr<Data>
+  lookupHot(const Name& name);
+
+  void
+  admit(const Name& name, std::shared_ptr<const Data> data);
+
+  void
+  removeHot(std::unordered_map<Name, Entry>::iterator it);
+
+  /**
+   * @brief Remove cached lookups of @p fullName and of all its prefixes
+   */
+  void
+  invalidate(const Name& fullName);
+
+  /**
+   * @brief Invalidate the lookups affected by an insertion into the cold tier, and admit @p data
+   *        under its full name
+   */
+  void
+  afterInsert(const Data& data);
+
+  /**
+   * @brief Count an access, and halve all hit counts periodically
+   * @return the access counter, used to order entries with equal hit counts
+   */
+  uint64_t
+  countAccess();
+
+  void
+  ageFrequencies();
+
+private:
+  std::shared_ptr<Storage> m_cold;
+  const uint64_t m_maxHotBytes;
+  uint64_t m_hotBytes = 0;
+  std::unordered_map<Name, Entry> m_entries;
+  std::set<DemotionKey> m_demotionOrder;
+  uint64_t m_nAccesses = 0;
+  /// incremented on every modification of the cold tier
+  uint64_t m_nModifications = 0;
+  /// whether results of cold tier lookups may still be delivered after destruction
+  std::shared_ptr<int> m_aliveToken = std::make_shared<int>();
+};
+
+} // namespace repo
+
+#endif // REPO_STORAGE_TIERED_STORAGE_HPP
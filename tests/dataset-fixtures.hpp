@@ -116,64 +116,71 @@ public:
   FetchByPrefixDataset()
   {
     this->data.push_back(createData("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s/t/u/v/w/x/y/z"));
-    this->interests.push_back(std::make_pair(Interest("/a"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d/e"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d/e"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d/e/f"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d/e/f"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d/e/f/g"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d/e/f/g/h"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d/e/f/g/h/i"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d/e/f/g/h/i/j"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i/j"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d/e/f/g/h/i/j/k"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i/j/k"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d/e/f/g/h/i/j/k/l"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i/j/k/l"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d/e/f/g/h/i/j/k/l/m"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i/j/k/l/m"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s/t"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s/t"),
                                              this->data.back()));
-    this->interests.push_back(std::make_pair(Interest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s/t/u"),
+    this->interests.push_back(std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s/t/u"),
                                              this->data.back()));
     this->interests.push_back(
-      std::make_pair(Interest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s/t/u/v"),
+      std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s/t/u/v"),
                      this->data.back()));
     this->interests.push_back(
-      std::make_pair(Interest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s/t/u/v/w"),
+      std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s/t/u/v/w"),
                      this->data.back()));
     this->interests.push_back(
-      std::make_pair(Interest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s/t/u/v/w/x"),
+      std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s/t/u/v/w/x"),
                      this->data.back()));
     this->interests.push_back(
-      std::make_pair(Interest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s/t/u/v/w/x/y"),
+      std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s/t/u/v/w/x/y"),
                      this->data.back()));
     this->interests.push_back(
-      std::make_pair(Interest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s/t/u/v/w/x/y/z"),
+      std::make_pair(makePrefixInterest("/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p/q/r/s/t/u/v/w/x/y/z"),
                      this->data.back()));
   }
+
+private:
+  static Interest
+  makePrefixInterest(const Name& name)
+  {
+    return Interest(name).setCanBePrefix(true);
+  }
 };
 
 using CommonDatasets = boost::mp11::mp_list<BasicDataset,
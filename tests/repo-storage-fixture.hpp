@@ -20,27 +20,31 @@
 #ifndef REPO_TESTS_REPO_STORAGE_FIXTURE_HPP
 #define REPO_TESTS_REPO_STORAGE_FIXTURE_HPP
 
+#include "sqlite-fixture.hpp"
 #include "storage/repo-storage.hpp"
-#include "storage/sqlite-storage.hpp"
-
-#include <filesystem>
 
 namespace repo::tests {
 
-class RepoStorageFixture
+template<class StorageT>
+class StorageBackendFixture
 {
 public:
-  ~RepoStorageFixture()
+  ~StorageBackendFixture()
   {
+    // the storage must be closed before its files are removed
+    handle.reset();
+    store.reset();
     std::error_code ec;
     std::filesystem::remove_all(std::filesystem::path("unittestdb"), ec);
   }
 
 public:
-  std::shared_ptr<Storage> store = std::make_shared<SqliteStorage>("unittestdb");
+  std::shared_ptr<Storage> store = std::make_shared<StorageT>("unittestdb");
   std::shared_ptr<RepoStorage> handle = std::make_shared<RepoStorage>(*store);
 };
 
+using RepoStorageFixture = StorageBackendFixture<SqliteStorage>;
+
 } // namespace repo::tests
 
 #endif // REPO_TESTS_REPO_STORAGE_FIXTURE_HPP
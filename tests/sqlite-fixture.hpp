@@ -20,16 +20,85 @@
 #ifndef REPO_TESTS_SQLITE_FIXTURE_HPP
 #define REPO_TESTS_SQLITE_FIXTURE_HPP
 
+#include "storage/executor-storage.hpp"
+#include "storage/log-storage.hpp"
+#include "storage/memory-storage.hpp"
+#include "storage/sharded-storage.hpp"
+#include "storage/tiered-storage.hpp"
 #include "storage/sqlite-storage.hpp"
 
+#include <boost/mp11/list.hpp>
+
 #include <filesystem>
 
 namespace repo::tests {
 
-class SqliteFixture
+/**
+ * @brief SqliteStorage behind a hot tier small enough for the test datasets to overflow it
+ */
+class TieredSqliteStorage : public TieredStorage
 {
 public:
-  ~SqliteFixture()
+  explicit
+  TieredSqliteStorage(const std::string& dbPath)
+    : TieredStorage(std::make_shared<SqliteStorage>(dbPath), 8 * 1024)
+  {
+  }
+};
+
+/**
+ * @brief ShardedStorage routing by two name components, so that short test names are spread
+ *        over the shards and prefix lookups have to merge them
+ */
+class ShardedSqliteStorage : public ShardedStorage
+{
+public:
+  explicit
+  ShardedSqliteStorage(const std::string& dirPath)
+    : ShardedStorage(dirPath, 4, 2)
+  {
+  }
+};
+
+/**
+ * @brief SqliteStorage run on a dedicated thread
+ *
+ * The io_context is never run: the tests use the synchronous operations, which deliver
+ * the callbacks of asynchronous operations themselves.
+ */
+class ExecutorSqliteStorage : public ExecutorStorage
+{
+public:
+  explicit
+  ExecutorSqliteStorage(const std::string& dbPath)
+    : ExecutorStorage(std::make_shared<SqliteStorage>(dbPath), getIoContext())
+  {
+  }
+
+private:
+  static boost::asio::io_context&
+  getIoContext()
+  {
+    static boost::asio::io_context ioCtx;
+    return ioCtx;
+  }
+};
+
+/// the Storage implementations that tests are run against
+using StorageBackends = boost::mp11::mp_list<SqliteStorage, LogStorage, MemoryStorage,
+                                             TieredSqliteStorage, ShardedSqliteStorage,
+                                             ExecutorSqliteStorage>;
+
+/// the Storage implementations that call the callbacks of asynchronous operations right away,
+/// for the tests that run the background steps of RepoStorage on an io_context of their own
+using SynchronousBackends = boost::mp11::mp_list<SqliteStorage, LogStorage, MemoryStorage,
+                                                 TieredSqliteStorage, ShardedSqliteStorage>;
+
+template<class StorageT>
+class StorageFixture
+{
+public:
+  ~StorageFixture()
   {
     handle.reset();
     std::error_code ec;
@@ -37,9 +106,11 @@ public:
   }
 
 public:
-  std::unique_ptr<SqliteStorage> handle = std::make_unique<SqliteStorage>("unittestdb");
+  std::unique_ptr<StorageT> handle = std::make_unique<StorageT>("unittestdb");
 };
 
+using SqliteFixture = StorageFixture<SqliteStorage>;
+
 } // namespace repo::tests
 
 #endif // REPO_TESTS_SQLITE_FIXTURE_HPP
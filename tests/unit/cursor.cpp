@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/cursor.hpp"
+
+#include "../sqlite-fixture.hpp"
+#include "../dataset-fixtures.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo::tests {
+
+BOOST_AUTO_TEST_SUITE(Cursor)
+
+template<class StorageT>
+class CursorFixture : public StorageFixture<StorageT>, public SamePrefixDataset<10>
+{
+public:
+  CursorFixture()
+  {
+    for (const auto& d : this->data) {
+      this->handle->insert(*d);
+    }
+    // outside of the prefix of the dataset
+    other = createData("/x/y/w");
+    this->handle->insert(*other);
+  }
+
+  /**
+   * @brief Full names of the dataset, in the order of their TLV encoding
+   */
+  std::vector<Name>
+  getSortedFullNames() const
+  {
+    std::vector<Name> names;
+    for (const auto& d : this->data) {
+      names.push_back(d->getFullName());
+    }
+    std::sort(names.begin(), names.end(), [] (const Name& a, const Name& b) {
+      auto aValue = a.wireEncode().value_bytes();
+      auto bValue = b.wireEncode().value_bytes();
+      return std::lexicographical_compare(aValue.begin(), aValue.end(),
+                                          bValue.begin(), bValue.end());
+    });
+    return names;
+  }
+
+public:
+  std::shared_ptr<Data> other;
+};
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(Pages, T, StorageBackends, CursorFixture<T>)
+{
+  repo::Cursor::Options options;
+  options.withData = true;
+  options.pageSize = 3;
+  repo::Cursor cursor(*this->handle, options);
+
+  std::vector<Name> names;
+  while (cursor.next()) {
+    BOOST_REQUIRE(cursor.getData() != nullptr);
+    BOOST_CHECK_EQUAL(cursor.getData()->getFullName(), cursor.getFullName());
+    names.push_back(cursor.getFullName());
+  }
+  BOOST_CHECK_EQUAL(cursor.getNEnumerated(), this->data.size() + 1);
+  BOOST_CHECK(!cursor.next());
+
+  // "/x/y/w" is before "/x/y/z/..."
+  auto expected = this->getSortedFullNames();
+  expected.insert(expected.begin(), this->other->getFullName());
+  BOOST_CHECK_EQUAL_COLLECTIONS(names.begin(), names.end(), expected.begin(), expected.end());
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(PrefixLimitResume, T, StorageBackends, CursorFixture<T>)
+{
+  repo::Cursor::Options options;
+  options.range = repo::Cursor::makePrefixRange("/x/y/z");
+  options.limit = 4;
+  repo::Cursor first(*this->handle, options);
+
+  std::vector<Name> names;
+  while (first.next()) {
+    BOOST_CHECK(first.getData() == nullptr);
+    names.push_back(first.getFullName());
+  }
+  BOOST_CHECK_EQUAL(names.size(), 4);
+
+  // a Data erased meanwhile is not enumerated when the enumeration is resumed
+  auto expected = this->getSortedFullNames();
+  BOOST_CHECK(this->handle->erase(expected[6]));
+  expected.erase(expected.begin() + 6);
+
+  options.limit = 0;
+  repo::Cursor second(*this->handle, options, first.getResumeToken());
+  while (second.next()) {
+    names.push_back(second.getFullName());
+  }
+  BOOST_CHECK_EQUAL_COLLECTIONS(names.begin(), names.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace repo::tests
@@ -0,0 +1,213 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/eviction-policy.hpp"
+#include "storage/executor-storage.hpp"
+#include "storage/repo-storage.hpp"
+#include "storage/sqlite-storage.hpp"
+
+#include "../dataset-fixtures.hpp"
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <filesystem>
+#include <optional>
+
+namespace repo::tests {
+
+class ExecutorStorageFixture : public SamePrefixDataset<10>
+{
+public:
+  ~ExecutorStorageFixture()
+  {
+    storage.reset();
+    std::error_code ec;
+    std::filesystem::remove_all("unittestdb", ec);
+  }
+
+  /**
+   * @brief Process events until @p isDone returns true
+   */
+  template<typename Predicate>
+  void
+  runUntil(Predicate&& isDone)
+  {
+    auto workGuard = boost::asio::make_work_guard(ioCtx);
+    while (!isDone()) {
+      ioCtx.run_one();
+    }
+  }
+
+public:
+  boost::asio::io_context ioCtx;
+  std::shared_ptr<repo::ExecutorStorage> storage =
+    std::make_shared<repo::ExecutorStorage>(std::make_shared<repo::SqliteStorage>("unittestdb"),
+                                            ioCtx);
+};
+
+BOOST_FIXTURE_TEST_SUITE(ExecutorStorage, ExecutorStorageFixture)
+
+BOOST_AUTO_TEST_CASE(CallOrder)
+{
+  std::vector<std::string> events;
+  for (const auto& d : this->data) {
+    storage->asyncInsert(*d,
+      [&] (bool isInserted) { events.push_back(isInserted ? "inserted" : "present"); },
+      [&] (const std::string&) { events.push_back("failed"); });
+  }
+  storage->asyncInsert(*this->data.front(),
+    [&] (bool isInserted) { events.push_back(isInserted ? "inserted" : "present"); },
+    [&] (const std::string&) { events.push_back("failed"); });
+  storage->asyncFind(this->data.back()->getName(), false, [&] (auto data) {
+    BOOST_CHECK(data != nullptr && *data == *this->data.back());
+    events.push_back("found");
+  });
+  // callbacks are called only on the io_context...
+  BOOST_CHECK(events.empty());
+
+  // ...or when a synchronous operation returns, after all preceding operations
+  BOOST_CHECK_EQUAL(storage->size(), 10);
+  BOOST_REQUIRE_EQUAL(events.size(), 12);
+  BOOST_CHECK_EQUAL(std::count(events.begin(), events.begin() + 10, "inserted"), 10);
+  BOOST_CHECK_EQUAL(events[10], "present");
+  BOOST_CHECK_EQUAL(events[11], "found");
+
+  std::vector<Name> erased;
+  bool isErased = false;
+  Name prefix = this->data.front()->getName().getPrefix(-1);
+  storage->asyncEraseRange(prefix, prefix.getSuccessor(),
+    [&] (const std::vector<Name>& names) {
+      BOOST_CHECK(!isErased);
+      erased.insert(erased.end(), names.begin(), names.end());
+    },
+    [&] (uint64_t nErased) {
+      BOOST_CHECK_EQUAL(nErased, 10);
+      isErased = true;
+    },
+    [&] (const std::string& reason) { BOOST_ERROR(reason); });
+  runUntil([&] { return isErased; });
+  BOOST_CHECK_EQUAL(erased.size(), 10);
+  BOOST_CHECK_EQUAL(storage->size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(NoCallbacksAfterDestruction)
+{
+  bool isCalled = false;
+  storage->asyncInsert(*this->data.front(), [&] (bool) { isCalled = true; },
+                       [&] (const std::string&) { isCalled = true; });
+  storage.reset();
+  ioCtx.poll();
+  BOOST_CHECK_EQUAL(isCalled, false);
+}
+
+BOOST_AUTO_TEST_CASE(AsyncGroupCommit)
+{
+  RepoStorage repoStorage(*storage);
+  Scheduler scheduler(ioCtx);
+  repoStorage.enableGroupCommit(scheduler, 4, 10_s);
+
+  size_t nSignaled = 0;
+  repoStorage.afterDataInsertion.connect([&] (const Name&) { ++nSignaled; });
+  size_t nDone = 0;
+  for (const auto& d : this->data) {
+    repoStorage.insertData(*d, [&] (bool isStored) {
+      BOOST_CHECK(isStored);
+      ++nDone;
+    });
+  }
+  BOOST_CHECK_EQUAL(nDone, 0);
+  runUntil([&] { return nDone == this->data.size(); });
+  // The commit after the fourth insertion runs after all the queued insertions, so it
+  // includes them, and they are all signaled after it.
+  BOOST_CHECK_EQUAL(nSignaled, 10);
+  BOOST_CHECK_EQUAL(storage->size(), 10);
+
+  ssize_t nDeleted = 0;
+  repoStorage.deleteData(this->data.front()->getName().getPrefix(-1),
+                         [&] (ssize_t n) { nDeleted = n; });
+  runUntil([&] { return nDeleted != 0; });
+  BOOST_CHECK_EQUAL(nDeleted, 10);
+}
+
+BOOST_AUTO_TEST_CASE(AsyncTransactionAndUsage)
+{
+  storage->asyncBeginTransaction([&] (const std::string& reason) { BOOST_ERROR(reason); });
+  storage->asyncInsert(*this->data.front(), [] (bool) {},
+                       [&] (const std::string& reason) { BOOST_ERROR(reason); });
+  std::optional<std::pair<uint64_t, uint64_t>> usage;
+  storage->asyncUsage([&] (uint64_t nPackets, uint64_t nBytes) { usage.emplace(nPackets, nBytes); },
+                      [&] (const std::string& reason) { BOOST_ERROR(reason); });
+  BOOST_CHECK(!usage);
+  runUntil([&] { return usage.has_value(); });
+  BOOST_CHECK_EQUAL(usage->first, 1);
+  BOOST_CHECK_EQUAL(usage->second, this->data.front()->wireEncode().size());
+
+  // the insertion was part of the transaction
+  storage->rollbackTransaction();
+  BOOST_CHECK_EQUAL(storage->size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(AsyncCapacityCheck)
+{
+  RepoStorage repoStorage(*storage);
+  Scheduler scheduler(ioCtx);
+  repoStorage.enableGroupCommit(scheduler, 4, 10_s);
+  repoStorage.enableCapacityLimits(scheduler, 6, 0, std::make_unique<FifoEvictionPolicy>());
+
+  size_t nDone = 0;
+  for (const auto& d : this->data) {
+    repoStorage.insertData(*d, [&] (bool) { ++nDone; });
+  }
+  runUntil([&] { return nDone == this->data.size(); });
+  repoStorage.flush();
+  runUntil([&] { return storage->size() <= 6; });
+  BOOST_CHECK_EQUAL(storage->size(), 6);
+  // the first Data inserted are evicted
+  size_t i = 0;
+  for (const auto& d : this->data) {
+    BOOST_CHECK_EQUAL(storage->has(d->getFullName()), i++ >= 4);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(AsyncEnumerationAndLookupFilter)
+{
+  Scheduler scheduler(ioCtx);
+  RepoStorage repoStorage(*storage);
+  for (const auto& d : this->data) {
+    BOOST_CHECK_EQUAL(repoStorage.insertData(*d), true);
+  }
+
+  size_t nSignaled = 0;
+  repoStorage.afterDataInsertion.connect([&] (const Name&) { ++nSignaled; });
+  repoStorage.notifyAboutExistingDataIncrementally(scheduler, 3);
+  repoStorage.enableLookupFilter(scheduler, 100000, 1);
+  // the pages are read on the storage thread, between the events
+  runUntil([&] {
+    return !repoStorage.isEnumeratingExistingData() && repoStorage.isLookupFilterReady();
+  });
+  BOOST_CHECK_EQUAL(nSignaled, 10);
+  BOOST_CHECK(repoStorage.readData(Interest("/x/y/z/test/2")) == nullptr);
+  BOOST_CHECK_EQUAL(repoStorage.getLookupFilterCounters().nSkipped, 1);
+  BOOST_CHECK(repoStorage.readData(Interest(this->data.front()->getName())) != nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace repo::tests
@@ -0,0 +1,285 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/log-storage.hpp"
+
+#include "../dataset-fixtures.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <filesystem>
+
+namespace repo::tests {
+
+namespace fs = std::filesystem;
+
+class LogStorageFixture : public SamePrefixDataset<100>
+{
+public:
+  LogStorageFixture()
+  {
+    options.maxSegmentSize = 16 * 1024;
+    options.enableBackgroundCompaction = false;
+    reopen();
+  }
+
+  ~LogStorageFixture()
+  {
+    storage.reset();
+    std::error_code ec;
+    fs::remove_all(dirPath, ec);
+  }
+
+  void
+  reopen()
+  {
+    storage.reset();
+    storage = std::make_unique<repo::LogStorage>(dirPath.string(), options);
+  }
+
+  fs::path
+  getLastSegmentPath() const
+  {
+    fs::path last;
+    for (const auto& entry : fs::directory_iterator(dirPath)) {
+      if (entry.path().extension() == ".log" && entry.path() > last) {
+        last = entry.path();
+      }
+    }
+    return last;
+  }
+
+public:
+  const fs::path dirPath{"unittestdb"};
+  LogStorageOptions options;
+  std::unique_ptr<repo::LogStorage> storage;
+};
+
+BOOST_FIXTURE_TEST_SUITE(LogStorage, LogStorageFixture)
+
+BOOST_AUTO_TEST_CASE(Reopen)
+{
+  uint64_t nBytes = 0;
+  for (const auto& d : this->data) {
+    storage->insert(*d);
+    nBytes += d->wireEncode().size();
+  }
+  BOOST_CHECK_GT(storage->getNSegments(), 1);
+  BOOST_CHECK_EQUAL(storage->erase(this->data.front()->getFullName()), true);
+
+  reopen();
+  BOOST_CHECK_EQUAL(storage->size(), 99);
+  BOOST_CHECK_EQUAL(storage->bytes(), nBytes - this->data.front()->wireEncode().size());
+  BOOST_CHECK(storage->read(this->data.front()->getFullName()) == nullptr);
+  for (auto it = std::next(this->data.begin()); it != this->data.end(); ++it) {
+    auto found = storage->read((*it)->getFullName());
+    BOOST_REQUIRE(found != nullptr);
+    BOOST_CHECK_EQUAL(*found, **it);
+  }
+
+  // the insertion order survives as well
+  std::vector<Name> names;
+  storage->forEachInInsertionOrder([&] (const Name& name) {
+    names.push_back(name);
+    return names.size() < 2;
+  });
+  BOOST_REQUIRE_EQUAL(names.size(), 2);
+  BOOST_CHECK_EQUAL(names[0], (*std::next(this->data.begin(), 1))->getFullName());
+  BOOST_CHECK_EQUAL(names[1], (*std::next(this->data.begin(), 2))->getFullName());
+}
+
+BOOST_AUTO_TEST_CASE(ReplayAfterCheckpoint)
+{
+  auto it = this->data.begin();
+  for (size_t i = 0; i < 50; ++i, ++it) {
+    storage->insert(**it);
+  }
+  storage->writeCheckpoint();
+  fs::copy_file(dirPath / "index.checkpoint", dirPath / "saved.checkpoint");
+
+  for (; it != this->data.end(); ++it) {
+    storage->insert(**it);
+  }
+  for (auto d = this->data.begin(); d != std::next(this->data.begin(), 10); ++d) {
+    storage->erase((*d)->getFullName());
+  }
+
+  // simulate a crash after the first checkpoint: the later records are replayed
+  storage.reset();
+  fs::rename(dirPath / "saved.checkpoint", dirPath / "index.checkpoint");
+  reopen();
+  BOOST_CHECK_EQUAL(storage->size(), 90);
+  BOOST_CHECK(storage->has(this->data.back()->getFullName()));
+  BOOST_CHECK(!storage->has(this->data.front()->getFullName()));
+
+  // without any checkpoint, the whole log is replayed
+  storage.reset();
+  fs::remove(dirPath / "index.checkpoint");
+  reopen();
+  BOOST_CHECK_EQUAL(storage->size(), 90);
+  BOOST_CHECK(!storage->has(this->data.front()->getFullName()));
+}
+
+BOOST_AUTO_TEST_CASE(TornRecord)
+{
+  for (const auto& d : this->data) {
+    storage->insert(*d);
+  }
+  storage.reset();
+  fs::remove(dirPath / "index.checkpoint");
+
+  // the last record was only partially written
+  auto segmentPath = getLastSegmentPath();
+  auto segmentSize = fs::file_size(segmentPath);
+  fs::resize_file(segmentPath, segmentSize - 10);
+
+  reopen();
+  BOOST_CHECK_EQUAL(storage->size(), 99);
+  BOOST_CHECK(!storage->has(this->data.back()->getFullName()));
+  BOOST_CHECK_LT(fs::file_size(segmentPath), segmentSize - 10);
+
+  // appending continues after the truncated record
+  BOOST_CHECK_EQUAL(storage->insertIfAbsent(*this->data.back()), true);
+  reopen();
+  BOOST_CHECK_EQUAL(storage->size(), 100);
+  BOOST_CHECK(storage->has(this->data.back()->getFullName()));
+}
+
+BOOST_AUTO_TEST_CASE(Compaction)
+{
+  for (const auto& d : this->data) {
+    storage->insert(*d);
+  }
+  size_t nSegments = storage->getNSegments();
+
+  // keep every tenth Data
+  std::vector<std::shared_ptr<Data>> kept;
+  size_t i = 0;
+  for (const auto& d : this->data) {
+    if (i++ % 10 == 0) {
+      kept.push_back(d);
+    }
+    else {
+      BOOST_CHECK_EQUAL(storage->erase(d->getFullName()), true);
+    }
+  }
+
+  storage->compact();
+  BOOST_CHECK_LT(storage->getNSegments(), nSegments);
+  BOOST_CHECK_EQUAL(storage->size(), kept.size());
+  for (const auto& d : kept) {
+    auto found = storage->read(d->getFullName());
+    BOOST_REQUIRE(found != nullptr);
+    BOOST_CHECK_EQUAL(*found, *d);
+  }
+
+  // the compacted log is replayed consistently
+  storage.reset();
+  fs::remove(dirPath / "index.checkpoint");
+  reopen();
+  BOOST_CHECK_EQUAL(storage->size(), kept.size());
+  for (const auto& d : kept) {
+    BOOST_CHECK(storage->has(d->getFullName()));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Rollback)
+{
+  auto middle = std::next(this->data.begin(), 50);
+  uint64_t nBytes = 0;
+  for (auto it = this->data.begin(); it != middle; ++it) {
+    storage->insert(**it);
+    nBytes += (*it)->wireEncode().size();
+  }
+  size_t nSegments = storage->getNSegments();
+
+  storage->beginTransaction();
+  for (auto it = middle; it != this->data.end(); ++it) {
+    storage->insert(**it);
+  }
+  BOOST_CHECK_EQUAL(storage->erase(this->data.front()->getFullName()), true);
+  // reading a record of the transaction writes it out to the segment file
+  BOOST_CHECK(storage->read(this->data.back()->getFullName()) != nullptr);
+  BOOST_CHECK_EQUAL(storage->getNSegments(), nSegments);
+  storage->rollbackTransaction();
+
+  BOOST_CHECK_EQUAL(storage->size(), 50);
+  BOOST_CHECK_EQUAL(storage->bytes(), nBytes);
+  BOOST_CHECK(storage->has(this->data.front()->getFullName()));
+  BOOST_CHECK(!storage->has(this->data.back()->getFullName()));
+  std::vector<Name> names;
+  storage->forEachInInsertionOrder([&] (const Name& name) {
+    names.push_back(name);
+    return true;
+  });
+  BOOST_REQUIRE_EQUAL(names.size(), 50);
+  BOOST_CHECK_EQUAL(names.front(), this->data.front()->getFullName());
+
+  // the records of the transaction are gone from the log
+  storage->insert(*this->data.back());
+  storage.reset();
+  fs::remove(dirPath / "index.checkpoint");
+  reopen();
+  BOOST_CHECK_EQUAL(storage->size(), 51);
+  BOOST_CHECK(storage->has(this->data.front()->getFullName()));
+  BOOST_CHECK(storage->has(this->data.back()->getFullName()));
+  BOOST_CHECK(!storage->has((*middle)->getFullName()));
+
+  // committed records are kept
+  storage->beginTransaction();
+  storage->insert(**middle);
+  storage->commitTransaction();
+  reopen();
+  BOOST_CHECK_EQUAL(storage->size(), 52);
+  BOOST_CHECK(storage->has((*middle)->getFullName()));
+}
+
+BOOST_AUTO_TEST_CASE(MemoryMappedRead)
+{
+  options.useMemoryMap = true;
+  reopen();
+  for (const auto& d : this->data) {
+    storage->insert(*d);
+  }
+
+  // Data in sealed segments are read from the mapping, the others from the file
+  for (const auto& d : this->data) {
+    auto found = storage->read(d->getName());
+    BOOST_REQUIRE(found != nullptr);
+    BOOST_CHECK_EQUAL(*found, *d);
+  }
+
+  // a Data returned before compaction stays valid after its segment is removed
+  auto first = storage->read(this->data.front()->getFullName());
+  for (auto it = std::next(this->data.begin()); it != this->data.end(); ++it) {
+    storage->erase((*it)->getFullName());
+  }
+  storage->compact();
+  BOOST_REQUIRE(first != nullptr);
+  BOOST_CHECK_EQUAL(*first, *this->data.front());
+
+  reopen();
+  auto found = storage->read(this->data.front()->getFullName());
+  BOOST_REQUIRE(found != nullptr);
+  BOOST_CHECK_EQUAL(*found, *this->data.front());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace repo::tests
@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/lookup-filter.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo::tests {
+
+BOOST_AUTO_TEST_SUITE(LookupFilter)
+
+BOOST_AUTO_TEST_CASE(Prefixes)
+{
+  repo::LookupFilter filter(1000, 2);
+  Name fullName("/a/b/c/d");
+  filter.add(fullName);
+
+  BOOST_CHECK(!filter.canCheck("/a"));
+  for (const Name& prefix : {Name("/a/b"), Name("/a/b/c"), fullName}) {
+    BOOST_REQUIRE(filter.canCheck(prefix));
+    BOOST_CHECK(filter.mayMatch(prefix));
+  }
+  BOOST_CHECK(!filter.mayMatch("/a/c"));
+  BOOST_CHECK(!filter.mayMatch("/a/b/c/e"));
+  BOOST_CHECK(!filter.mayMatch("/a/b/c/d/e"));
+
+  filter.remove(fullName);
+  BOOST_CHECK(!filter.mayMatch("/a/b"));
+  BOOST_CHECK(!filter.mayMatch(fullName));
+}
+
+BOOST_AUTO_TEST_CASE(SharedPrefix)
+{
+  repo::LookupFilter filter(1000, 1);
+  filter.add("/a/b/1");
+  filter.add("/a/b/2");
+
+  filter.remove("/a/b/1");
+  BOOST_CHECK(!filter.mayMatch("/a/b/1"));
+  BOOST_CHECK(filter.mayMatch("/a/b/2"));
+  BOOST_CHECK(filter.mayMatch("/a/b"));
+  BOOST_CHECK(filter.mayMatch("/a"));
+
+  filter.remove("/a/b/2");
+  BOOST_CHECK(!filter.mayMatch("/a"));
+}
+
+BOOST_AUTO_TEST_CASE(FalsePositiveRate)
+{
+  const size_t nData = 1000;
+  repo::LookupFilter filter(nData, 3);
+  for (size_t i = 0; i < nData; ++i) {
+    filter.add(Name("/stored").appendNumber(i).appendSegment(0));
+  }
+
+  size_t nFalsePositives = 0;
+  const size_t nProbes = 10000;
+  for (size_t i = 0; i < nProbes; ++i) {
+    Name probe = Name("/stored").appendNumber(nData + i).appendSegment(0);
+    BOOST_CHECK(filter.mayMatch(Name("/stored").appendNumber(i % nData).appendSegment(0)));
+    nFalsePositives += filter.mayMatch(probe);
+  }
+  // the filter is sized for 1%
+  BOOST_CHECK_LT(nFalsePositives, nProbes * 3 / 100);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace repo::tests
@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/memory-storage.hpp"
+
+#include "../dataset-fixtures.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <filesystem>
+
+namespace repo::tests {
+
+class MemoryStorageFixture : public SamePrefixDataset<10>
+{
+public:
+  ~MemoryStorageFixture()
+  {
+    std::error_code ec;
+    std::filesystem::remove_all("unittestdb", ec);
+  }
+
+public:
+  const std::string snapshotPath = "unittestdb/ndn_repo.snapshot";
+};
+
+BOOST_FIXTURE_TEST_SUITE(MemoryStorage, MemoryStorageFixture)
+
+BOOST_AUTO_TEST_CASE(Snapshot)
+{
+  {
+    repo::MemoryStorage storage(snapshotPath);
+    for (const auto& d : this->data) {
+      storage.insert(*d);
+    }
+    storage.erase(this->data.front()->getFullName());
+  }
+
+  repo::MemoryStorage storage(snapshotPath);
+  BOOST_CHECK_EQUAL(storage.size(), 9);
+  BOOST_CHECK(!storage.has(this->data.front()->getFullName()));
+  for (auto it = std::next(this->data.begin()); it != this->data.end(); ++it) {
+    auto found = storage.read((*it)->getName());
+    BOOST_REQUIRE(found != nullptr);
+    BOOST_CHECK_EQUAL(*found, **it);
+  }
+
+  // the snapshot keeps the insertion order
+  std::vector<Name> names;
+  storage.forEachInInsertionOrder([&] (const Name& name) {
+    names.push_back(name);
+    return true;
+  });
+  BOOST_REQUIRE_EQUAL(names.size(), 9);
+  BOOST_CHECK_EQUAL(names.front(), (*std::next(this->data.begin()))->getFullName());
+  BOOST_CHECK_EQUAL(names.back(), this->data.back()->getFullName());
+}
+
+BOOST_AUTO_TEST_CASE(NoSnapshot)
+{
+  {
+    repo::MemoryStorage storage;
+    for (const auto& d : this->data) {
+      storage.insert(*d);
+    }
+  }
+  BOOST_CHECK(!std::filesystem::exists(snapshotPath));
+
+  repo::MemoryStorage storage;
+  BOOST_CHECK_EQUAL(storage.size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace repo::tests
@@ -0,0 +1,76 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/name-trie.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo::tests {
+
+BOOST_AUTO_TEST_SUITE(NameTrie)
+
+BOOST_AUTO_TEST_CASE(InsertFindErase)
+{
+  repo::NameTrie<int> trie;
+  BOOST_CHECK_EQUAL(trie.insert("/a/b", 1), true);
+  BOOST_CHECK_EQUAL(trie.insert("/a/b/c", 2), true);
+  BOOST_CHECK_EQUAL(trie.insert("/a/b", 3), false);
+  BOOST_CHECK_EQUAL(trie.size(), 2);
+
+  BOOST_REQUIRE(trie.find("/a/b") != nullptr);
+  BOOST_CHECK_EQUAL(*trie.find("/a/b"), 1);
+  BOOST_CHECK(trie.find("/a") == nullptr);
+  BOOST_CHECK(trie.find("/a/b/c/d") == nullptr);
+
+  // a name with descendants keeps its node when erased
+  size_t memoryUsage = trie.getMemoryUsage();
+  BOOST_CHECK_EQUAL(trie.erase("/a/b").value_or(0), 1);
+  BOOST_CHECK(!trie.erase("/a/b"));
+  BOOST_CHECK_EQUAL(trie.getMemoryUsage(), memoryUsage);
+  BOOST_CHECK_EQUAL(*trie.find("/a/b/c"), 2);
+
+  // nodes left empty are removed
+  BOOST_CHECK_EQUAL(trie.erase("/a/b/c").value_or(0), 2);
+  BOOST_CHECK_EQUAL(trie.empty(), true);
+  BOOST_CHECK_EQUAL(trie.getMemoryUsage(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(FirstAndLast)
+{
+  repo::NameTrie<int> trie;
+  trie.insert(Name("/a").appendSegment(2), 2);
+  trie.insert(Name("/a").appendSegment(300), 300);
+  trie.insert(Name("/a").appendSegment(1), 1);
+  trie.insert("/a", 0);
+  trie.insert(Name("/b").appendVersion(7).appendSegment(0), 7);
+
+  // in the order of the TLV encoding, as in the storage backends
+  BOOST_CHECK_EQUAL(*trie.findFirst("/a"), 0);
+  BOOST_CHECK_EQUAL(*trie.findLast("/a"), 300);
+  BOOST_CHECK_EQUAL(*trie.findFirst(Name("/a").appendSegment(2)), 2);
+  BOOST_CHECK_EQUAL(*trie.findFirst("/"), 0);
+  BOOST_CHECK_EQUAL(*trie.findLast("/"), 7);
+  BOOST_CHECK_EQUAL(*trie.findLast("/b"), 7);
+  BOOST_CHECK(trie.findFirst("/c") == nullptr);
+  BOOST_CHECK(trie.findLast("/a/b") == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace repo::tests
@@ -125,6 +125,35 @@ BOOST_FIXTURE_TEST_CASE(DataPrefixes, Fixture)
   CHECK_INTERESTS(interest.getName(), Name::Component{"unregister"}, true);
 }
 
+BOOST_FIXTURE_TEST_CASE(RestoreFromPrefixSummary, Fixture)
+{
+  keyChain.createIdentity(identity);
+  handle->enablePrefixSummary(subsetLength);
+  for (int i = 0; i < 3; ++i) {
+    Data data(Name{dataPrefix}.appendNumber(i));
+    keyChain.sign(data, ndn::security::SigningInfo(ndn::security::SigningInfo::SIGNER_TYPE_ID,
+                                                   identity));
+    handle->insertData(data);
+  }
+
+  // a restarted repo restores the registered prefixes without enumerating the data
+  RepoStorage restartedHandle(*store);
+  ReadHandle restartedReadHandle(face, restartedHandle, subsetLength);
+  restartedHandle.enablePrefixSummary(subsetLength);
+  face.sentInterests.clear();
+  restartedHandle.notifyAboutExistingData();
+  face.processEvents(-1_ms);
+  CHECK_INTERESTS(interest.getName(), Name::Component{"register"}, true);
+
+  const auto& prefixes = restartedReadHandle.getRegisteredPrefixes();
+  BOOST_REQUIRE_EQUAL(prefixes.size(), 1);
+  BOOST_REQUIRE(prefixes.find(dataPrefix) != nullptr);
+  BOOST_CHECK_EQUAL(prefixes.find(dataPrefix)->useCount, 3);
+
+  restartedReadHandle.onPrefixCountChanged(dataPrefix, -3);
+  BOOST_CHECK_EQUAL(restartedReadHandle.getRegisteredPrefixes().size(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestReadHandle
 
 } // namespace repo::tests
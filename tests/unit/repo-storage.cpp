@@ -21,18 +21,38 @@
 #include "../dataset-fixtures.hpp"
 #include "../repo-storage-fixture.hpp"
 
+#include <boost/asio/io_context.hpp>
+#include <boost/mp11/algorithm.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <set>
+
 namespace repo::tests {
 
 BOOST_AUTO_TEST_SUITE(RepoStorage)
 
-template<class Dataset>
-class Fixture : public Dataset, public RepoStorageFixture
+template<class Dataset, class StorageT>
+class Fixture : public Dataset, public StorageBackendFixture<StorageT>
 {
 };
 
-BOOST_FIXTURE_TEST_CASE_TEMPLATE(Bulk, T, CommonDatasets, Fixture<T>)
+/// every common dataset in every storage backend, as mp_list<Dataset, StorageT>
+using DatasetsAndBackends = boost::mp11::mp_product<boost::mp11::mp_list,
+                                                    CommonDatasets, StorageBackends>;
+
+template<class Params>
+using DatasetFixture = Fixture<boost::mp11::mp_first<Params>, boost::mp11::mp_second<Params>>;
+
+template<class StorageT>
+using BasicFixture = Fixture<BasicDataset, StorageT>;
+
+template<class StorageT>
+using SamePrefixFixture = Fixture<SamePrefixDataset<10>, StorageT>;
+
+template<class StorageT>
+using LargeSamePrefixFixture = Fixture<SamePrefixDataset<300>, StorageT>;
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(Bulk, T, DatasetsAndBackends, DatasetFixture<T>)
 {
   // Insert data into repo
   for (auto i = this->data.begin(); i != this->data.end(); ++i) {
@@ -56,22 +76,385 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(Bulk, T, CommonDatasets, Fixture<T>)
   }
 }
 
-BOOST_FIXTURE_TEST_CASE(NotifyAboutExistingData, Fixture<BasicDataset>)
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(NotifyAboutExistingData, T, StorageBackends, BasicFixture<T>)
 {
   // Insert data into repo
   for (const auto& d : this->data) {
-    handle->insertData(*d);
+    this->handle->insertData(*d);
   }
 
   std::vector<Name> names;
-  handle->afterDataInsertion.connect([&] (const Name& name) {
+  this->handle->afterDataInsertion.connect([&] (const Name& name) {
     names.push_back(name);
   });
-  handle->notifyAboutExistingData();
+  this->handle->notifyAboutExistingData();
 
   BOOST_CHECK_EQUAL(names.size(), this->data.size());
+  for (const auto& d : this->data) {
+    BOOST_CHECK(std::find(names.begin(), names.end(), d->getName()) != names.end());
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(GroupCommit, T, StorageBackends, SamePrefixFixture<T>)
+{
+  boost::asio::io_context io;
+  Scheduler scheduler(io);
+  this->handle->enableGroupCommit(scheduler, 4, 10_ms);
+
+  std::vector<Name> names;
+  this->handle->afterDataInsertion.connect([&] (const Name& name) {
+    names.push_back(name);
+  });
+
+  auto it = this->data.begin();
+  for (int i = 0; i < 3; ++i, ++it) {
+    BOOST_CHECK_EQUAL(this->handle->insertData(**it), true);
+  }
+  // not signaled before the batch is committed, but readable
+  BOOST_CHECK_EQUAL(names.size(), 0);
+  BOOST_CHECK(this->handle->readData(Interest(this->data.front()->getName())) != nullptr);
+
+  // the fourth insertion fills the batch; ExecutorSqliteStorage calls the callback of the
+  // commit when the next synchronous operation returns
+  BOOST_CHECK_EQUAL(this->handle->insertData(**it++), true);
+  BOOST_CHECK_EQUAL(this->store->size(), 4);
+  BOOST_CHECK_EQUAL(names.size(), 4);
+
+  // an incomplete batch is committed after the delay
+  BOOST_CHECK_EQUAL(this->handle->insertData(**it++), true);
+  BOOST_CHECK_EQUAL(names.size(), 4);
+  io.run();
+  BOOST_CHECK_EQUAL(this->store->size(), 5);
+  BOOST_CHECK_EQUAL(names.size(), 5);
+
+  // deletion commits pending insertions first
+  BOOST_CHECK_EQUAL(this->handle->insertData(**it), true);
+  BOOST_CHECK_EQUAL(this->handle->deleteData((*it)->getFullName()), 1);
+  BOOST_CHECK_EQUAL(names.size(), 6);
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(BatchInsertion, T, StorageBackends, SamePrefixFixture<T>)
+{
+  BOOST_CHECK_EQUAL(this->handle->insertData(*this->data.front()), true);
+
+  size_t nSignals = 0;
+  std::vector<Name> names;
+  this->handle->afterDataBatchInsertion.connect([&] (const std::vector<Name>& batchNames) {
+    ++nSignals;
+    names = batchNames;
+  });
+  this->handle->afterDataInsertion.connect([&] (const Name& name) {
+    BOOST_ERROR("afterDataInsertion signaled for " << name);
+  });
+
+  std::vector<Data> batch;
+  for (const auto& d : this->data) {
+    batch.push_back(*d);
+  }
+  BOOST_CHECK_EQUAL(this->handle->insertData(batch), true);
+
+  // signaled once, for the newly inserted data
+  BOOST_CHECK_EQUAL(nSignals, 1);
+  BOOST_CHECK_EQUAL(names.size(), this->data.size() - 1);
+  BOOST_CHECK(std::find(names.begin(), names.end(), this->data.front()->getName()) == names.end());
+  BOOST_CHECK_EQUAL(this->store->size(), this->data.size());
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(DeleteRange, T, StorageBackends, LargeSamePrefixFixture<T>)
+{
+  for (const auto& d : this->data) {
+    this->handle->insertData(*d);
+  }
+
+  std::set<Name> deleted;
+  this->handle->afterDataDeletion.connect([&] (const Name& name) {
+    deleted.insert(name);
+  });
+
+  // segments 250 to 260 span the change from one-byte to two-byte segment numbers
+  Name prefix("/x/y/z/test/1");
+  BOOST_CHECK_EQUAL(this->handle->deleteRange(Name(prefix).appendSegment(250),
+                                        Name(prefix).appendSegment(260).getSuccessor()), 11);
+  BOOST_CHECK_EQUAL(deleted.size(), 11);
+  BOOST_CHECK_EQUAL(this->store->size(), 289);
+  for (const auto& d : this->data) {
+    auto segment = d->getName().at(-1).toSegment();
+    BOOST_CHECK_EQUAL(deleted.count(d->getFullName()), segment >= 250 && segment <= 260 ? 1 : 0);
+  }
+
+  BOOST_CHECK_EQUAL(this->handle->deleteData(prefix), 289);
+  BOOST_CHECK_EQUAL(deleted.size(), 300);
+  BOOST_CHECK_EQUAL(this->store->size(), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(IncrementalNotify, T, SynchronousBackends, SamePrefixFixture<T>)
+{
+  std::vector<Data> data;
+  for (const auto& d : this->data) {
+    data.push_back(*d);
+  }
+  for (size_t i = 0; i < 8; ++i) {
+    this->handle->insertData(data[i]);
+  }
+
+  std::multiset<Name> inserted, deleted;
+  this->handle->afterDataInsertion.connect([&] (const Name& name) { inserted.insert(name); });
+  this->handle->afterDataDeletion.connect([&] (const Name& name) {
+    deleted.insert(name.getPrefix(-1));
+  });
+
+  boost::asio::io_context io;
+  Scheduler scheduler(io);
+  this->handle->notifyAboutExistingDataIncrementally(scheduler, 3);
+  BOOST_CHECK_EQUAL(this->handle->isEnumeratingExistingData(), true);
+  BOOST_CHECK_EQUAL(inserted.size(), 0);
+
+  // the first batch enumerates segments 0 to 2
+  io.run_one();
+  BOOST_CHECK_EQUAL(this->handle->getNEnumeratedExistingData(), 3);
+  BOOST_CHECK_EQUAL(inserted.size(), 3);
+
+  // changes behind the cursor are signaled, changes ahead of it are left to the enumeration
+  this->handle->insertData(data[8]);
+  this->handle->deleteData(data[1].getFullName());
+  this->handle->deleteData(data[5].getFullName());
+  BOOST_CHECK_EQUAL(inserted.size(), 3);
+  BOOST_CHECK(deleted == std::multiset<Name>{data[1].getName()});
+
+  io.run();
+  BOOST_CHECK_EQUAL(this->handle->isEnumeratingExistingData(), false);
+  std::multiset<Name> expected;
+  for (size_t i : {0, 1, 2, 3, 4, 6, 7, 8}) {
+    expected.insert(data[i].getName());
+  }
+  BOOST_CHECK(inserted == expected);
+
+  // once the enumeration is complete, every change is signaled
+  this->handle->insertData(data[9]);
+  BOOST_CHECK_EQUAL(inserted.count(data[9].getName()), 1);
+
+  // RepoStorage must not outlive the scheduler
+  this->handle.reset();
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(LookupFilter, T, SynchronousBackends, SamePrefixFixture<T>)
+{
+  std::vector<Data> data;
+  for (const auto& d : this->data) {
+    data.push_back(*d);
+  }
+  for (size_t i = 0; i < 6; ++i) {
+    this->handle->insertData(data[i]);
+  }
+
+  boost::asio::io_context io;
+  Scheduler scheduler(io);
+  // large enough for false positives to be negligible
+  this->handle->enableLookupFilter(scheduler, 100000, 1);
+  Interest absent("/x/y/z/test/2");
+
+  // not used until it is built
+  BOOST_CHECK_EQUAL(this->handle->isLookupFilterReady(), false);
+  BOOST_CHECK(this->handle->readData(absent) == nullptr);
+  BOOST_CHECK_EQUAL(this->handle->getLookupFilterCounters().nChecked, 0);
+
+  io.run();
+  BOOST_CHECK_EQUAL(this->handle->isLookupFilterReady(), true);
+  BOOST_CHECK(this->handle->readData(absent) == nullptr);
+  BOOST_CHECK(this->handle->readData(Interest(data[0].getName())) != nullptr);
+  BOOST_CHECK(this->handle->readData(Interest("/x/y/z/test").setCanBePrefix(true)) != nullptr);
+
+  // insertions and deletions are applied to the filter
+  this->handle->insertData(data[6]);
+  BOOST_CHECK(this->handle->readData(Interest(data[6].getName())) != nullptr);
+  BOOST_CHECK_EQUAL(this->handle->deleteData(data[0].getFullName()), 1);
+  BOOST_CHECK(this->handle->readData(Interest(data[0].getName())) == nullptr);
+
+  const auto& counters = this->handle->getLookupFilterCounters();
+  BOOST_CHECK_EQUAL(counters.nChecked, 5);
+  BOOST_CHECK_EQUAL(counters.nSkipped, 2);
+  BOOST_CHECK_EQUAL(counters.nHits, 3);
+  BOOST_CHECK_EQUAL(counters.nFalsePositives, 0);
+
+  // RepoStorage must not outlive the scheduler
+  this->handle.reset();
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(RightmostPrefixMatch, T, StorageBackends, SamePrefixFixture<T>)
+{
+  for (const auto& d : this->data) {
+    this->handle->insertData(*d);
+  }
+  Name lastName = Name(this->data.front()->getName().getPrefix(-1)).appendSegment(9);
+  Interest interest("/x/y/z/test");
+
+  this->handle->enableRightmostPrefixMatch(true);
+  interest.setCanBePrefix(true);
+  auto data = this->handle->readData(interest);
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(data->getName(), lastName);
+
+  std::shared_ptr<Data> result;
+  this->handle->readData(interest, [&] (auto d) { result = std::move(d); });
+  BOOST_REQUIRE(result != nullptr);
+  BOOST_CHECK_EQUAL(result->getName(), lastName);
+
+  this->handle->enableRightmostPrefixMatch(false);
+  data = this->handle->readData(interest);
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(data->getName(), Name(lastName.getPrefix(-1)).appendSegment(0));
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(InterestSelectors, T, StorageBackends, BasicFixture<T>)
+{
+  for (const auto& d : this->data) {
+    this->handle->insertData(*d);
+  }
+
+  // without CanBePrefix, only Data named as the Interest match
+  BOOST_CHECK(this->handle->readData(Interest("/a/b/c/d/e")) == nullptr);
+  BOOST_CHECK(this->handle->readData(Interest("/a/b").setCanBePrefix(true)) != nullptr);
+  auto data = this->handle->readData(Interest("/a/b"));
+  BOOST_REQUIRE(data != nullptr);
+  BOOST_CHECK_EQUAL(data->getName(), "/a/b");
+
+  // data of the dataset have no FreshnessPeriod
+  BOOST_CHECK(this->handle->readData(Interest("/a/b").setMustBeFresh(true)) == nullptr);
+  auto fresh = std::make_shared<Data>(*this->getData("/a/b/c/d"));
+  fresh->setName("/a/b/c/d/fresh");
+  fresh->setFreshnessPeriod(1_h);
+  this->handle->insertData(*fresh);
+
+  std::shared_ptr<Data> result;
+  this->handle->readData(Interest("/a/b").setCanBePrefix(true).setMustBeFresh(true),
+                         [&] (auto d) { result = std::move(d); });
+  BOOST_REQUIRE(result != nullptr);
+  BOOST_CHECK_EQUAL(result->getName(), fresh->getName());
+}
+
+template<class StorageT>
+class CapacityFixture : public Fixture<SamePrefixDataset<10>, StorageT>
+{
+public:
+  CapacityFixture()
+  {
+    this->handle->afterDataDeletion.connect([this] (const Name& name) {
+      evicted.push_back(name);
+    });
+  }
+
+  ~CapacityFixture()
+  {
+    // RepoStorage must not outlive the scheduler
+    this->handle.reset();
+  }
+
+  std::vector<Name>
+  getFullNames(std::initializer_list<size_t> indices) const
+  {
+    std::vector<Name> names;
+    for (auto i : indices) {
+      names.push_back((*std::next(this->data.begin(), i))->getFullName());
+    }
+    return names;
+  }
+
+public:
+  boost::asio::io_context io;
+  Scheduler scheduler{io};
+  std::vector<Name> evicted;
+};
+
+BOOST_AUTO_TEST_SUITE(Capacity)
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(Fifo, T, SynchronousBackends, CapacityFixture<T>)
+{
+  this->handle->enableCapacityLimits(this->scheduler, 6, 0, std::make_unique<FifoEvictionPolicy>());
+  for (const auto& d : this->data) {
+    BOOST_CHECK_EQUAL(this->handle->insertData(*d), true);
+  }
+  this->io.run();
+
+  BOOST_CHECK_EQUAL(this->store->size(), 6);
+  auto expected = this->getFullNames({0, 1, 2, 3});
+  BOOST_CHECK_EQUAL_COLLECTIONS(this->evicted.begin(), this->evicted.end(),
+                                expected.begin(), expected.end());
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(Lru, T, SynchronousBackends, CapacityFixture<T>)
+{
+  this->handle->enableCapacityLimits(this->scheduler, 8, 0, std::make_unique<LruEvictionPolicy>());
+  for (const auto& d : this->data) {
+    BOOST_CHECK_EQUAL(this->handle->insertData(*d), true);
+  }
+  // read the two oldest packets before eviction runs
+  for (auto it = this->data.begin(); it != std::next(this->data.begin(), 2); ++it) {
+    BOOST_CHECK(this->handle->readData(Interest((*it)->getName())) != nullptr);
+  }
+  this->io.run();
+
+  BOOST_CHECK_EQUAL(this->store->size(), 8);
+  auto expected = this->getFullNames({2, 3});
+  BOOST_CHECK_EQUAL_COLLECTIONS(this->evicted.begin(), this->evicted.end(),
+                                expected.begin(), expected.end());
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(Priority, T, SynchronousBackends, CapacityFixture<T>)
+{
+  auto low1 = this->createData("/low/1");
+  auto high1 = this->createData("/high/1");
+  auto low2 = this->createData("/low/2");
+  auto high2 = this->createData("/high/2");
+
+  this->handle->enableCapacityLimits(this->scheduler, 2, 0, std::make_unique<PriorityEvictionPolicy>(
+                                       std::vector<std::pair<Name, int>>{{"/high", 10}}));
+  for (const auto& d : {low1, high1, low2, high2}) {
+    BOOST_CHECK_EQUAL(this->handle->insertData(*d), true);
+  }
+  this->io.run();
+
+  std::vector<Name> expected{low1->getFullName(), low2->getFullName()};
+  BOOST_CHECK_EQUAL_COLLECTIONS(this->evicted.begin(), this->evicted.end(),
+                                expected.begin(), expected.end());
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(PriorityPasses, T, SynchronousBackends, CapacityFixture<T>)
+{
+  auto high1 = this->createData("/high/1");
+  auto mid1 = this->createData("/mid/1");
+  auto high2 = this->createData("/high/2");
+  auto mid2 = this->createData("/mid/2");
+  auto high3 = this->createData("/high/3");
+
+  // no data has the default priority, so the first pass over the data selects none
+  this->handle->enableCapacityLimits(this->scheduler, 2, 0, std::make_unique<PriorityEvictionPolicy>(
+                                       std::vector<std::pair<Name, int>>{{"/high", 10}, {"/mid", 5}}));
+  for (const auto& d : {high1, mid1, high2, mid2, high3}) {
+    BOOST_CHECK_EQUAL(this->handle->insertData(*d), true);
+  }
+  this->io.run();
+
+  std::vector<Name> expected{mid1->getFullName(), mid2->getFullName(), high1->getFullName()};
+  BOOST_CHECK_EQUAL_COLLECTIONS(this->evicted.begin(), this->evicted.end(),
+                                expected.begin(), expected.end());
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(Bytes, T, SynchronousBackends, CapacityFixture<T>)
+{
+  uint64_t packetSize = this->data.front()->wireEncode().size();
+  this->handle->enableCapacityLimits(this->scheduler, 0, packetSize * 5,
+                                     std::make_unique<FifoEvictionPolicy>());
+  for (const auto& d : this->data) {
+    BOOST_CHECK_EQUAL(this->handle->insertData(*d), true);
+  }
+  this->io.run();
+
+  BOOST_CHECK_LE(this->store->bytes(), packetSize * 5);
+  BOOST_CHECK_EQUAL(this->evicted.front(), this->data.front()->getFullName());
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Capacity
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace repo::tests
@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/sharded-storage.hpp"
+#include "storage/cursor.hpp"
+
+#include "../dataset-fixtures.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <filesystem>
+#include <set>
+#include <thread>
+
+namespace repo::tests {
+
+class ShardedStorageFixture : public DatasetBase
+{
+public:
+  ShardedStorageFixture()
+  {
+    // Data under 20 different two-component prefixes, spread over the shards
+    for (int i = 0; i < 20; ++i) {
+      this->data.push_back(createData(Name("/p").appendNumber(i).append("x")));
+    }
+  }
+
+  ~ShardedStorageFixture()
+  {
+    storage.reset();
+    std::error_code ec;
+    std::filesystem::remove_all("unittestdb", ec);
+  }
+
+public:
+  std::unique_ptr<repo::ShardedStorage> storage =
+    std::make_unique<repo::ShardedStorage>("unittestdb", 4, 2);
+};
+
+BOOST_FIXTURE_TEST_SUITE(ShardedStorage, ShardedStorageFixture)
+
+BOOST_AUTO_TEST_CASE(Aggregate)
+{
+  std::set<size_t> shards;
+  uint64_t nBytes = 0;
+  for (const auto& d : this->data) {
+    storage->insert(*d);
+    shards.insert(storage->getShardIndex(d->getName()));
+    nBytes += d->wireEncode().size();
+  }
+  BOOST_CHECK_GT(shards.size(), 1);
+  BOOST_CHECK_EQUAL(storage->size(), 20);
+  BOOST_CHECK_EQUAL(storage->bytes(), nBytes);
+
+  // enumeration in name order is merged across the shards
+  std::vector<Name> expected;
+  for (const auto& d : this->data) {
+    expected.push_back(d->getFullName());
+  }
+  std::sort(expected.begin(), expected.end(), [] (const Name& a, const Name& b) {
+    auto aValue = a.wireEncode().value_bytes();
+    auto bValue = b.wireEncode().value_bytes();
+    return std::lexicographical_compare(aValue.begin(), aValue.end(),
+                                        bValue.begin(), bValue.end());
+  });
+  std::vector<Name> names;
+  Cursor::Options options;
+  options.pageSize = 3;
+  Cursor cursor(*storage, options);
+  while (cursor.next()) {
+    names.push_back(cursor.getFullName());
+  }
+  BOOST_CHECK_EQUAL_COLLECTIONS(names.begin(), names.end(), expected.begin(), expected.end());
+
+  size_t nInInsertionOrder = 0;
+  storage->forEachInInsertionOrder([&] (const Name&) {
+    ++nInInsertionOrder;
+    return true;
+  });
+  BOOST_CHECK_EQUAL(nInInsertionOrder, 20);
+
+  BOOST_CHECK_EQUAL(storage->eraseRange("/p", Name("/p").getSuccessor(),
+                                        [] (const std::vector<Name>&) {}), 20);
+  BOOST_CHECK_EQUAL(storage->size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(InsertionOrderAcrossShards)
+{
+  // the insertions alternate between the shards; insertion times are recorded to the millisecond
+  std::vector<Name> inserted;
+  for (const auto& d : this->data) {
+    storage->insert(*d);
+    inserted.push_back(d->getFullName());
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  std::vector<Name> names;
+  storage->forEachInInsertionOrder([&] (const Name& name) {
+    names.push_back(name);
+    return true;
+  });
+  BOOST_CHECK_EQUAL_COLLECTIONS(names.begin(), names.end(), inserted.begin(), inserted.end());
+
+  // a listing in insertion order continues after the last Data listed from any shard
+  Storage::InsertionOrderPosition position;
+  names = storage->nextInInsertionOrder(position, 5);
+  BOOST_CHECK_EQUAL_COLLECTIONS(names.begin(), names.end(), inserted.begin(), inserted.begin() + 5);
+  for (const auto& name : names) {
+    storage->erase(name);
+  }
+  names = storage->nextInInsertionOrder(position, inserted.size());
+  BOOST_CHECK_EQUAL_COLLECTIONS(names.begin(), names.end(), inserted.begin() + 5, inserted.end());
+  BOOST_CHECK(storage->nextInInsertionOrder(position, 5).empty());
+}
+
+BOOST_AUTO_TEST_CASE(PrefixAcrossShards)
+{
+  for (const auto& d : this->data) {
+    storage->insert(*d);
+  }
+
+  // a name shorter than the shard prefix matches Data in all shards
+  BOOST_CHECK(!storage->routeLookup("/p"));
+  auto found = storage->find("/p");
+  BOOST_REQUIRE(found != nullptr);
+  BOOST_CHECK_EQUAL(found->getName(), Name("/p").appendNumber(0).append("x"));
+
+  for (const auto& d : this->data) {
+    BOOST_CHECK(storage->routeLookup(d->getFullName()));
+    BOOST_CHECK(storage->has(d->getFullName()));
+    BOOST_CHECK_EQUAL(*storage->find(d->getName()), *d);
+  }
+
+  BOOST_CHECK(storage->enablePrefixSummary(2));
+  std::map<Name, uint64_t> counts;
+  storage->forEachPrefixCount([&] (const Name& prefix, uint64_t count) {
+    counts[prefix] += count;
+  });
+  BOOST_REQUIRE_EQUAL(counts.size(), 1);
+  BOOST_CHECK_EQUAL(counts.begin()->first, Name("/p"));
+  BOOST_CHECK_EQUAL(counts.begin()->second, 20);
+}
+
+BOOST_AUTO_TEST_CASE(LazyTransaction)
+{
+  const auto& first = *this->data.front();
+  size_t touchedShard = storage->getShardIndex(first.getName());
+  auto untouched = std::find_if(this->data.begin(), this->data.end(), [&] (const auto& d) {
+    return storage->getShardIndex(d->getName()) != touchedShard;
+  });
+  BOOST_REQUIRE(untouched != this->data.end());
+  size_t untouchedShard = storage->getShardIndex((*untouched)->getName());
+
+  storage->beginTransaction();
+  storage->insert(first);
+
+  // only the modified shard holds a transaction, so the other shards are not locked
+  {
+    auto shardPath = std::filesystem::path("unittestdb") / ("shard-" + std::to_string(untouchedShard));
+    repo::SqliteStorage shard(shardPath.string());
+    BOOST_CHECK(shard.insertIfAbsent(**untouched));
+    BOOST_CHECK(shard.erase((*untouched)->getFullName()));
+  }
+
+  storage->insertBatch(std::vector<Data>{**untouched});
+  BOOST_CHECK_EQUAL(storage->size(), 2);
+  storage->rollbackTransaction();
+  BOOST_CHECK_EQUAL(storage->size(), 0);
+
+  storage->beginTransaction();
+  storage->insertBatch(std::vector<Data>{first, **untouched});
+  storage->commitTransaction();
+  BOOST_CHECK_EQUAL(storage->size(), 2);
+
+  // outside of a transaction, the modifications are committed right away
+  BOOST_CHECK(storage->erase(first.getFullName()));
+  storage->rollbackTransaction();
+  BOOST_CHECK_EQUAL(storage->size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(LayoutMismatch)
+{
+  storage->insert(*this->data.front());
+  storage.reset();
+
+  BOOST_CHECK_EQUAL(repo::ShardedStorage::readLayout("unittestdb")->nShards, 4);
+  BOOST_CHECK_THROW(repo::ShardedStorage("unittestdb", 8, 2), repo::ShardedStorage::Error);
+  BOOST_CHECK_THROW(repo::ShardedStorage("unittestdb", 4, 1), repo::ShardedStorage::Error);
+
+  storage = std::make_unique<repo::ShardedStorage>("unittestdb", 4, 2);
+  BOOST_CHECK_EQUAL(storage->size(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace repo::tests
@@ -17,26 +17,43 @@
  * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "storage/cursor.hpp"
 #include "storage/sqlite-storage.hpp"
 
 #include "../sqlite-fixture.hpp"
 #include "../dataset-fixtures.hpp"
 
+#include <ndn-cxx/util/sqlite3-statement.hpp>
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/mp11/algorithm.hpp>
 #include <boost/test/unit_test.hpp>
 #include <random>
+#include <thread>
 
 namespace repo::tests {
 
 BOOST_AUTO_TEST_SUITE(SqliteStorage)
 
-template<class Dataset>
-class Fixture : public SqliteFixture, public Dataset
+template<class Dataset, class StorageT = repo::SqliteStorage>
+class Fixture : public StorageFixture<StorageT>, public Dataset
 {
 public:
   std::map<Name, std::shared_ptr<Data>> nameToDataMap;
 };
 
-BOOST_FIXTURE_TEST_CASE_TEMPLATE(InsertReadDelete, T, CommonDatasets, Fixture<T>)
+/// every common dataset in every storage backend, as mp_list<Dataset, StorageT>
+using DatasetsAndBackends = boost::mp11::mp_product<boost::mp11::mp_list,
+                                                    CommonDatasets, StorageBackends>;
+
+template<class Params>
+using DatasetFixture = Fixture<boost::mp11::mp_first<Params>, boost::mp11::mp_second<Params>>;
+
+template<class StorageT>
+using BasicFixture = Fixture<BasicDataset, StorageT>;
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(InsertReadDelete, T, DatasetsAndBackends, DatasetFixture<T>)
 {
   std::vector<Name> names;
 
@@ -70,6 +87,468 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(InsertReadDelete, T, CommonDatasets, Fixture<T>
   BOOST_CHECK_EQUAL(this->handle->size(), 0);
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(InsertIfAbsent, T, StorageBackends, BasicFixture<T>)
+{
+  for (const auto& data : this->data) {
+    BOOST_CHECK_EQUAL(this->handle->insertIfAbsent(*data), true);
+  }
+  for (const auto& data : this->data) {
+    BOOST_CHECK_EQUAL(this->handle->insertIfAbsent(*data), false);
+  }
+  BOOST_CHECK_EQUAL(this->handle->size(), this->data.size());
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(InsertBatch, T, StorageBackends, BasicFixture<T>)
+{
+  BOOST_CHECK_EQUAL(this->handle->insertIfAbsent(*this->data.front()), true);
+
+  std::vector<Data> batch;
+  for (const auto& data : this->data) {
+    batch.push_back(*data);
+  }
+  batch.push_back(*this->data.back());
+
+  auto isInserted = this->handle->insertBatch(batch);
+  BOOST_REQUIRE_EQUAL(isInserted.size(), batch.size());
+  // already stored, and repeated in the batch
+  BOOST_CHECK_EQUAL(isInserted.front(), false);
+  BOOST_CHECK_EQUAL(isInserted.back(), false);
+  BOOST_CHECK_EQUAL(std::count(isInserted.begin(), isInserted.end(), true), this->data.size() - 1);
+  BOOST_CHECK_EQUAL(this->handle->size(), this->data.size());
+  for (const auto& data : this->data) {
+    BOOST_CHECK(this->handle->has(data->getFullName()));
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(FindLast, T, StorageBackends, BasicFixture<T>)
+{
+  for (const auto& data : this->data) {
+    this->handle->insert(*data);
+  }
+  // versions of an object, inserted out of order; a longer version number is greater
+  for (uint64_t version : {2, 256, 1}) {
+    this->handle->insert(*this->createData(Name("/v").appendVersion(version).appendSegment(0)));
+  }
+  Name lastName = Name("/v").appendVersion(256).appendSegment(1);
+  this->handle->insert(*this->createData(lastName));
+
+  auto found = this->handle->findLast("/v");
+  BOOST_REQUIRE(found != nullptr);
+  BOOST_CHECK_EQUAL(found->getName(), lastName);
+  found = this->handle->find("/v");
+  BOOST_REQUIRE(found != nullptr);
+  BOOST_CHECK_EQUAL(found->getName(), Name("/v").appendVersion(1).appendSegment(0));
+
+  // the rightmost descendant is the deepest name under the last child
+  found = this->handle->findLast("/a");
+  BOOST_REQUIRE(found != nullptr);
+  BOOST_CHECK_EQUAL(found->getName(), "/a/b/c/d");
+  found = this->handle->findLast(this->getData("/a/b")->getFullName());
+  BOOST_REQUIRE(found != nullptr);
+  BOOST_CHECK_EQUAL(found->getName(), "/a/b");
+
+  BOOST_CHECK(this->handle->findLast("/a/c") == nullptr);
+  BOOST_CHECK(this->handle->findLast("/w") == nullptr);
+}
+
+BOOST_FIXTURE_TEST_CASE(Freshness, Fixture<BasicDataset>)
+{
+  auto data = std::make_shared<Data>(*this->getData("/a"));
+  data->setFreshnessPeriod(100_ms);
+  this->handle->insert(*data);
+  this->handle->insert(*this->getData("/a/b"));
+
+  Interest interest("/a");
+  interest.setMustBeFresh(true);
+  BOOST_CHECK(this->handle->findMatch(interest) != nullptr);
+  // Data without FreshnessPeriod are never fresh
+  BOOST_CHECK(this->handle->findMatch(Interest("/a/b").setMustBeFresh(true)) == nullptr);
+
+  // the FreshnessPeriod counts from the insertion
+  std::this_thread::sleep_for(std::chrono::milliseconds(150));
+  BOOST_CHECK(this->handle->findMatch(interest) == nullptr);
+  BOOST_CHECK(this->handle->findMatch(interest.setCanBePrefix(true)) == nullptr);
+  interest.setMustBeFresh(false);
+  BOOST_CHECK(this->handle->findMatch(interest) != nullptr);
+}
+
+BOOST_FIXTURE_TEST_CASE(FreshnessManyStale, Fixture<SamePrefixDataset<200>>)
+{
+  // a fresh Data in the middle of many stale ones under the same prefix
+  size_t i = 0;
+  for (const auto& data : this->data) {
+    this->handle->insert(*data);
+    if (++i == this->data.size() / 2) {
+      Data fresh(*data);
+      fresh.setName(Name(fresh.getName()).append("fresh"));
+      fresh.setFreshnessPeriod(10_s);
+      this->handle->insert(fresh);
+    }
+  }
+
+  Interest interest("/x/y/z/test/1");
+  interest.setCanBePrefix(true);
+  interest.setMustBeFresh(true);
+  for (bool isRightmost : {false, true}) {
+    auto found = this->handle->findMatch(interest, isRightmost);
+    BOOST_REQUIRE(found != nullptr);
+    BOOST_CHECK_EQUAL(found->getName().at(-1), ndn::name::Component("fresh"));
+  }
+  BOOST_CHECK(this->handle->findMatch(Interest(this->data.front()->getName()).setMustBeFresh(true)) == nullptr);
+}
+
+BOOST_FIXTURE_TEST_CASE(Counters, Fixture<BasicDataset>)
+{
+  uint64_t nBytes = 0;
+  for (const auto& data : this->data) {
+    this->handle->insert(*data);
+    nBytes += data->wireEncode().size();
+  }
+  BOOST_CHECK_EQUAL(this->handle->size(), this->data.size());
+  BOOST_CHECK_EQUAL(this->handle->bytes(), nBytes);
+
+  BOOST_CHECK_EQUAL(this->handle->erase(this->data.front()->getFullName()), true);
+  nBytes -= this->data.front()->wireEncode().size();
+  BOOST_CHECK_EQUAL(this->handle->size(), this->data.size() - 1);
+  BOOST_CHECK_EQUAL(this->handle->bytes(), nBytes);
+
+  // a rolled back insertion does not change the counters
+  this->handle->beginTransaction();
+  this->handle->insert(*this->data.front());
+  this->handle->rollbackTransaction();
+  BOOST_CHECK_EQUAL(this->handle->size(), this->data.size() - 1);
+  BOOST_CHECK_EQUAL(this->handle->bytes(), nBytes);
+
+  // the counters persist across reopening
+  this->handle = std::make_unique<repo::SqliteStorage>("unittestdb");
+  BOOST_CHECK_EQUAL(this->handle->size(), this->data.size() - 1);
+  BOOST_CHECK_EQUAL(this->handle->bytes(), nBytes);
+
+  // and are recomputed when missing, e.g., in a database created by an older version
+  this->handle.reset();
+  sqlite3* db = nullptr;
+  BOOST_REQUIRE_EQUAL(sqlite3_open("unittestdb/ndn_repo.db", &db), SQLITE_OK);
+  BOOST_REQUIRE_EQUAL(sqlite3_exec(db, "DROP TABLE NDN_REPO_META;", nullptr, nullptr, nullptr),
+                      SQLITE_OK);
+  sqlite3_close(db);
+  this->handle = std::make_unique<repo::SqliteStorage>("unittestdb");
+  BOOST_CHECK_EQUAL(this->handle->size(), this->data.size() - 1);
+  BOOST_CHECK_EQUAL(this->handle->bytes(), nBytes);
+}
+
+BOOST_FIXTURE_TEST_CASE(PrefixSummary, Fixture<BasicDataset>)
+{
+  auto getCounts = [this] {
+    std::map<Name, uint64_t> counts;
+    this->handle->forEachPrefixCount([&] (const Name& prefix, uint64_t count) {
+      counts[prefix] = count;
+    });
+    return counts;
+  };
+  using Counts = std::map<Name, uint64_t>;
+
+  // data inserted before the summary is enabled are counted when it is built
+  this->handle->insert(*this->getData("/a"));
+  BOOST_CHECK_EQUAL(this->handle->enablePrefixSummary(1), true);
+  BOOST_CHECK(getCounts() == (Counts{{"/", 1}}));
+
+  this->handle->insertIfAbsent(*this->getData("/a/b"));
+  this->handle->insertIfAbsent(*this->getData("/a/b"));
+  this->handle->insert(*this->getData("/a/b/c"));
+  BOOST_CHECK(getCounts() == (Counts{{"/", 1}, {"/a", 1}, {"/a/b", 1}}));
+
+  this->handle->erase(this->getData("/a")->getFullName());
+  BOOST_CHECK(getCounts() == (Counts{{"/a", 1}, {"/a/b", 1}}));
+
+  // modifications without the summary invalidate it, and it is rebuilt when enabled again
+  this->handle = std::make_unique<repo::SqliteStorage>("unittestdb");
+  this->handle->insert(*this->getData("/a/b/c/d"));
+  this->handle = std::make_unique<repo::SqliteStorage>("unittestdb");
+  BOOST_CHECK_EQUAL(this->handle->enablePrefixSummary(1), true);
+  BOOST_CHECK(getCounts() == (Counts{{"/a", 1}, {"/a/b", 1}, {"/a/b/c", 1}}));
+
+  this->handle->eraseRange("/a/b/c", Name("/a/b/c").getSuccessor(), [] (const auto&) {});
+  BOOST_CHECK(getCounts() == (Counts{{"/a", 1}}));
+
+  // opening the database without the summary, or rolling back modifications, leaves it
+  // valid: a count damaged behind the storage's back is not rebuilt
+  this->handle = std::make_unique<repo::SqliteStorage>("unittestdb");
+  this->handle->beginTransaction();
+  this->handle->insert(*this->getData("/a/b/c/d"));
+  this->handle->rollbackTransaction();
+  sqlite3* db = nullptr;
+  BOOST_REQUIRE_EQUAL(sqlite3_open("unittestdb/ndn_repo.db", &db), SQLITE_OK);
+  BOOST_REQUIRE_EQUAL(sqlite3_exec(db, "UPDATE NDN_REPO_PREFIXES SET count = 5;",
+                                   nullptr, nullptr, nullptr), SQLITE_OK);
+  sqlite3_close(db);
+  this->handle = std::make_unique<repo::SqliteStorage>("unittestdb");
+  BOOST_CHECK_EQUAL(this->handle->enablePrefixSummary(1), true);
+  BOOST_CHECK(getCounts() == (Counts{{"/a", 5}}));
+}
+
+BOOST_FIXTURE_TEST_CASE(PrefixSummaryCheck, Fixture<SamePrefixDataset<10>>)
+{
+  BOOST_CHECK_EQUAL(this->handle->enablePrefixSummary(1), true);
+  for (const auto& data : this->data) {
+    this->handle->insert(*data);
+  }
+
+  // damage the summary behind the storage's back
+  sqlite3* db = nullptr;
+  BOOST_REQUIRE_EQUAL(sqlite3_open("unittestdb/ndn_repo.db", &db), SQLITE_OK);
+  BOOST_REQUIRE_EQUAL(sqlite3_exec(db, "UPDATE NDN_REPO_PREFIXES SET count = 3;",
+                                   nullptr, nullptr, nullptr), SQLITE_OK);
+  sqlite3_close(db);
+
+  std::vector<std::pair<Name, int64_t>> corrections;
+  auto onCorrection = [&] (const Name& prefix, int64_t delta) {
+    corrections.emplace_back(prefix, delta);
+  };
+  size_t nSteps = 1;
+  while (this->handle->checkPrefixSummary(4, onCorrection)) {
+    ++nSteps;
+    // modifications during the check are accounted for, unless they are rolled back
+    if (nSteps == 2) {
+      this->handle->beginTransaction();
+      for (const auto& data : this->data) {
+        this->handle->erase(data->getFullName());
+      }
+      this->handle->rollbackTransaction();
+      this->handle->erase(this->data.front()->getFullName());
+    }
+  }
+  BOOST_CHECK_EQUAL(nSteps, 3);
+  BOOST_REQUIRE_EQUAL(corrections.size(), 1);
+  BOOST_CHECK_EQUAL(corrections[0].first, "/x/y/z/test/1");
+  BOOST_CHECK_EQUAL(corrections[0].second, 7);
+
+  uint64_t count = 0;
+  this->handle->forEachPrefixCount([&] (const Name&, uint64_t c) { count = c; });
+  BOOST_CHECK_EQUAL(count, 9);
+
+  // the check does not count names within a transaction that could be rolled back
+  this->handle->beginTransaction();
+  BOOST_CHECK_THROW(this->handle->checkPrefixSummary(4, onCorrection), repo::SqliteStorage::Error);
+  this->handle->rollbackTransaction();
+}
+
+BOOST_FIXTURE_TEST_CASE(ScanUndecodable, Fixture<SamePrefixDataset<10>>)
+{
+  for (const auto& data : this->data) {
+    this->handle->insert(*data);
+  }
+
+  // make the first four names undecodable, keeping their place in name order
+  sqlite3* db = nullptr;
+  BOOST_REQUIRE_EQUAL(sqlite3_open("unittestdb/ndn_repo.db", &db), SQLITE_OK);
+  BOOST_REQUIRE_EQUAL(sqlite3_exec(db, "UPDATE NDN_REPO_V2 SET name = name || x'FF' WHERE name IN "
+                                       "(SELECT name FROM NDN_REPO_V2 ORDER BY name LIMIT 4);",
+                                   nullptr, nullptr, nullptr), SQLITE_OK);
+  sqlite3_close(db);
+
+  // the undecodable entries are skipped, and do not count toward the limit
+  std::vector<Name> names;
+  auto nEnumerated = this->handle->scan({}, 3, false, [&] (const Name& name, auto&&) {
+    names.push_back(name);
+  });
+  BOOST_CHECK_EQUAL(nEnumerated, 3);
+  BOOST_CHECK_EQUAL(names.size(), 3);
+  BOOST_CHECK_EQUAL(this->handle->scan({}, 10, true, [] (const Name&, auto&&) {}), 6);
+
+  // a page of undecodable entries does not end the enumeration
+  repo::Cursor::Options options;
+  options.pageSize = 2;
+  repo::Cursor cursor(*this->handle, options);
+  size_t nEntries = 0;
+  while (cursor.next()) {
+    ++nEntries;
+  }
+  BOOST_CHECK_EQUAL(nEntries, 6);
+}
+
+BOOST_FIXTURE_TEST_CASE(SchemaMigration, Fixture<SamePrefixDataset<10>>)
+{
+  // a database written before the schema was versioned
+  this->handle.reset();
+  std::filesystem::remove("unittestdb/ndn_repo.db");
+  sqlite3* db = nullptr;
+  BOOST_REQUIRE_EQUAL(sqlite3_open("unittestdb/ndn_repo.db", &db), SQLITE_OK);
+  BOOST_REQUIRE_EQUAL(sqlite3_exec(db, "CREATE TABLE NDN_REPO_V2 (name BLOB, data BLOB);",
+                                   nullptr, nullptr, nullptr), SQLITE_OK);
+  for (const auto& data : this->data) {
+    ndn::util::Sqlite3Statement stmt(db, "INSERT INTO NDN_REPO_V2 (name, data) VALUES (?, ?);");
+    const auto& name = data->getFullName().wireEncode();
+    stmt.bind(1, name.value(), name.value_size(), SQLITE_TRANSIENT);
+    stmt.bind(2, data->wireEncode(), SQLITE_TRANSIENT);
+    BOOST_REQUIRE_EQUAL(stmt.step(), SQLITE_DONE);
+  }
+  sqlite3_close(db);
+
+  auto queryInt = [] (const std::string& sql) {
+    sqlite3* db = nullptr;
+    BOOST_REQUIRE_EQUAL(sqlite3_open("unittestdb/ndn_repo.db", &db), SQLITE_OK);
+    int value = -1;
+    {
+      ndn::util::Sqlite3Statement stmt(db, sql);
+      BOOST_REQUIRE_EQUAL(stmt.step(), SQLITE_ROW);
+      value = stmt.getInt(0);
+    }
+    sqlite3_close(db);
+    return value;
+  };
+  auto countRows = [&] (const std::string& condition) {
+    return queryInt("SELECT count(*) FROM NDN_REPO_V2 WHERE " + condition);
+  };
+
+  // the schema is upgraded when the database is opened
+  this->handle = std::make_unique<repo::SqliteStorage>("unittestdb");
+  BOOST_CHECK_EQUAL(queryInt("PRAGMA user_version;"), 1);
+  BOOST_CHECK_EQUAL(queryInt("SELECT count(*) FROM sqlite_master WHERE type = 'index' AND "
+                             "name = 'index_insert_time';"), 1);
+  auto progress = this->handle->getMigrationProgress();
+  BOOST_CHECK_EQUAL(progress.version, 1);
+  BOOST_CHECK_EQUAL(progress.nMigrated, 0);
+  BOOST_CHECK_EQUAL(progress.nEntries, 10);
+
+  // data inserted after the upgrade are stored in the new schema right away
+  Data data(*this->data.front());
+  data.setName("/x/y/z/test/2");
+  data.setFreshnessPeriod(10_s);
+  data.setContentType(ndn::tlv::ContentType_Key);
+  this->handle->insert(data);
+  BOOST_CHECK_EQUAL(countRows("size = length(data) AND content_type = 2 AND "
+                              "freshness_period = 10000 AND insert_time IS NOT NULL"), 1);
+  BOOST_CHECK_EQUAL(countRows("size IS NULL"), 10);
+
+  // the older rows are migrated in steps, which resume after reopening
+  BOOST_CHECK_EQUAL(this->handle->migrate(4), true);
+  BOOST_CHECK_EQUAL(this->handle->getMigrationProgress().nMigrated, 4);
+  this->handle = std::make_unique<repo::SqliteStorage>("unittestdb");
+  BOOST_CHECK_EQUAL(this->handle->getMigrationProgress().nMigrated, 4);
+  size_t nSteps = 1;
+  while (this->handle->migrate(4)) {
+    ++nSteps;
+  }
+  BOOST_CHECK_EQUAL(nSteps, 2);
+  BOOST_CHECK_EQUAL(this->handle->getMigrationProgress().version, 0);
+  BOOST_CHECK_EQUAL(countRows("size = length(data) AND content_type = 0 AND freshness_period = 0"), 10);
+  // the older rows are taken as inserted at the upgrade, before the rows inserted since
+  BOOST_CHECK_EQUAL(countRows("insert_time IS NULL OR fresh_until IS NULL"), 0);
+  BOOST_CHECK_EQUAL(countRows("fresh_until = insert_time + freshness_period"), 11);
+  BOOST_CHECK_EQUAL(countRows("insert_time <= (SELECT insert_time FROM NDN_REPO_V2 "
+                              "WHERE freshness_period = 10000)"), 11);
+
+  this->handle = std::make_unique<repo::SqliteStorage>("unittestdb");
+  BOOST_CHECK_EQUAL(this->handle->migrate(4), false);
+
+  // a database of a newer version is not opened
+  this->handle.reset();
+  BOOST_REQUIRE_EQUAL(sqlite3_open("unittestdb/ndn_repo.db", &db), SQLITE_OK);
+  BOOST_REQUIRE_EQUAL(sqlite3_exec(db, "PRAGMA user_version = 100;", nullptr, nullptr, nullptr),
+                      SQLITE_OK);
+  sqlite3_close(db);
+  BOOST_CHECK_THROW(repo::SqliteStorage("unittestdb"), repo::SqliteStorage::Error);
+
+  // and its connection is closed: leaving WAL mode requires that no other connection is open
+  BOOST_REQUIRE_EQUAL(sqlite3_open("unittestdb/ndn_repo.db", &db), SQLITE_OK);
+  {
+    ndn::util::Sqlite3Statement stmt(db, "PRAGMA journal_mode = DELETE;");
+    BOOST_REQUIRE_EQUAL(stmt.step(), SQLITE_ROW);
+    BOOST_CHECK_EQUAL(stmt.getString(0), "delete");
+  }
+  sqlite3_close(db);
+}
+
+BOOST_FIXTURE_TEST_CASE(NameIndex, Fixture<BasicDataset>)
+{
+  // data inserted before the index is enabled are indexed when it is built
+  this->handle->insert(*this->getData("/a/b"));
+  BOOST_CHECK_EQUAL(this->handle->enableNameIndex(1 << 20), true);
+  BOOST_REQUIRE(this->handle->m_nameIndex != nullptr);
+  BOOST_CHECK_EQUAL(this->handle->m_nameIndex->size(), 1);
+
+  this->handle->insertIfAbsent(*this->getData("/a"));
+  this->handle->insert(*this->getData("/a/b/c"));
+  BOOST_CHECK_EQUAL(this->handle->m_nameIndex->size(), 3);
+
+  // a prefix lookup returns the first Data under the prefix, as the query would
+  auto found = this->handle->find("/a");
+  BOOST_REQUIRE(found != nullptr);
+  BOOST_CHECK_EQUAL(found->getName(), "/a");
+  found = this->handle->find("/a/b/c");
+  BOOST_REQUIRE(found != nullptr);
+  BOOST_CHECK_EQUAL(found->getName(), "/a/b/c");
+  BOOST_CHECK(this->handle->find("/a/b", true) == nullptr);
+  found = this->handle->findLast("/a");
+  BOOST_REQUIRE(found != nullptr);
+  BOOST_CHECK_EQUAL(found->getName(), "/a/b/c");
+  BOOST_CHECK(this->handle->has(this->getData("/a/b")->getFullName()));
+
+  // modifications rolled back are reverted in the index
+  this->handle->beginTransaction();
+  this->handle->erase(this->getData("/a")->getFullName());
+  this->handle->insert(*this->getData("/a/b/c/d"));
+  this->handle->rollbackTransaction();
+  BOOST_CHECK(this->handle->has(this->getData("/a")->getFullName()));
+  BOOST_CHECK(!this->handle->has(this->getData("/a/b/c/d")->getFullName()));
+  BOOST_CHECK_EQUAL(this->handle->m_nameIndex->size(), 3);
+
+  this->handle->eraseRange("/a/b", Name("/a/b").getSuccessor(), [] (const auto&) {});
+  BOOST_CHECK_EQUAL(this->handle->m_nameIndex->size(), 1);
+  BOOST_CHECK(this->handle->find("/a/b") == nullptr);
+
+  // an index that does not fit is dropped, and lookups query the database
+  this->handle = std::make_unique<repo::SqliteStorage>("unittestdb");
+  BOOST_CHECK_EQUAL(this->handle->enableNameIndex(1), false);
+  BOOST_CHECK(this->handle->m_nameIndex == nullptr);
+  BOOST_CHECK(this->handle->find("/a") != nullptr);
+}
+
+BOOST_FIXTURE_TEST_CASE(ConcurrentReads, Fixture<SamePrefixDataset<10>>)
+{
+  for (const auto& data : this->data) {
+    this->handle->insert(*data);
+  }
+
+  boost::asio::io_context ioCtx;
+  auto workGuard = boost::asio::make_work_guard(ioCtx);
+  BOOST_CHECK_EQUAL(this->handle->enableConcurrentReads(ioCtx, 3), true);
+
+  std::map<Name, std::shared_ptr<Data>> results;
+  auto expectResult = [&] (const Name& name) {
+    return [&, name] (std::shared_ptr<Data> data) {
+      results[name] = std::move(data);
+      if (results.size() == this->data.size() + 1) {
+        workGuard.reset();
+      }
+    };
+  };
+  for (const auto& data : this->data) {
+    this->handle->asyncFind(data->getName(), false, expectResult(data->getName()));
+  }
+  this->handle->asyncFind("/not/stored", false, expectResult("/not/stored"));
+  // results are delivered only by the io_context
+  BOOST_CHECK(results.empty());
+
+  ioCtx.run();
+  BOOST_REQUIRE_EQUAL(results.size(), this->data.size() + 1);
+  for (const auto& data : this->data) {
+    BOOST_REQUIRE(results[data->getName()] != nullptr);
+    BOOST_CHECK_EQUAL(*results[data->getName()], *data);
+  }
+  BOOST_CHECK(results["/not/stored"] == nullptr);
+
+  // uncommitted modifications are seen by a synchronous lookup
+  this->handle->beginTransaction();
+  this->handle->erase(this->data.front()->getFullName());
+  bool isFound = true;
+  this->handle->asyncFind(this->data.front()->getName(), false, [&] (auto data) {
+    isFound = data != nullptr && *data == *this->data.front();
+  });
+  BOOST_CHECK_EQUAL(isFound, false);
+  this->handle->rollbackTransaction();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace repo::tests
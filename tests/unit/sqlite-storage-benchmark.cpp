@@ -0,0 +1,359 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/cursor.hpp"
+#include "storage/executor-storage.hpp"
+#include "storage/sqlite-storage.hpp"
+
+#include "../identity-management-fixture.hpp"
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+#include <ndn-cxx/util/sqlite3-statement.hpp>
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+
+namespace repo::tests {
+
+// The benchmarks are disabled by default, because they take minutes to populate the database.
+// Run them explicitly, e.g.:
+//     REPO_BENCHMARK_ROWS=1000000 ./build/unit-tests -t SqliteStorageBenchmark
+BOOST_AUTO_TEST_SUITE(SqliteStorageBenchmark)
+
+class BenchmarkFixture : public IdentityManagementFixture
+{
+public:
+  BenchmarkFixture()
+  {
+    if (const char* rows = std::getenv("REPO_BENCHMARK_ROWS"); rows != nullptr) {
+      nRows = std::strtoull(rows, nullptr, 10);
+    }
+  }
+
+  ~BenchmarkFixture()
+  {
+    storage.reset();
+    std::error_code ec;
+    std::filesystem::remove_all(std::filesystem::path(DB_DIR), ec);
+  }
+
+  /**
+   * @brief Populate the database with @c nRows Data packets of @p payloadSize bytes each
+   * @return names (without implicit digest) of the inserted packets
+   */
+  std::vector<Name>
+  populate(size_t payloadSize)
+  {
+    storage = std::make_unique<SqliteStorage>(DB_DIR);
+    const std::vector<uint8_t> content(payloadSize, 'x');
+
+    std::vector<Name> names;
+    names.reserve(nRows);
+    for (uint64_t i = 0; i < nRows; ++i) {
+      Data data(Name("/benchmark/object").appendNumber(i / 1000).appendSegment(i % 1000));
+      data.setContent(content);
+      m_keyChain.sign(data, ndn::signingWithSha256());
+      storage->insert(data);
+      names.push_back(data.getName());
+    }
+    return names;
+  }
+
+  template<typename Function>
+  static double
+  measureRate(size_t nOperations, Function&& f)
+  {
+    auto start = time::steady_clock::now();
+    for (size_t i = 0; i < nOperations; ++i) {
+      f(i);
+    }
+    auto elapsed = time::duration_cast<time::microseconds>(time::steady_clock::now() - start);
+    return nOperations * 1e6 / std::max<int64_t>(elapsed.count(), 1);
+  }
+
+public:
+  static constexpr const char* DB_DIR = "benchmarkdb";
+  uint64_t nRows = 1000000;
+  size_t nLookups = 100000;
+  std::unique_ptr<SqliteStorage> storage;
+};
+
+BOOST_FIXTURE_TEST_CASE(PrefixReadRate, BenchmarkFixture,
+                        * boost::unit_test::disabled())
+{
+  auto names = populate(100);
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<size_t> pick(0, names.size() - 1);
+  std::vector<size_t> order(nLookups);
+  std::generate(order.begin(), order.end(), [&] { return pick(rng); });
+
+  // Baseline: compile the statement for every lookup, as SqliteStorage did before caching
+  sqlite3* db = nullptr;
+  BOOST_REQUIRE_EQUAL(sqlite3_open_v2((std::string(DB_DIR) + "/ndn_repo.db").data(), &db,
+                                      SQLITE_OPEN_READONLY, nullptr), SQLITE_OK);
+  size_t nFoundUncached = 0;
+  double uncached = measureRate(nLookups, [&] (size_t i) {
+    const Name& name = names[order[i]];
+    Name successor = name.getSuccessor();
+    ndn::util::Sqlite3Statement stmt(db, "SELECT * FROM NDN_REPO_V2 WHERE name >= ? and name < ?;");
+    stmt.bind(1, name.wireEncode().value(), name.wireEncode().value_size(), SQLITE_STATIC);
+    stmt.bind(2, successor.wireEncode().value(), successor.wireEncode().value_size(), SQLITE_STATIC);
+    if (stmt.step() == SQLITE_ROW) {
+      Data data(stmt.getBlock(1));
+      nFoundUncached += name.isPrefixOf(data.getFullName());
+    }
+  });
+  sqlite3_close(db);
+
+  size_t nFoundCached = 0;
+  double cached = measureRate(nLookups, [&] (size_t i) {
+    nFoundCached += storage->read(names[order[i]]) != nullptr;
+  });
+
+  BOOST_CHECK_EQUAL(nFoundUncached, nLookups);
+  BOOST_CHECK_EQUAL(nFoundCached, nLookups);
+  BOOST_TEST_MESSAGE("rows=" << nRows << " lookups=" << nLookups);
+  BOOST_TEST_MESSAGE("per-call prepared statement: " << uncached << " reads/s");
+  BOOST_TEST_MESSAGE("cached prepared statement:   " << cached << " reads/s");
+}
+
+BOOST_FIXTURE_TEST_CASE(LookupLatency8K, BenchmarkFixture,
+                        * boost::unit_test::disabled())
+{
+  // 8 KB packets: cap the default row count to keep the database below 1 GB
+  nRows = std::min<uint64_t>(nRows, 100000);
+  auto names = populate(8192);
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<size_t> pick(0, names.size() - 1);
+  std::vector<size_t> order(nLookups);
+  std::generate(order.begin(), order.end(), [&] { return pick(rng); });
+
+  // warm up the page cache, so that both measurements see the same I/O conditions
+  measureRate(nLookups, [&] (size_t i) { storage->read(names[order[i]]); });
+
+  // Baseline: SqliteStorage::find used to confirm the match by computing the full name
+  // (a SHA-256 over the whole packet) of every returned Data
+  size_t nFoundHashed = 0;
+  double hashed = measureRate(nLookups, [&] (size_t i) {
+    const Name& name = names[order[i]];
+    auto data = storage->read(name);
+    nFoundHashed += data != nullptr && name.isPrefixOf(data->getFullName());
+  });
+
+  size_t nFound = 0;
+  double unhashed = measureRate(nLookups, [&] (size_t i) {
+    nFound += storage->read(names[order[i]]) != nullptr;
+  });
+
+  BOOST_CHECK_EQUAL(nFoundHashed, nLookups);
+  BOOST_CHECK_EQUAL(nFound, nLookups);
+  BOOST_TEST_MESSAGE("rows=" << nRows << " lookups=" << nLookups << " payload=8192");
+  BOOST_TEST_MESSAGE("match by implicit digest: " << 1e6 / hashed << " us/lookup");
+  BOOST_TEST_MESSAGE("match by name column:     " << 1e6 / unhashed << " us/lookup");
+}
+
+BOOST_FIXTURE_TEST_CASE(StartupEnumeration, BenchmarkFixture,
+                        * boost::unit_test::disabled())
+{
+  // 8 KB packets, so that the stored Data dominate the size of the database; unless set
+  // explicitly, the row count defaults to 100000 (about 1 GB)
+  if (std::getenv("REPO_BENCHMARK_ROWS") == nullptr) {
+    nRows = 100000;
+  }
+  auto names = populate(8192);
+  sqlite3* db = nullptr;
+  BOOST_REQUIRE_EQUAL(sqlite3_open_v2((std::string(DB_DIR) + "/ndn_repo.db").data(), &db,
+                                      SQLITE_OPEN_READONLY, nullptr), SQLITE_OK);
+
+  // The name column is enumerated first, so that it does not benefit from the page cache
+  // warmed up by reading all the Data
+  size_t nEnumerated = 0;
+  auto start = time::steady_clock::now();
+  Cursor cursor(*storage, {});
+  while (cursor.next()) {
+    ++nEnumerated;
+  }
+  auto nameOnlyTime = time::duration_cast<time::milliseconds>(time::steady_clock::now() - start);
+
+  // Baseline: enumerate by loading and decoding every stored Data, as the original forEach did
+  size_t nDecoded = 0;
+  start = time::steady_clock::now();
+  {
+    ndn::util::Sqlite3Statement stmt(db, "SELECT data FROM NDN_REPO_V2;");
+    while (stmt.step() == SQLITE_ROW) {
+      Data data(stmt.getBlock(0));
+      nDecoded += !data.getName().empty();
+    }
+  }
+  auto decodeTime = time::duration_cast<time::milliseconds>(time::steady_clock::now() - start);
+  sqlite3_close(db);
+
+  BOOST_CHECK_EQUAL(nDecoded, names.size());
+  BOOST_CHECK_EQUAL(nEnumerated, names.size());
+  BOOST_TEST_MESSAGE("rows=" << nRows << " payload=8192");
+  BOOST_TEST_MESSAGE("enumerate by decoding Data: " << decodeTime);
+  BOOST_TEST_MESSAGE("enumerate name column:      " << nameOnlyTime);
+}
+
+BOOST_FIXTURE_TEST_CASE(BatchInsertRate, BenchmarkFixture,
+                        * boost::unit_test::disabled())
+{
+  // small packets, whose insertion cost is dominated by per-call overhead
+  if (std::getenv("REPO_BENCHMARK_ROWS") == nullptr) {
+    nRows = 200000;
+  }
+  const size_t batchSize = 1000;
+  const std::vector<uint8_t> content(100, 'x');
+  std::vector<Data> packets;
+  packets.reserve(nRows);
+  for (uint64_t i = 0; i < nRows; ++i) {
+    Data data(Name("/benchmark/object").appendNumber(i / 1000).appendSegment(i % 1000));
+    data.setContent(content);
+    m_keyChain.sign(data, ndn::signingWithSha256());
+    data.getFullName();
+    packets.push_back(std::move(data));
+  }
+
+  // Baseline: one call per Data, batchSize Data per transaction
+  storage = std::make_unique<SqliteStorage>(DB_DIR);
+  double perCall = measureRate(nRows / batchSize, [&] (size_t i) {
+    storage->beginTransaction();
+    for (size_t j = i * batchSize; j < (i + 1) * batchSize; ++j) {
+      storage->insertIfAbsent(packets[j]);
+    }
+    storage->commitTransaction();
+  }) * batchSize;
+  BOOST_CHECK_EQUAL(storage->size(), nRows / batchSize * batchSize);
+  storage.reset();
+  std::filesystem::remove_all(std::filesystem::path(DB_DIR));
+
+  storage = std::make_unique<SqliteStorage>(DB_DIR);
+  double batched = measureRate(nRows / batchSize, [&] (size_t i) {
+    storage->insertBatch(ndn::span<const Data>(packets).subspan(i * batchSize, batchSize));
+  }) * batchSize;
+  BOOST_CHECK_EQUAL(storage->size(), nRows / batchSize * batchSize);
+
+  BOOST_TEST_MESSAGE("rows=" << nRows << " payload=100 batch=" << batchSize);
+  BOOST_TEST_MESSAGE("insertIfAbsent per Data: " << perCall << " inserts/s");
+  BOOST_TEST_MESSAGE("insertBatch:             " << batched << " inserts/s");
+}
+
+BOOST_FIXTURE_TEST_CASE(MixedLoadTailLatency, BenchmarkFixture,
+                        * boost::unit_test::disabled())
+{
+  // 1 KB packets; unless set explicitly, the row count defaults to 100000
+  if (std::getenv("REPO_BENCHMARK_ROWS") == nullptr) {
+    nRows = 100000;
+  }
+  auto names = populate(1024);
+  std::shared_ptr<SqliteStorage> sqlite = std::move(storage);
+
+  // one insertion in ten, each of a new Data
+  const size_t nOperations = nLookups;
+  const auto interval = std::chrono::microseconds(100);
+  const std::vector<uint8_t> content(1024, 'x');
+  std::vector<Data> packets;
+  for (size_t i = 0; i < nOperations / 5; ++i) {
+    Data data(Name("/benchmark/mixed").appendSegment(i));
+    data.setContent(content);
+    m_keyChain.sign(data, ndn::signingWithSha256());
+    data.getFullName();
+    packets.push_back(std::move(data));
+  }
+
+  // Operations arrive at a fixed rate on the event loop. The latency of a lookup is counted
+  // from the time it arrives, so that it includes the time the loop was blocked by the
+  // operations before it.
+  auto measureLatencies = [&] (Storage& s, boost::asio::io_context& ioCtx,
+                               ndn::span<const Data> writes) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> pick(0, names.size() - 1);
+    std::vector<double> latencies;
+    size_t nIssued = 0;
+    size_t nPending = 0;
+    boost::asio::steady_timer timer(ioCtx);
+    auto start = std::chrono::steady_clock::now();
+
+    std::function<void()> issueNext = [&] {
+      auto arrival = start + nIssued * interval;
+      ++nPending;
+      if (nIssued % 10 == 0) {
+        s.asyncInsert(writes[nIssued / 10],
+                      [&] (bool) { --nPending; },
+                      [&] (const std::string&) { --nPending; });
+      }
+      else {
+        s.asyncFind(names[pick(rng)], false, [&, arrival] (auto&&) {
+          auto latency = std::chrono::steady_clock::now() - arrival;
+          latencies.push_back(std::chrono::duration<double, std::micro>(latency).count());
+          --nPending;
+        });
+      }
+      if (++nIssued < nOperations) {
+        timer.expires_at(start + nIssued * interval);
+        timer.async_wait([&] (const auto&) { issueNext(); });
+      }
+    };
+    timer.expires_at(start);
+    timer.async_wait([&] (const auto&) { issueNext(); });
+
+    auto workGuard = boost::asio::make_work_guard(ioCtx);
+    while (nIssued < nOperations || nPending > 0) {
+      ioCtx.run_one();
+    }
+    std::sort(latencies.begin(), latencies.end());
+    return latencies;
+  };
+  auto percentile = [] (const std::vector<double>& sorted, double p) {
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(sorted.size() * p))];
+  };
+
+  // Baseline: every operation runs on the event loop thread
+  boost::asio::io_context ioCtx;
+  auto direct = measureLatencies(*sqlite, ioCtx,
+                                 ndn::span<const Data>(packets).first(nOperations / 10));
+
+  // the storage thread runs the insertions, while lookups are served by readers
+  auto executor = std::make_shared<ExecutorStorage>(sqlite, ioCtx);
+  BOOST_REQUIRE(executor->enableConcurrentReads(ioCtx, 4));
+  auto offloaded = measureLatencies(*executor, ioCtx,
+                                    ndn::span<const Data>(packets).subspan(nOperations / 10));
+  executor.reset();
+
+  BOOST_CHECK_EQUAL(direct.size(), offloaded.size());
+  BOOST_CHECK_EQUAL(sqlite->size(), nRows + nOperations / 10 * 2);
+  BOOST_TEST_MESSAGE("rows=" << nRows << " operations=" << nOperations << " payload=1024"
+                     << " interval=" << interval.count() << "us writes=10%");
+  BOOST_TEST_MESSAGE("lookup latency on the event loop (us):      p50=" << percentile(direct, 0.5)
+                     << " p99=" << percentile(direct, 0.99) << " p99.9=" << percentile(direct, 0.999)
+                     << " max=" << direct.back());
+  BOOST_TEST_MESSAGE("lookup latency with storage thread (us):    p50=" << percentile(offloaded, 0.5)
+                     << " p99=" << percentile(offloaded, 0.99) << " p99.9=" << percentile(offloaded, 0.999)
+                     << " max=" << offloaded.back());
+}
+
+BOOST_AUTO_TEST_SUITE_END() // SqliteStorageBenchmark
+
+} // namespace repo::tests
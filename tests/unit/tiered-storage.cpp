@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/tiered-storage.hpp"
+#include "storage/memory-storage.hpp"
+
+#include "../dataset-fixtures.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo::tests {
+
+class TieredStorageFixture : public SamePrefixDataset<10>
+{
+public:
+  std::shared_ptr<Data>
+  at(size_t i) const
+  {
+    return *std::next(this->data.begin(), i);
+  }
+
+public:
+  uint64_t packetSize = this->data.front()->wireEncode().size();
+  std::shared_ptr<repo::MemoryStorage> cold = std::make_shared<repo::MemoryStorage>();
+  repo::TieredStorage storage{cold, packetSize * 3};
+};
+
+BOOST_FIXTURE_TEST_SUITE(TieredStorage, TieredStorageFixture)
+
+BOOST_AUTO_TEST_CASE(ByteBudget)
+{
+  for (const auto& d : this->data) {
+    storage.insert(*d);
+  }
+  BOOST_CHECK_EQUAL(storage.size(), 10);
+  BOOST_CHECK_EQUAL(storage.getNHotEntries(), 3);
+  BOOST_CHECK_LE(storage.getHotBytes(), packetSize * 3);
+
+  for (const auto& d : this->data) {
+    auto found = storage.read(d->getName());
+    BOOST_REQUIRE(found != nullptr);
+    BOOST_CHECK_EQUAL(*found, *d);
+  }
+  BOOST_CHECK_EQUAL(storage.getNHotEntries(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(FrequentlyReadStayHot)
+{
+  storage.insert(*at(0));
+  for (int i = 0; i < 5; ++i) {
+    BOOST_CHECK(storage.read(at(0)->getName()) != nullptr);
+  }
+  for (size_t i = 1; i < 10; ++i) {
+    storage.insert(*at(i));
+    BOOST_CHECK(storage.read(at(i)->getName()) != nullptr);
+  }
+
+  // removed from the cold tier behind the back of the hot tier: only a cached copy can be found
+  cold->erase(at(0)->getFullName());
+  cold->erase(at(1)->getFullName());
+  BOOST_CHECK(storage.read(at(0)->getName()) != nullptr);
+  BOOST_CHECK(storage.read(at(1)->getName()) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(WriteThrough)
+{
+  // inserted Data are admitted under their full name, without a lookup in the cold tier
+  storage.insert(*at(0));
+  BOOST_CHECK_EQUAL(storage.getNHotEntries(), 1);
+  cold->erase(at(0)->getFullName());
+  BOOST_CHECK(storage.has(at(0)->getFullName()));
+  BOOST_CHECK(storage.read(at(0)->getFullName()) != nullptr);
+
+  // lookups by name are admitted when they read from the cold tier
+  BOOST_CHECK(storage.read(at(0)->getName()) == nullptr);
+  storage.insert(*at(1));
+  BOOST_CHECK(storage.read(at(1)->getName()) != nullptr);
+  cold->erase(at(1)->getFullName());
+  BOOST_CHECK(storage.read(at(1)->getName()) != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Invalidation)
+{
+  for (size_t i = 1; i < 3; ++i) {
+    storage.insert(*at(i));
+  }
+  Name prefix("/x/y/z/test/1");
+  BOOST_CHECK_EQUAL(storage.read(prefix)->getName(), at(1)->getName());
+
+  // the cached lookup of the prefix no longer has the first match
+  storage.insert(*at(0));
+  BOOST_CHECK_EQUAL(storage.read(prefix)->getName(), at(0)->getName());
+  storage.erase(at(0)->getFullName());
+  BOOST_CHECK_EQUAL(storage.read(prefix)->getName(), at(1)->getName());
+
+  storage.eraseRange(prefix, prefix.getSuccessor(), [] (const auto&) {});
+  BOOST_CHECK(storage.read(prefix) == nullptr);
+  BOOST_CHECK(storage.read(at(2)->getName()) == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace repo::tests
@@ -36,7 +36,7 @@ static void
 usage(const char* programName)
 {
   std::cerr << "Usage: "
-            << programName << " [-c <path/to/repo-ng.conf>] [-n] [-h]\n"
+            << programName << " [-c <path/to/repo-ng.conf>] [-n] [-l] [-h]\n"
             << "\n"
             << "List names of Data packets in NDN repository.\n"
             << "By default, all names will include the implicit digest of Data packets.\n"
@@ -45,6 +45,7 @@ usage(const char* programName)
             << "  -h: show help message\n"
             << "  -c: set config file path\n"
             << "  -n: do not show implicit digest\n"
+            << "  -l: also show size, content type, freshness period, insertion time, and signer\n"
             << std::endl;
 }
 
@@ -61,7 +62,7 @@ public:
   RepoEnumerator(const std::string& configFile);
 
   uint64_t
-  enumerate(bool showImplicitDigest);
+  enumerate(bool showImplicitDigest, bool isLongListing);
 
 private:
   void
@@ -114,21 +115,57 @@ RepoEnumerator::readConfig(const std::string& configFile)
   m_dbPath += "/ndn_repo.db";
 }
 
+/**
+ * @brief Decode the name whose TLV-VALUE is in @p column
+ */
+static Name
+readName(ndn::util::Sqlite3Statement& stmt, int column)
+{
+  return Name(ndn::encoding::makeBinaryBlock(ndn::tlv::Name,
+                                             {stmt.getBlob(column), static_cast<size_t>(stmt.getSize(column))}));
+}
+
+/**
+ * @brief Print the value of a metadata column, or "-" if it was not recorded
+ */
+static void
+printMetadata(ndn::util::Sqlite3Statement& stmt, int column)
+{
+  if (sqlite3_column_type(stmt, column) == SQLITE_NULL) {
+    std::cout << "-";
+  }
+  else if (column == 4) {
+    std::cout << time::toIsoString(time::fromUnixTimestamp(time::milliseconds(sqlite3_column_int64(stmt, column))));
+  }
+  else if (column == 5) {
+    std::cout << readName(stmt, column);
+  }
+  else {
+    std::cout << sqlite3_column_int64(stmt, column);
+  }
+}
+
 uint64_t
-RepoEnumerator::enumerate(bool showImplicitDigest)
+RepoEnumerator::enumerate(bool showImplicitDigest, bool isLongListing)
 {
-  ndn::util::Sqlite3Statement stmt(m_db, "SELECT data FROM NDN_REPO_V2;");
+  // names and metadata are read from their own columns, without decoding the Data
+  ndn::util::Sqlite3Statement stmt(m_db, isLongListing ?
+    "SELECT name, size, content_type, freshness_period, insert_time, signer FROM NDN_REPO_V2;" :
+    "SELECT name FROM NDN_REPO_V2;");
   uint64_t nEntries = 0;
   while (true) {
     int rc = stmt.step();
     if (rc == SQLITE_ROW) {
-      Data data(stmt.getBlock(0));
-      if (showImplicitDigest) {
-        std::cout << data.getFullName() << std::endl;
+      Name name = readName(stmt, 0);
+      if (!showImplicitDigest) {
+        name = name.getPrefix(-1);
       }
-      else {
-        std::cout << data.getName() << std::endl;
+      // size, content type, freshness period, insertion time, and signer
+      for (int column = 1; isLongListing && column <= 5; ++column) {
+        printMetadata(stmt, column);
+        std::cout << " ";
       }
+      std::cout << name << std::endl;
       nEntries++;
     }
     else if (rc == SQLITE_DONE) {
@@ -146,9 +183,10 @@ main(int argc, char** argv)
 {
   std::string configPath = DEFAULT_CONFIG_FILE;
   bool showImplicitDigest = true;
+  bool isLongListing = false;
 
   int opt;
-  while ((opt = getopt(argc, argv, "hc:n")) != -1) {
+  while ((opt = getopt(argc, argv, "hc:nl")) != -1) {
     switch (opt) {
     case 'h':
       usage(argv[0]);
@@ -159,6 +197,9 @@ main(int argc, char** argv)
     case 'n':
       showImplicitDigest = false;
       break;
+    case 'l':
+      isLongListing = true;
+      break;
     default:
       usage(argv[0]);
       return 2;
@@ -166,7 +207,7 @@ main(int argc, char** argv)
   }
 
   RepoEnumerator instance(configPath);
-  uint64_t count = instance.enumerate(showImplicitDigest);
+  uint64_t count = instance.enumerate(showImplicitDigest, isLongListing);
   std::cerr << "Total number of data = " << count << std::endl;
   return 0;
 }
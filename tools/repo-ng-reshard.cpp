@@ -0,0 +1,316 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2026, Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.hpp"
+#include "storage/sharded-storage.hpp"
+#include "storage/sqlite-storage.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <unistd.h>
+
+#include <ndn-cxx/util/sqlite3-statement.hpp>
+
+#include <sqlite3.h>
+
+namespace repo {
+
+/// number of Data copied in each batch
+const size_t COPY_BATCH_SIZE = 1000;
+
+static void
+usage(const char* programName)
+{
+  std::cerr << "Usage: "
+            << programName << " -i <source path> -o <destination path> "
+            << "[-n <shards>] [-p <prefix length>] [-h]\n"
+            << "\n"
+            << "Copy the Data of a stopped NDN repository into a storage with a different number\n"
+            << "of SQLite shards, in insertion order. The source is opened read-only and left\n"
+            << "unchanged; after the copy, point the 'path' of the repo configuration to the\n"
+            << "destination, and set 'shards' and 'shard-prefix-length' to the new values.\n"
+            << "\n"
+            << "Options:\n"
+            << "  -h: show help message\n"
+            << "  -i: source storage folder, with a single database or with shards\n"
+            << "  -o: destination storage folder, which must not exist or be empty\n"
+            << "  -n: number of shards of the destination (default: 1)\n"
+            << "  -p: number of name components that select the shard (default: 1)\n"
+            << std::endl;
+}
+
+class Resharder
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    using std::runtime_error::runtime_error;
+  };
+
+  Resharder(const std::string& sourcePath, const std::string& destinationPath,
+            size_t nShards, size_t prefixLength);
+
+  uint64_t
+  copy();
+
+private:
+  /**
+   * @brief Reads the rows of one source database in insertion order, through a read-only
+   *        connection, so that the database is not modified
+   */
+  class SourceReader : noncopyable
+  {
+  public:
+    explicit
+    SourceReader(const std::string& dbPath);
+
+    ~SourceReader();
+
+    /**
+     * @brief Move to the next row
+     * @return false after the last row
+     */
+    bool
+    next();
+
+    /**
+     * @brief Insertion time of the current row, unknown for rows stored before it was recorded
+     */
+    std::optional<int64_t>
+    getInsertTime() const
+    {
+      return m_insertTime;
+    }
+
+    Data
+    getData() const;
+
+  private:
+    std::string m_dbPath;
+    sqlite3* m_db = nullptr;
+    std::unique_ptr<ndn::util::Sqlite3Statement> m_stmt;
+    std::optional<int64_t> m_insertTime;
+  };
+
+  static std::unique_ptr<Storage>
+  openStorage(const std::string& path, size_t nShards, size_t prefixLength);
+
+private:
+  std::vector<std::unique_ptr<SourceReader>> m_sources;
+  std::unique_ptr<Storage> m_destination;
+};
+
+Resharder::SourceReader::SourceReader(const std::string& dbPath)
+  : m_dbPath(dbPath)
+{
+  if (!std::filesystem::exists(dbPath)) {
+    BOOST_THROW_EXCEPTION(Error("Source database '" + dbPath + "' does not exist"));
+  }
+  int rc = sqlite3_open_v2(dbPath.c_str(), &m_db, SQLITE_OPEN_READONLY,
+   #ifdef DISABLE_SQLITE3_FS_LOCKING
+                           "unix-dotfile"
+   #else
+                           nullptr
+   #endif
+                          );
+  if (rc != SQLITE_OK) {
+    sqlite3_close(m_db);
+    BOOST_THROW_EXCEPTION(Error("Cannot open source database '" + dbPath + "'"));
+  }
+
+  // a database not opened since the insertion time was added has no such column
+  bool hasInsertTime = false;
+  {
+    ndn::util::Sqlite3Statement stmt(m_db, "PRAGMA table_info(NDN_REPO_V2);");
+    while (stmt.step() == SQLITE_ROW) {
+      hasInsertTime = hasInsertTime || stmt.getString(1) == "insert_time";
+    }
+  }
+  // rowid increases with every insertion, so it reflects the insertion order
+  m_stmt = std::make_unique<ndn::util::Sqlite3Statement>(m_db,
+    hasInsertTime ? "SELECT insert_time, data FROM NDN_REPO_V2 ORDER BY rowid;" :
+                    "SELECT NULL, data FROM NDN_REPO_V2 ORDER BY rowid;");
+}
+
+Resharder::SourceReader::~SourceReader()
+{
+  m_stmt.reset();
+  sqlite3_close(m_db);
+}
+
+bool
+Resharder::SourceReader::next()
+{
+  int rc = m_stmt->step();
+  if (rc == SQLITE_DONE) {
+    return false;
+  }
+  if (rc != SQLITE_ROW) {
+    BOOST_THROW_EXCEPTION(Error("Cannot read source database '" + m_dbPath + "' (code: " +
+                                std::to_string(rc) + ")"));
+  }
+  m_insertTime.reset();
+  if (sqlite3_column_type(*m_stmt, 0) != SQLITE_NULL) {
+    m_insertTime = sqlite3_column_int64(*m_stmt, 0);
+  }
+  return true;
+}
+
+Data
+Resharder::SourceReader::getData() const
+{
+  try {
+    return Data(m_stmt->getBlock(1));
+  }
+  catch (const ndn::tlv::Error& e) {
+    BOOST_THROW_EXCEPTION(Error("Cannot decode Data from source database '" + m_dbPath +
+                                "': " + e.what()));
+  }
+}
+
+Resharder::Resharder(const std::string& sourcePath, const std::string& destinationPath,
+                     size_t nShards, size_t prefixLength)
+{
+  if (!std::filesystem::is_directory(sourcePath)) {
+    BOOST_THROW_EXCEPTION(Error("Source folder '" + sourcePath + "' does not exist"));
+  }
+  std::error_code ec;
+  if (std::filesystem::exists(destinationPath) && !std::filesystem::is_empty(destinationPath, ec)) {
+    BOOST_THROW_EXCEPTION(Error("Destination folder '" + destinationPath + "' is not empty"));
+  }
+
+  auto layout = ShardedStorage::readLayout(sourcePath);
+  std::cerr << "Source has " << (layout ? layout->nShards : 1) << " shard(s) with prefix length "
+            << (layout ? layout->prefixLength : 1) << std::endl;
+  // the databases are laid out as by openStorage()
+  if (!layout || layout->nShards == 1) {
+    m_sources.push_back(std::make_unique<SourceReader>(sourcePath + "/ndn_repo.db"));
+  }
+  else {
+    for (size_t i = 0; i < layout->nShards; ++i) {
+      m_sources.push_back(std::make_unique<SourceReader>(sourcePath + "/shard-" +
+                                                         std::to_string(i) + "/ndn_repo.db"));
+    }
+  }
+  m_destination = openStorage(destinationPath, nShards, prefixLength);
+}
+
+std::unique_ptr<Storage>
+Resharder::openStorage(const std::string& path, size_t nShards, size_t prefixLength)
+{
+  // a single shard is a plain database, as with the default repo configuration
+  if (nShards == 1) {
+    return std::make_unique<SqliteStorage>(path);
+  }
+  return std::make_unique<ShardedStorage>(path, nShards, prefixLength);
+}
+
+uint64_t
+Resharder::copy()
+{
+  // The sources are merged by insertion time, as ShardedStorage enumerates them in insertion
+  // order, so that the destination keeps the insertion order of the source.
+  std::vector<SourceReader*> remaining;
+  for (auto& source : m_sources) {
+    if (source->next()) {
+      remaining.push_back(source.get());
+    }
+  }
+
+  uint64_t nCopied = 0;
+  std::vector<Data> batch;
+  while (!remaining.empty()) {
+    batch.clear();
+    while (batch.size() < COPY_BATCH_SIZE && !remaining.empty()) {
+      auto oldest = std::min_element(remaining.begin(), remaining.end(), [] (auto* a, auto* b) {
+        return a->getInsertTime() < b->getInsertTime();
+      });
+      batch.push_back((*oldest)->getData());
+      if (!(*oldest)->next()) {
+        remaining.erase(oldest);
+      }
+    }
+
+    auto isInserted = m_destination->insertBatch(batch);
+    nCopied += std::count(isInserted.begin(), isInserted.end(), true);
+    std::cerr << "Copied " << nCopied << " Data" << std::endl;
+  }
+  return nCopied;
+}
+
+static int
+main(int argc, char** argv)
+{
+  std::string sourcePath;
+  std::string destinationPath;
+  size_t nShards = 1;
+  size_t prefixLength = 1;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "hi:o:n:p:")) != -1) {
+    switch (opt) {
+    case 'h':
+      usage(argv[0]);
+      return 0;
+    case 'i':
+      sourcePath = std::string(optarg);
+      break;
+    case 'o':
+      destinationPath = std::string(optarg);
+      break;
+    case 'n':
+      nShards = std::stoul(optarg);
+      break;
+    case 'p':
+      prefixLength = std::stoul(optarg);
+      break;
+    default:
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  if (sourcePath.empty() || destinationPath.empty() || nShards == 0 || prefixLength == 0) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  Resharder instance(sourcePath, destinationPath, nShards, prefixLength);
+  uint64_t count = instance.copy();
+  std::cerr << "Total number of data = " << count << std::endl;
+  return 0;
+}
+
+} // namespace repo
+
+int
+main(int argc, char** argv)
+{
+  try {
+    return repo::main(argc, argv);
+  }
+  catch (const std::exception& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
+  }
+}